@@ -132,6 +132,7 @@ ArlyCompileEngine::table()
     expect(Token::NewLine);
     
     // Set the start address of the table. tableEntries() will fill them in
+    _globalIndex.emplace(id, _globals.size());
     _globals.emplace_back(id, _rom32.size(), t, Symbol::Storage::Const);
     
     ignoreNewLines();
@@ -167,6 +168,7 @@ ArlyCompileEngine::var()
     expect(integerValue(size), Compiler::Error::WrongType);
 
     // FIXME: deal with locals
+    _globalIndex.emplace(id, _globals.size());
     _globals.emplace_back(id, _nextMem, t, Symbol::Storage::Global);
     _nextMem += size;
     _globalSize = _nextMem;
@@ -202,6 +204,7 @@ ArlyCompileEngine::function()
     expect(identifier(id), Compiler::Error::ExpectedIdentifier);
     
     // Remember the function
+    _functionIndex.emplace(id, _functions.size());
     _functions.emplace_back(id, uint16_t(_rom8.size()));
     
     ignoreNewLines();
@@ -247,10 +250,9 @@ ArlyCompileEngine::handleConst()
     
     if (identifier(id)) {
         // See if this is a def
-        auto it = find_if(_defs.begin(), _defs.end(),
-                    [id](const Def& d) { return d._name == id; });
-        if (it != _defs.end()) {
-            return it->_value;
+        Def def;
+        if (findDef(id, def)) {
+            return def._value;
         }
         
         // See if it's a native function
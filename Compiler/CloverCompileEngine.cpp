@@ -18,29 +18,30 @@ bool
 CloverCompileEngine::opInfo(Token token, OpInfo& op) const
 {
     static std::vector<OpInfo> opInfo = {
-        { Token::Equal,     1, Op::Pop,     Op::Pop,      OpInfo::Assign::Only , Type::None },
-        { Token::AddSto,    1, Op::AddInt,  Op::AddFloat, OpInfo::Assign::Op   , Type::None },
-        { Token::SubSto,    1, Op::SubInt,  Op::SubFloat, OpInfo::Assign::Op   , Type::None },
-        { Token::MulSto,    1, Op::MulInt,  Op::MulFloat, OpInfo::Assign::Op   , Type::None },
-        { Token::DivSto,    1, Op::DivInt,  Op::DivFloat, OpInfo::Assign::Op   , Type::None },
-        { Token::AndSto,    1, Op::And,     Op::None,     OpInfo::Assign::Op   , Type::Int },
-        { Token::OrSto,     1, Op::Or,      Op::None,     OpInfo::Assign::Op   , Type::Int },
-        { Token::XorSto,    1, Op::Xor,     Op::None,     OpInfo::Assign::Op   , Type::Int },
-        { Token::LOr,       6, Op::LOr,     Op::None,     OpInfo::Assign::None , Type::Int },
-        { Token::LAnd,      7, Op::LAnd,    Op::None,     OpInfo::Assign::None , Type::Int },
-        { Token::Or,        8, Op::Or,      Op::None,     OpInfo::Assign::None , Type::Int },
-        { Token::Xor,       9, Op::Xor,     Op::None,     OpInfo::Assign::None , Type::Int },
-        { Token::And,      10, Op::And,     Op::None,     OpInfo::Assign::None , Type::Int },
-        { Token::EQ,       11, Op::EQInt,   Op::EQFloat,  OpInfo::Assign::None , Type::Int },
-        { Token::NE,       11, Op::NEInt,   Op::NEFloat,  OpInfo::Assign::None , Type::Int },
-        { Token::LT,       12, Op::LTInt,   Op::LTFloat,  OpInfo::Assign::None , Type::Int },
-        { Token::GT,       12, Op::GTInt,   Op::GTFloat,  OpInfo::Assign::None , Type::Int },
-        { Token::GE,       12, Op::GEInt,   Op::GEFloat,  OpInfo::Assign::None , Type::Int },
-        { Token::LE,       12, Op::LEInt,   Op::LEFloat,  OpInfo::Assign::None , Type::Int },
-        { Token::Plus,     14, Op::AddInt,  Op::AddFloat, OpInfo::Assign::None , Type::None },
-        { Token::Minus,    14, Op::SubInt,  Op::SubFloat, OpInfo::Assign::None , Type::None },
-        { Token::Mul,      15, Op::MulInt,  Op::MulFloat, OpInfo::Assign::None , Type::None },
-        { Token::Div,      15, Op::DivInt,  Op::DivFloat, OpInfo::Assign::None , Type::None },
+        // Fixed point add, subtract and compare are the same as Int
+        { Token::Equal,     1, Op::Pop,     Op::Pop,      Op::Pop,      OpInfo::Assign::Only , Type::None },
+        { Token::AddSto,    1, Op::AddInt,  Op::AddFloat, Op::AddInt,   OpInfo::Assign::Op   , Type::None },
+        { Token::SubSto,    1, Op::SubInt,  Op::SubFloat, Op::SubInt,   OpInfo::Assign::Op   , Type::None },
+        { Token::MulSto,    1, Op::MulInt,  Op::MulFloat, Op::MulFixed, OpInfo::Assign::Op   , Type::None },
+        { Token::DivSto,    1, Op::DivInt,  Op::DivFloat, Op::DivFixed, OpInfo::Assign::Op   , Type::None },
+        { Token::AndSto,    1, Op::And,     Op::None,     Op::None,     OpInfo::Assign::Op   , Type::Int },
+        { Token::OrSto,     1, Op::Or,      Op::None,     Op::None,     OpInfo::Assign::Op   , Type::Int },
+        { Token::XorSto,    1, Op::Xor,     Op::None,     Op::None,     OpInfo::Assign::Op   , Type::Int },
+        { Token::LOr,       6, Op::LOr,     Op::None,     Op::None,     OpInfo::Assign::None , Type::Int },
+        { Token::LAnd,      7, Op::LAnd,    Op::None,     Op::None,     OpInfo::Assign::None , Type::Int },
+        { Token::Or,        8, Op::Or,      Op::None,     Op::None,     OpInfo::Assign::None , Type::Int },
+        { Token::Xor,       9, Op::Xor,     Op::None,     Op::None,     OpInfo::Assign::None , Type::Int },
+        { Token::And,      10, Op::And,     Op::None,     Op::None,     OpInfo::Assign::None , Type::Int },
+        { Token::EQ,       11, Op::EQInt,   Op::EQFloat,  Op::EQInt,    OpInfo::Assign::None , Type::Int },
+        { Token::NE,       11, Op::NEInt,   Op::NEFloat,  Op::NEInt,    OpInfo::Assign::None , Type::Int },
+        { Token::LT,       12, Op::LTInt,   Op::LTFloat,  Op::LTInt,    OpInfo::Assign::None , Type::Int },
+        { Token::GT,       12, Op::GTInt,   Op::GTFloat,  Op::GTInt,    OpInfo::Assign::None , Type::Int },
+        { Token::GE,       12, Op::GEInt,   Op::GEFloat,  Op::GEInt,    OpInfo::Assign::None , Type::Int },
+        { Token::LE,       12, Op::LEInt,   Op::LEFloat,  Op::LEInt,    OpInfo::Assign::None , Type::Int },
+        { Token::Plus,     14, Op::AddInt,  Op::AddFloat, Op::AddInt,   OpInfo::Assign::None , Type::None },
+        { Token::Minus,    14, Op::SubInt,  Op::SubFloat, Op::SubInt,   OpInfo::Assign::None , Type::None },
+        { Token::Mul,      15, Op::MulInt,  Op::MulFloat, Op::MulFixed, OpInfo::Assign::None , Type::None },
+        { Token::Div,      15, Op::DivInt,  Op::DivFloat, Op::DivFixed, OpInfo::Assign::None , Type::None },
     };
 
     auto it = find_if(opInfo.begin(), opInfo.end(),
@@ -99,11 +100,29 @@ CloverCompileEngine::table()
     std::string id;
     expect(type(t), Compiler::Error::ExpectedType);
     expect(identifier(id), Compiler::Error::ExpectedIdentifier);
-    expect(Token::OpenBrace);
     
-    // Set the start address of the table. tableEntries() will fill them in
+    // Set the start address of the table. The values or the function
+    // will fill them in
     expect(addGlobal(id, _rom32.size(), t, Symbol::Storage::Const), Compiler::Error::DuplicateIdentifier);
     
+    // '[' <n> ']' '=' <function id> ';' makes the table from running the
+    // function at compile time
+    if (match(Token::OpenBracket)) {
+        int32_t count;
+        std::string name;
+        Function fun;
+        expect(integerValue(count), Compiler::Error::ExpectedValue);
+        expect(Token::CloseBracket);
+        expect(Token::Equal);
+        expect(identifier(name), Compiler::Error::ExpectedIdentifier);
+        expect(findFunction(name, fun), Compiler::Error::ExpectedFunction);
+        tableFromFunction(fun, t, count);
+        _functions[_functionIndex[name]].setUsedByTable();
+        expect(Token::Semicolon);
+        return true;
+    }
+    
+    expect(Token::OpenBrace);
     values(t);
     expect(Token::CloseBrace);
     return true;
@@ -120,6 +139,7 @@ CloverCompileEngine::strucT()
     expect(identifier(id), Compiler::Error::ExpectedIdentifier);
 
     // Add a struct entry
+    _structIndex.emplace(id, _structs.size());
     _structs.emplace_back(id);
     
     expect(Token::OpenBrace);
@@ -192,9 +212,9 @@ CloverCompileEngine::var(Type type, bool isPointer)
     
     _nextMem += size;
     
-    // Check for an initializer. We only allow initializers on Int and Float
+    // Check for an initializer. We only allow initializers on Int, Float and Fixed
     if (match(Token::Equal)) {
-        expect(type == Type::Int || type == Type::Float, Compiler::Error::InitializerNotAllowed);
+        expect(type == Type::Int || type == Type::Float || type == Type::Fixed, Compiler::Error::InitializerNotAllowed);
 
         // Generate an assignment expression
         _exprStack.emplace_back(id);
@@ -220,12 +240,11 @@ CloverCompileEngine::type(Type& t)
         return false;
     }
     
-    auto it = find_if(_structs.begin(), _structs.end(),
-                    [id](const Struct s) { return s.name() == id; });
-    if (it != _structs.end()) {
+    auto it = _structIndex.find(id);
+    if (it != _structIndex.end()) {
         // Types from 0x80 - 0xff are structs. Make the enum the struct
         // index + 0x80
-        t = Type(0x80 + (it - _structs.begin()));
+        t = Type(0x80 + it->second);
         _scanner.retireToken();
         return true;
     }
@@ -249,6 +268,7 @@ CloverCompileEngine::function()
     expect(identifier(id), Compiler::Error::ExpectedIdentifier);
 
     // Remember the function
+    _functionIndex.emplace(id, _functions.size());
     _functions.emplace_back(id, uint16_t(_rom8.size()), t);
     _inFunction = true;
     
@@ -266,10 +286,7 @@ CloverCompileEngine::function()
     auto localsIndex = _rom8.size();
     addInt(0);
 
-    // Remember the rom addr so we can check to see if we've emitted any code
-    uint16_t size = romSize();
-    
-    while(statement()) { }
+    statements();
     
     expect(Token::CloseBrace);
 
@@ -281,12 +298,14 @@ CloverCompileEngine::function()
         _localHighWaterMark = _nextMem;
     }
     
-    // Emit Return at the end if there's not already one
-    if (size == romSize() || lastOp() != Op::Return) {
+    // Emit Return at the end if the last statement can fall through
+    if (!_noFallThrough) {
         addOpSingleByteIndex(Op::PushIntConstS, 0);
         addOp(Op::Return);
     }
     
+    currentFunction().setInlineSize(inlineSize(currentFunction().addr()));
+    
     _inFunction = false;
     return true;
 }
@@ -312,6 +331,8 @@ CloverCompileEngine::structEntry()
 bool
 CloverCompileEngine::statement()
 {
+    _noFallThrough = false;
+    
     if (compoundStatement()) return true;
     if (ifStatement()) return true;
     if (forStatement()) return true;
@@ -339,7 +360,7 @@ CloverCompileEngine::compoundStatement()
         numLocals = currentFunction().numLocals();
     }
     
-    while(statement()) { }
+    statements();
 
     expect(Token::CloseBrace);
     
@@ -360,6 +381,35 @@ CloverCompileEngine::ifStatement()
     expect(Token::OpenParen);
     
     arithmeticExpression();
+    
+    // If the test is a constant, only the clause that will be executed
+    // is kept
+    if (!_exprStack.empty() && _exprStack.back().type() == ExprEntry::Type::Int) {
+        bool test = int32_t(_exprStack.back()) != 0;
+        _exprStack.pop_back();
+        expect(Token::CloseParen);
+        
+        CodeMark mark = codeMark();
+        statement();
+        bool noFallThrough = test && _noFallThrough;
+        if (!test) {
+            discardCode(mark);
+        }
+        
+        if (match(Reserved::Else)) {
+            mark = codeMark();
+            statement();
+            if (test) {
+                discardCode(mark);
+            } else {
+                noFallThrough = _noFallThrough;
+            }
+        }
+        
+        _noFallThrough = noFallThrough;
+        return true;
+    }
+    
     expect(bakeExpr(ExprAction::Right) == Type::Int, Compiler::Error::WrongType);
     expect(Token::CloseParen);
 
@@ -367,29 +417,36 @@ CloverCompileEngine::ifStatement()
     addOpTarg(Op::If, 0);
 
     statement();
+    bool noFallThrough = false;
     
     // This ifTargetAddr will be used if there is no else
     uint16_t ifTargetAddr = _rom8.size();
     
     if (match(Reserved::Else)) {
+        // No need to jump over the else clause if the if clause
+        // doesn't fall through
+        bool ifFallsThrough = !_noFallThrough;
         auto elseJumpAddr = _rom8.size();
-        addOpTarg(Op::Jump, 0);
+        if (ifFallsThrough) {
+            addOpTarg(Op::Jump, 0);
+        }
         
         // Set ifTargetAddr to jump to else clause
         ifTargetAddr = _rom8.size();
         statement();
+        noFallThrough = !ifFallsThrough && _noFallThrough;
 
         // Resolve the else address
-        uint16_t offset = _rom8.size() - elseJumpAddr - 2;
-        _rom8[elseJumpAddr] |= uint8_t((offset >> 8) & 0x0f);
-        _rom8[elseJumpAddr + 1] = uint8_t(offset);
+        if (ifFallsThrough) {
+            setJumpTarg(elseJumpAddr, _rom8.size());
+        }
     }
     
     // Resolve the if address
-    uint16_t offset = ifTargetAddr - ifJumpAddr - 2;
-    _rom8[ifJumpAddr] |= uint8_t((offset >> 8) & 0x0f);
-    _rom8[ifJumpAddr + 1] = uint8_t(offset);
+    setJumpTarg(ifJumpAddr, ifTargetAddr);
 
+    // Only if both clauses don't fall through is the next statement unreachable
+    _noFallThrough = noFallThrough;
     return true;
 }
 
@@ -410,7 +467,7 @@ CloverCompileEngine::forStatement()
         // If we have a type this is a var declaration and must be an assignment
         // expression. Otherwise it can be a general arithmeticExpression
         if (t != Type::None) {
-            expect(t == Type::Int || t == Type::Float, Compiler::Error::WrongType);
+            expect(t == Type::Int || t == Type::Float || t == Type::Fixed, Compiler::Error::WrongType);
 
             std::string id;
             expect(identifier(id), Compiler::Error::ExpectedIdentifier);
@@ -506,6 +563,7 @@ CloverCompileEngine::forStatement()
 
     // Now resolve all the jumps
     exitJumpContext(startAddr, contAddr, breakAddr);
+    _noFallThrough = false;
     return true;
 }
 
@@ -537,6 +595,7 @@ CloverCompileEngine::whileStatement()
         
     // Now resolve all the jumps (stmtAddr will never be used so just reuse loopAddr)
     exitJumpContext(loopAddr, loopAddr, _rom8.size());
+    _noFallThrough = false;
 
     return true;
 }
@@ -559,6 +618,7 @@ CloverCompileEngine::loopStatement()
     
     // Now resolve all the jumps (stmtAddr will never be used so just reuse loopAddr)
     exitJumpContext(loopAddr, loopAddr, _rom8.size());
+    _noFallThrough = false;
 
     return true;
 }
@@ -572,7 +632,7 @@ CloverCompileEngine::returnStatement()
     
     if (arithmeticExpression()) {
         // Push the return value
-        expect(bakeExpr(ExprAction::Right) == currentFunction().type(), Compiler::Error::MismatchedType);
+        expect(bakeExpr(ExprAction::Right, currentFunction().type()) == currentFunction().type(), Compiler::Error::MismatchedType);
     } else {
         // If the function return type not None, we need a return value
         expect(currentFunction().type() == Type::None, Compiler::Error::MismatchedType);
@@ -583,6 +643,7 @@ CloverCompileEngine::returnStatement()
     
     addOp(Op::Return);
     expect(Token::Semicolon);
+    _noFallThrough = true;
     return true;
 }
 
@@ -605,6 +666,7 @@ CloverCompileEngine::jumpStatement()
     addJumpEntry(Op::Jump, type);
 
     expect(Token::Semicolon);
+    _noFallThrough = true;
     return true;
 }
 
@@ -617,6 +679,14 @@ CloverCompileEngine::logStatement()
     
     expect(Token::OpenParen);
     
+    // An optional level comes first. A log above the level being kept
+    // is compiled, to check it, and then left out with its args
+    int32_t level = 0;
+    if (integerValue(level)) {
+        expect(Token::Comma);
+    }
+    CodeMark mark = codeMark();
+    
     std::string str;
     expect(stringValue(str), Compiler::Error::ExpectedString);
     expect(str.length() < 256, Compiler::Error::StringTooLong);
@@ -640,6 +710,10 @@ CloverCompileEngine::logStatement()
 
     expect(Token::CloseParen);
     expect(Token::Semicolon);
+    
+    if (level > _logLevel) {
+        discardCode(mark);
+    }
 
     return true;
 }
@@ -670,6 +744,11 @@ CloverCompileEngine::expressionStatement()
 bool
 CloverCompileEngine::arithmeticExpression(uint8_t minPrec, ArithType arithType)
 {
+    // Remember where the left side starts in case it can be folded away.
+    // Its code is emitted by unaryExpression, so this has to be before it
+    uint16_t leftAddr = romSize();
+    uint16_t leftConstSize = _rom32.size();
+    
     if (!unaryExpression()) {
         return false;
     }
@@ -689,10 +768,16 @@ CloverCompileEngine::arithmeticExpression(uint8_t minPrec, ArithType arithType)
         Type leftType = Type::None;
         Type rightType = Type::None;
         
+        bool leftIsConstant = false;
+        ExprEntry leftEntry;
+        
         if (info.assign() != OpInfo::Assign::None) {
             // Turn TOS into Ref
             leftType = bakeExpr(ExprAction::Ref);
         } else {
+            expect(!_exprStack.empty(), Compiler::Error::InternalError);
+            leftEntry = _exprStack.back();
+            leftIsConstant = isConstant(leftEntry);
             leftType = bakeExpr(ExprAction::Right);
         }
         
@@ -703,9 +788,28 @@ CloverCompileEngine::arithmeticExpression(uint8_t minPrec, ArithType arithType)
             addOp(Op::PushDeref);
         }
         
+        uint16_t rightAddr = romSize();
         expect(arithmeticExpression(nextMinPrec), Compiler::Error::ExpectedExpr);
 
+        if (info.assign() == OpInfo::Assign::None &&
+                foldExpr(info, leftIsConstant ? &leftEntry : nullptr, leftType, leftAddr, leftConstSize)) {
+            continue;
+        }
+        
         rightType = bakeExpr(ExprAction::Right, leftType);
+        
+        // There are no fixed literals, so a constant on the left was
+        // pushed as an int or float. Push it again as fixed after the
+        // right side
+        if (leftIsConstant && leftType != Type::Fixed && rightType == Type::Fixed) {
+            _rom8.erase(_rom8.begin() + leftAddr, _rom8.begin() + rightAddr);
+            _exprStack.push_back(leftEntry);
+            leftType = bakeExpr(ExprAction::Right, Type::Fixed);
+            if (info.fixedOp() != Op::AddInt && info.fixedOp() != Op::MulFixed &&
+                    info.fixedOp() != Op::EQInt && info.fixedOp() != Op::NEInt) {
+                addOp(Op::Swap);
+            }
+        }
 
         switch(info.assign()) {
             case OpInfo::Assign::Only: {
@@ -713,12 +817,12 @@ CloverCompileEngine::arithmeticExpression(uint8_t minPrec, ArithType arithType)
             }
             case OpInfo::Assign::Op:
                 expect(leftType == rightType, Compiler::Error::MismatchedType);
-                addOp((leftType == Type::Int) ? info.intOp() : info.floatOp());
+                addOp(info.op(leftType));
                 break;
             case OpInfo::Assign::None: {
                 expect(leftType == rightType, Compiler::Error::MismatchedType);
                 
-                Op op = (leftType == Type::Int) ? info.intOp() : info.floatOp();
+                Op op = info.op(leftType);
                 expect(op != Op::None, Compiler::Error::WrongType);
                 addOp(op);
 
@@ -787,6 +891,8 @@ CloverCompileEngine::unaryExpression()
 
             if (type == Type::Float) {
                 addOp((token == Token::Inc) ? Op::PreIncFloat : Op::PreDecFloat);
+            } else if (type == Type::Fixed) {
+                addOp((token == Token::Inc) ? Op::PreIncFixed : Op::PreDecFixed);
             } else {
                 expect(type == Type::Int, Compiler::Error::MismatchedType);
                 addOp((token == Token::Inc) ? Op::PreIncInt : Op::PreDecInt);
@@ -830,7 +936,7 @@ CloverCompileEngine::unaryExpression()
                 if (type == Type::Float) {
                     addOp(Op::NegFloat);
                 } else {
-                    expect(type == Type::Int, Compiler::Error::MismatchedType);
+                    expect(type == Type::Int || type == Type::Fixed, Compiler::Error::MismatchedType);
                     addOp(Op::NegInt);
                 }
             } else {
@@ -865,8 +971,8 @@ CloverCompileEngine::postfixExpression()
             
             if (fun.isNative()) {
                 addOpId(Op::CallNative, uint16_t(fun.nativeId()));
-            } else { 
-                addOpTarg(Op::Call, fun.addr());
+            } else if (!inlineCall(fun)) {
+                addCall(fun.addr());
             }
         } else if (match(Token::OpenBracket)) {
             bakeExpr(ExprAction::Ref);
@@ -894,6 +1000,8 @@ CloverCompileEngine::postfixExpression()
 
             if (type == Type::Float) {
                 addOp(Op::PostIncFloat);
+            } else if (type == Type::Fixed) {
+                addOp(Op::PostIncFixed);
             } else {
                 expect(type == Type::Int, Compiler::Error::MismatchedType);
                 addOp(Op::PostIncInt);
@@ -905,6 +1013,8 @@ CloverCompileEngine::postfixExpression()
 
             if (type == Type::Float) {
                 addOp(Op::PostDecFloat);
+            } else if (type == Type::Fixed) {
+                addOp(Op::PostDecFixed);
             } else {
                 expect(type == Type::Int, Compiler::Error::MismatchedType);
                 addOp(Op::PostDecInt);
@@ -929,7 +1039,15 @@ CloverCompileEngine::primaryExpression()
         // See if this is a def
         Def def;
         if (findDef(id, def)) {
-            _exprStack.emplace_back(int32_t(def._value));
+            if (def._type == Type::Float) {
+                _exprStack.emplace_back(intToFloat(def._value));
+            } else if (def._type == Type::Fixed) {
+                // There are no fixed constants on the ExprStack. It's
+                // converted back to fixed where it's used
+                _exprStack.emplace_back(fixedToFloat(def._value));
+            } else {
+                _exprStack.emplace_back(def._value);
+            }
         } else {
             _exprStack.emplace_back(id);
         }
@@ -1036,37 +1154,22 @@ CloverCompileEngine::isReserved(Token token, const std::string str, Reserved& r)
     return false;
 }
 
-uint8_t
+uint16_t
 CloverCompileEngine::findInt(int32_t i)
 {
     // Try to find an existing int const. If found, return
     // its address. If not found, create one and return 
     // that address.
-    auto it = find_if(_rom32.begin(), _rom32.end(),
-                    [i](uint32_t v) { return uint32_t(i) == v; });
-    if (it != _rom32.end()) {
-        return it - _rom32.begin();
-    }
-    
-    _rom32.push_back(uint32_t(i));
-    return _rom32.size() - 1;
+    return internConst(uint32_t(i));
 }
 
-uint8_t
+uint16_t
 CloverCompileEngine::findFloat(float f)
 {
     // Try to find an existing fp const. If found, return
     // its address. If not found, create one and return 
     // that address.
-    uint32_t i = floatToInt(f);
-    auto it = find_if(_rom32.begin(), _rom32.end(),
-                    [i](uint32_t v) { return i == v; });
-    if (it != _rom32.end()) {
-        return it - _rom32.begin();
-    }
-    
-    _rom32.push_back(i);
-    return _rom32.size() - 1;
+    return internConst(floatToInt(f));
 }
 
 CompileEngine::Type
@@ -1090,25 +1193,37 @@ CloverCompileEngine::bakeExpr(ExprAction action, Type matchingType)
                     if (matchingType == Type::Float) {
                         // Promote to float
                         float f = float(int32_t(i));
-                        addOpInt(Op::Push, findFloat(f));
+                        addOpId(Op::Push, findFloat(f));
                         type = Type::Float;
                         break;
                     }
                     
+                    type = Type::Int;
+                    if (matchingType == Type::Fixed) {
+                        // Promote to fixed
+                        i = intToFixed(i);
+                        type = Type::Fixed;
+                    }
+                    
                     if (i <= 15) {
                         addOpSingleByteIndex(Op::PushIntConstS, i);
                     } else if (i <= 255) {
                         addOpInt(Op::PushIntConst, i);
                     } else {
                         // Add an int const
-                        addOpInt(Op::Push, findInt(i));
+                        addOpId(Op::Push, findInt(i));
                     }
-                    type = Type::Int;
                     break;
                 }
                 case ExprEntry::Type::Float:
+                    if (matchingType == Type::Fixed) {
+                        addOpId(Op::Push, findInt(floatToFixed(entry)));
+                        type = Type::Fixed;
+                        break;
+                    }
+                    
                     // Use an fp constant
-                    addOpInt(Op::Push, findFloat(entry));
+                    addOpId(Op::Push, findFloat(entry));
                     type = Type::Float;
                     break;
                 case ExprEntry::Type::Id:
@@ -1257,18 +1372,13 @@ CloverCompileEngine::structFromType(Type type, Struct& s)
 void
 CloverCompileEngine::findStructElement(Type type, const std::string& id, uint8_t& index, Type& elementType)
 {
-    Struct s;
-    expect(structFromType(type, s), Compiler::Error::ExpectedStructType);
-    
-    const std::vector<ParamEntry>& entries = s.entries();
-
-    auto it = find_if(entries.begin(), entries.end(),
-                    [id](const ParamEntry& ent) { return ent._name == id; });
-    expect(it != entries.end(), Compiler::Error::InvalidStructId);
+    expect(uint8_t(type) >= 0x80, Compiler::Error::ExpectedStructType);
+    uint8_t structIndex = uint8_t(type) - 0x80;
+    expect(structIndex < _structs.size(), Compiler::Error::InternalError);
     
     // FIXME: For now assume structs can only have 1 word entries. If we ever support Structs with Structs this is not true
-    index = it - entries.begin();
-    elementType = it->_type;
+    expect(_structs[structIndex].findEntry(id, index), Compiler::Error::InvalidStructId);
+    elementType = _structs[structIndex].entries()[index]._type;
 }
 
 uint8_t
@@ -1301,12 +1411,8 @@ CloverCompileEngine::exitJumpContext(uint16_t startAddr, uint16_t contAddr, uint
             case JumpEntry::Type::Break: addr = breakAddr; break;
         }         
          
-        int16_t offset = int16_t(addr) - int16_t(it._addr) - 2;
-         
         expect(_rom8[it._addr + 1] == 0, Compiler::Error::InternalError);
-        
-        _rom8[it._addr] |= (offset >> 8) & 0x0f;
-        _rom8[it._addr + 1] = uint8_t(offset);
+        setJumpTarg(it._addr, addr);
     }
     
     _jumpList.pop_back();
@@ -1321,3 +1427,359 @@ CloverCompileEngine::addJumpEntry(Op op, JumpEntry::Type type)
     addOpTarg(op, 0);
     _jumpList.back().emplace_back(type, addr);
 }
+
+bool
+CloverCompileEngine::foldExpr(const OpInfo& info, const ExprEntry* left, Type leftType, uint16_t leftAddr, uint16_t leftConstSize)
+{
+    expect(!_exprStack.empty(), Compiler::Error::InternalError);
+    const ExprEntry& right = _exprStack.back();
+    if (!isConstant(right)) {
+        return false;
+    }
+    
+    if (left) {
+        ExprEntry result;
+        if (!evalConstant(info, *left, right, result)) {
+            return false;
+        }
+        
+        // The left side has been pushed. Get rid of it along with
+        // any constant it added.
+        _rom8.resize(leftAddr);
+        truncateConsts(leftConstSize);
+        _exprStack.pop_back();
+        _exprStack.push_back(result);
+        return true;
+    }
+    
+    // Only the right side is constant. The left side is on TOS
+    if (leftType != Type::Int || right.type() != ExprEntry::Type::Int) {
+        return false;
+    }
+    
+    int32_t value = right;
+    Op op = info.intOp();
+    
+    if ((value == 0 && (op == Op::AddInt || op == Op::SubInt || op == Op::Or || op == Op::Xor)) ||
+            (value == 1 && (op == Op::MulInt || op == Op::DivInt))) {
+        // Left side is the result
+        _exprStack.pop_back();
+        _exprStack.push_back(ExprEntry::Value(leftType));
+        return true;
+    }
+    
+    if (value == 0 && (op == Op::MulInt || op == Op::And) && isPureCode(leftAddr)) {
+        // Result is 0, left side isn't needed
+        _rom8.resize(leftAddr);
+        truncateConsts(leftConstSize);
+        _exprStack.pop_back();
+        _exprStack.push_back(int32_t(0));
+        return true;
+    }
+    
+    return false;
+}
+
+bool
+CloverCompileEngine::evalConstant(const OpInfo& info, const ExprEntry& left, const ExprEntry& right, ExprEntry& result)
+{
+    if (left.type() == ExprEntry::Type::Float) {
+        // Right side is promoted to float, just like bakeExpr would
+        float a = left;
+        float b = (right.type() == ExprEntry::Type::Float) ? float(right) : float(int32_t(right));
+        
+        switch(info.floatOp()) {
+            default: return false;
+            case Op::LTFloat: result = int32_t(a < b); return true;
+            case Op::LEFloat: result = int32_t(a <= b); return true;
+            case Op::EQFloat: result = int32_t(a == b); return true;
+            case Op::NEFloat: result = int32_t(a != b); return true;
+            case Op::GEFloat: result = int32_t(a >= b); return true;
+            case Op::GTFloat: result = int32_t(a > b); return true;
+            case Op::AddFloat: result = a + b; return true;
+            case Op::SubFloat: result = a - b; return true;
+            case Op::MulFloat: result = a * b; return true;
+            case Op::DivFloat: result = a / b; return true;
+        }
+    }
+    
+    // An int op with a float on the right is a type error. Let bakeExpr
+    // report it.
+    if (right.type() != ExprEntry::Type::Int) {
+        return false;
+    }
+    
+    // Do the math unsigned so overflow wraps like it does at runtime
+    int32_t a = left;
+    int32_t b = right;
+    
+    switch(info.intOp()) {
+        default: return false;
+        case Op::Or: result = a | b; return true;
+        case Op::Xor: result = a ^ b; return true;
+        case Op::And: result = a & b; return true;
+        case Op::LOr: result = int32_t(a || b); return true;
+        case Op::LAnd: result = int32_t(a && b); return true;
+        case Op::LTInt: result = int32_t(a < b); return true;
+        case Op::LEInt: result = int32_t(a <= b); return true;
+        case Op::EQInt: result = int32_t(a == b); return true;
+        case Op::NEInt: result = int32_t(a != b); return true;
+        case Op::GEInt: result = int32_t(a >= b); return true;
+        case Op::GTInt: result = int32_t(a > b); return true;
+        case Op::AddInt: result = int32_t(uint32_t(a) + uint32_t(b)); return true;
+        case Op::SubInt: result = int32_t(uint32_t(a) - uint32_t(b)); return true;
+        case Op::MulInt: result = int32_t(uint32_t(a) * uint32_t(b)); return true;
+        case Op::DivInt:
+            // Leave divide by zero for runtime
+            if (b == 0 || (a == INT32_MIN && b == -1)) {
+                return false;
+            }
+            result = a / b;
+            return true;
+    }
+}
+
+bool
+CloverCompileEngine::isPureCode(uint16_t addr) const
+{
+    for (uint16_t pc = addr; pc < _rom8.size(); ) {
+        uint8_t opInt = _rom8[pc];
+        if (opInt >= ExtOpcodeStart) {
+            opInt &= 0xf0;
+        }
+        
+        Op op = Op(opInt);
+        switch(op) {
+            case Op::Push:
+            case Op::PushRef:
+            case Op::PushIntConst:
+                pc += 2;
+                break;
+            case Op::PushIntConstS:
+            case Op::PushDeref:
+            case Op::Offset:
+            case Op::Index:
+                pc += 1;
+                break;
+            case Op::MulFixed:
+            case Op::DivFixed:
+                pc += 1;
+                break;
+            default:
+                // Logical, compare and arithmetic ops
+                if (op < Op::Or || op > Op::NegFloat) {
+                    return false;
+                }
+                pc += 1;
+                break;
+        }
+    }
+    return true;
+}
+
+CloverCompileEngine::CodeMark
+CloverCompileEngine::codeMark() const
+{
+    CodeMark mark;
+    mark._rom8Size = _rom8.size();
+    mark._rom32Size = _rom32.size();
+    mark._numJumps = _jumpList.empty() ? 0 : _jumpList.back().size();
+    return mark;
+}
+
+void
+CloverCompileEngine::discardCode(const CodeMark& mark)
+{
+    _rom8.resize(mark._rom8Size);
+    truncateConsts(mark._rom32Size);
+    truncateLongTargs(mark._rom8Size);
+    
+    if (!_jumpList.empty()) {
+        auto& jumps = _jumpList.back();
+        jumps.erase(jumps.begin() + mark._numJumps, jumps.end());
+    }
+    
+    // Annotations for the discarded code go with the next instruction
+    auto annotations = _scanner.annotations();
+    if (annotations) {
+        for (auto& it : *annotations) {
+            if (it.first > int32_t(mark._rom8Size)) {
+                it.first = mark._rom8Size;
+            }
+        }
+    }
+}
+
+void
+CloverCompileEngine::statements()
+{
+    bool reachable = true;
+    
+    while (true) {
+        CodeMark mark = codeMark();
+        if (!statement()) {
+            break;
+        }
+        
+        if (!reachable) {
+            discardCode(mark);
+        } else if (_noFallThrough) {
+            reachable = false;
+        }
+    }
+    
+    _noFallThrough = !reachable;
+}
+
+uint8_t
+CloverCompileEngine::instrSize(uint16_t pc, Op& op, uint8_t& index) const
+{
+    uint8_t opInt = _rom8[pc];
+    index = 0;
+    if (opInt >= ExtOpcodeStart) {
+        index = opInt & 0x0f;
+        opInt &= 0xf0;
+    }
+    
+    OpData opData;
+    if (!opDataFromOp(Op(opInt), opData)) {
+        return 0;
+    }
+    op = opData._op;
+    
+    uint16_t size = 2;
+    switch(opData._par) {
+        case OpParams::None:
+        case OpParams::Index:
+            size = 1;
+            break;
+        case OpParams::Sid_Sid:
+        case OpParams::Sid_Const:
+        case OpParams::LongTarg:
+            size = 3;
+            break;
+        case OpParams::Sid_Sid_BwdTarg:
+        case OpParams::Sid_Const_BwdTarg:
+            size = 4;
+            break;
+        case OpParams::Idx_Len_S:
+            if (size_t(pc) + 1 >= _rom8.size()) {
+                return 0;
+            }
+            size = 2 + _rom8[pc + 1];
+            break;
+        default:
+            break;
+    }
+    return (pc + size <= _rom8.size()) ? size : 0;
+}
+
+uint16_t
+CloverCompileEngine::inlineSize(uint16_t addr) const
+{
+    // The code after SetFrame has to end with a Return. It can't have
+    // any calls, so it can't recurse, or long ops.
+    uint16_t start = addr + 2;
+    uint16_t last = 0;
+    Op op = Op::None;
+    
+    for (uint16_t pc = start; pc < _rom8.size(); ) {
+        uint8_t index;
+        uint8_t size = instrSize(pc, op, index);
+        if (size == 0 || op == Op::Call || op == Op::Long || op == Op::SetFrame ||
+                _longTargs.find(pc) != _longTargs.end()) {
+            return 0;
+        }
+        last = pc;
+        pc += size;
+    }
+    
+    if (op != Op::Return || last - start > MaxInlineSize) {
+        return 0;
+    }
+    return last - start;
+}
+
+bool
+CloverCompileEngine::inlineCall(const Function& fun)
+{
+    uint16_t size = fun.inlineSize();
+    if (!_inline || size == 0) {
+        return false;
+    }
+    
+    uint16_t start = fun.addr() + 2;
+    std::vector<uint8_t> body(_rom8.begin() + start, _rom8.begin() + start + size);
+
+    // Every Return but the last becomes a Jump to the end, which is a byte
+    // longer. Find the new address of each instruction so the Jumps and Ifs
+    // can be moved to match. The last Return and the address after it are
+    // the end.
+    std::vector<uint16_t> newAddrs(size + 2);
+    uint16_t newSize = 0;
+    for (uint16_t pc = 0; pc < size; ) {
+        Op op;
+        uint8_t index;
+        uint8_t n = instrSize(start + pc, op, index);
+        newAddrs[pc] = newSize;
+        newSize += (op == Op::Return) ? 2 : n;
+        pc += n;
+    }
+    newAddrs[size] = newAddrs[size + 1] = newSize;
+    
+    // The args are popped into the slots after the caller's locals, so the
+    // growth is those Pops and the body less the Call it replaces
+    int32_t growth = int32_t(fun.args()) * 2 + newSize - ((fun.addr() < MaxShortCallTarg) ? 2 : 3);
+    if (growth > _inlineBudget) {
+        return false;
+    }
+    
+    Function& caller = currentFunction();
+    uint8_t base = caller.nextSlot();
+    if (!caller.reserveLocals(fun.args() + fun.localSize())) {
+        return false;
+    }
+    if (caller.localSize() > _localHighWaterMark) {
+        _localHighWaterMark = caller.localSize();
+    }
+    _inlineBudget -= growth;
+    
+    for (uint8_t i = fun.args(); i > 0; --i) {
+        addOpId(Op::Pop, LocalStart + base + i - 1);
+    }
+    
+    for (uint16_t pc = 0; pc < size; ) {
+        Op op;
+        uint8_t index;
+        uint8_t n = instrSize(start + pc, op, index);
+        uint16_t next = newAddrs[pc] + 2;
+        
+        switch(op) {
+            case Op::Return:
+                addOpTarg(Op::Jump, newSize - next);
+                break;
+            case Op::If:
+            case Op::Jump: {
+                uint16_t targ = (uint16_t(index) << 8) | body[pc + 1];
+                int32_t rel = (targ & 0x800) ? int16_t(targ | 0xf000) : int16_t(targ);
+                int32_t oldTarg = int32_t(pc) + 2 + rel;
+                expect(oldTarg >= 0 && oldTarg <= size + 1, Compiler::Error::InternalError);
+                addOpTarg(op, uint16_t(newAddrs[oldTarg] - next));
+                break;
+            }
+            case Op::Push:
+            case Op::Pop:
+            case Op::PushRef: {
+                uint16_t id = (uint16_t(index) << 8) | body[pc + 1];
+                addOpId(op, (id >= LocalStart) ? (id + base) : id);
+                break;
+            }
+            default:
+                annotate();
+                _rom8.insert(_rom8.end(), body.begin() + pc, body.begin() + pc + n);
+                break;
+        }
+        pc += n;
+    }
+    return true;
+}
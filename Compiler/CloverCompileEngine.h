@@ -21,6 +21,7 @@
 #include "Scanner.h"
 #include <cstdint>
 #include <istream>
+#include <unordered_map>
 #include <variant>
 
 namespace clvr {
@@ -64,7 +65,7 @@ structEntry:
 
 // <id> is a struct name
 type:
-    'float' | 'int' | <id> 
+    'float' | 'int' | 'fixed' | <id> 
 
 value:
     ['-'] <float> | ['-'] <integer>
@@ -106,7 +107,7 @@ jumpStatement:
     ;
 
 logStatement:
-    'log' '(' <string> { ',' arithmeticExpression } ')' ';' ;
+    'log' '(' [ <integer> ',' ] <string> { ',' arithmeticExpression } ')' ';' ;
 
 varStatement:
     type [ '*' ] var { ',' var } ';' ;
@@ -207,10 +208,11 @@ private:
         enum class Assign { None, Only, Op };
         
         // assign says this is an assignmentOperator, opAssign says it also has a binary op
-        OpInfo(Token token, uint8_t prec, Op intOp, Op floatOp, Assign assign, Type resultType)
+        OpInfo(Token token, uint8_t prec, Op intOp, Op floatOp, Op fixedOp, Assign assign, Type resultType)
             : _token(token)
             , _intOp(intOp)
             , _floatOp(floatOp)
+            , _fixedOp(fixedOp)
             , _prec(prec)
             , _assign(assign)
             , _resultType(resultType)
@@ -226,13 +228,21 @@ private:
         uint8_t prec() const { return _prec; }
         Op intOp() const { return _intOp; }
         Op floatOp() const { return _floatOp; }
+        Op fixedOp() const { return _fixedOp; }
         Assign assign() const { return _assign; }
+        
+        // The op for operands of type t
+        Op op(Type t) const
+        {
+            return (t == Type::Int) ? _intOp : ((t == Type::Fixed) ? _fixedOp : _floatOp);
+        }
         Type resultType() const { return _resultType; }
 
     private:
         Token _token;
         Op _intOp;
         Op _floatOp;
+        Op _fixedOp;
         uint8_t _prec;
         Assign _assign;
         Type _resultType;
@@ -267,8 +277,8 @@ private:
 
     virtual bool isReserved(Token token, const std::string str, Reserved&) override;
 
-    uint8_t findInt(int32_t);
-    uint8_t findFloat(float);
+    uint16_t findInt(int32_t);
+    uint16_t findFloat(float);
     
     // The ExprStack
     //
@@ -318,6 +328,7 @@ private:
         
         void addEntry(const std::string& name, Type type)
         {
+            _index.emplace(name, _entries.size());
             _entries.emplace_back(name, type);
             
             // FIXME: For now assume all 1 word types. Will we support Structs in Structs?
@@ -327,12 +338,23 @@ private:
         
         const std::vector<ParamEntry>& entries() const { return _entries; }
         
+        bool findEntry(const std::string& name, uint8_t& index) const
+        {
+            auto it = _index.find(name);
+            if (it == _index.end()) {
+                return false;
+            }
+            index = it->second;
+            return true;
+        }
+        
         const std::string& name() const { return _name; }
         uint8_t size() const { return _size; }
         
     private:
         std::string _name;
         std::vector<ParamEntry> _entries;
+        std::unordered_map<std::string, uint8_t> _index;
         uint8_t _size = 0;
     };
 
@@ -425,7 +447,51 @@ private:
     void exitJumpContext(uint16_t startAddr, uint16_t contAddr, uint16_t breakAddr);
     void addJumpEntry(Op, JumpEntry::Type);
     
+    // Constant folding. If both sides of a binary op are constants the
+    // result is computed here. If only the right side is, identities
+    // (x+0, x*1, x*0, etc.) are removed. left is the left hand constant
+    // or null and leftAddr and leftConstSize are the sizes of _rom8 and
+    // _rom32 before the left side was baked.
+    bool foldExpr(const OpInfo&, const ExprEntry* left, Type leftType, uint16_t leftAddr, uint16_t leftConstSize);
+    static bool evalConstant(const OpInfo&, const ExprEntry& left, const ExprEntry& right, ExprEntry& result);
+    static bool isConstant(const ExprEntry& entry)
+    {
+        return entry.type() == ExprEntry::Type::Int || entry.type() == ExprEntry::Type::Float;
+    }
+    
+    // True if the code from addr to the end has no side effects
+    bool isPureCode(uint16_t addr) const;
+    
+    // Dead code elimination. Code generated after a mark can be thrown
+    // away along with any break or continue jumps it added.
+    struct CodeMark
+    {
+        uint16_t _rom8Size;
+        uint16_t _rom32Size;
+        size_t _numJumps;
+    };
+    
+    CodeMark codeMark() const;
+    void discardCode(const CodeMark&);
+    
+    // Handle a list of statements, throwing away any that can't be
+    // reached. Returns when statement() fails.
+    void statements();
+    
+    // Inlining. A function with no calls and at most MaxInlineSize bytes
+    // of code is copied to where it's called, with its args popped into
+    // the slots after the caller's locals and its locals after them.
+    // Each Return but the last jumps to the end. inlineSize() is the size
+    // of the code of the function at addr to copy, or 0 if it can't be
+    // inlined. inlineCall() returns false if the call has to be made
+    // instead, because inlining is off or out of budget or the function
+    // can't be inlined.
+    uint8_t instrSize(uint16_t pc, Op&, uint8_t& index) const;
+    uint16_t inlineSize(uint16_t addr) const;
+    bool inlineCall(const Function&);
+    
     std::vector<Struct> _structs;
+    std::unordered_map<std::string, uint8_t> _structIndex;
     std::vector<ExprEntry> _exprStack;
     std::vector<Symbol> _builtins;
     
@@ -434,6 +500,10 @@ private:
     // has an array of break or continue statements that need to be resolved
     // when the looping statement ends.
     std::vector<std::vector<JumpEntry>> _jumpList;
+    
+    // Set when the last statement never falls through to the next
+    // (return, break, continue). Statements after it are unreachable.
+    bool _noFallThrough = false;
 };
 
 }
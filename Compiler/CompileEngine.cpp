@@ -9,6 +9,9 @@
 
 #include "CompileEngine.h"
 
+#include "Optimizer.h"
+#include "Verifier.h"
+#include <algorithm>
 #include <cmath>
 #include <map>
 
@@ -67,6 +70,8 @@ static std::vector<OpData> _opcodes = {
     { "DivFloat",       Op::DivFloat        , OpParams::None },
     { "NegInt",         Op::NegInt          , OpParams::None },
     { "NegFloat",       Op::NegFloat        , OpParams::None },
+    { "MulFixed",       Op::MulFixed        , OpParams::None },
+    { "DivFixed",       Op::DivFixed        , OpParams::None },
 
     { "PreIncInt",      Op::PreIncInt       , OpParams::None },
     { "PreIncFloat",    Op::PreIncFloat     , OpParams::None },
@@ -76,9 +81,28 @@ static std::vector<OpData> _opcodes = {
     { "PostIncFloat",   Op::PostIncFloat    , OpParams::None },
     { "PostDecInt",     Op::PostDecInt      , OpParams::None },
     { "PostDecFloat",   Op::PostDecFloat    , OpParams::None },
+    { "PreIncFixed",    Op::PreIncFixed     , OpParams::None },
+    { "PreDecFixed",    Op::PreDecFixed     , OpParams::None },
+    { "PostIncFixed",   Op::PostIncFixed    , OpParams::None },
+    { "PostDecFixed",   Op::PostDecFixed    , OpParams::None },
     
     { "Offset",         Op::Offset          , OpParams::Index },
     { "Index",          Op::Index           , OpParams::Index },
+    
+    { "AddIntConst",    Op::AddIntConst     , OpParams::SConst },
+    { "Push2",          Op::Push2           , OpParams::Sid_Sid },
+    { "StoreIntConst",  Op::StoreIntConst   , OpParams::Sid_Const },
+    { "AddToVar",       Op::AddToVar        , OpParams::Sid },
+    { "IfLTInt",        Op::IfLTInt         , OpParams::FwdTarg },
+    { "IfLEInt",        Op::IfLEInt         , OpParams::FwdTarg },
+    { "IfEQInt",        Op::IfEQInt         , OpParams::FwdTarg },
+    { "IfNEInt",        Op::IfNEInt         , OpParams::FwdTarg },
+    { "IfGEInt",        Op::IfGEInt         , OpParams::FwdTarg },
+    { "IfGTInt",        Op::IfGTInt         , OpParams::FwdTarg },
+    { "IncLoopLTInt",   Op::IncLoopLTInt    , OpParams::Sid_Sid_BwdTarg },
+    { "IncLoopLTIntConst", Op::IncLoopLTIntConst, OpParams::Sid_Const_BwdTarg },
+    
+    { "Long",           Op::Long            , OpParams::LongTarg },
 };
 
 CompileEngine::CompileEngine(std::istream* stream, std::vector<std::pair<int32_t, std::string>>* annotations)
@@ -93,40 +117,247 @@ static void emitUInt16(std::vector<uint8_t>& executable, uint16_t v)
 }
 
 void
-CompileEngine::emit(std::vector<uint8_t>& executable)
+CompileEngine::optimize(bool peephole)
 {
-    // Set the stack to be whatever the high water was for
-    // function variable allocation plue StackOverhead.
-    // If this is more than MaxStackSize, then we have a 
-    // problem.
-    uint32_t stackSize = uint32_t(_localHighWaterMark) + StackOverhead;
-    expect(stackSize <= MaxStackSize, Compiler::Error::StackTooBig);
+    std::vector<uint16_t> entries;
+    std::vector<uint16_t> removable;
+    for (const auto& it : _functions) {
+        if (!it.isNative()) {
+            entries.push_back(it.addr());
+            if (peephole && it.usedByTable()) {
+                removable.push_back(it.addr());
+            }
+        }
+    }
+    for (const auto& it : _commands) {
+        entries.push_back(it._initAddr);
+        entries.push_back(it._loopAddr);
+    }
     
+    Optimizer optimizer(_rom8, _longTargs);
+    if (!optimizer.optimize(entries, peephole, removable)) {
+        // The long targets aren't in the code, so it has to be laid out
+        expect(_longTargs.empty(), Compiler::Error::InternalError);
+        return;
+    }
+    _longTargs.clear();
+    
+    for (auto& it : _functions) {
+        if (!it.isNative()) {
+            it.setAddr(optimizer.map(it.addr()));
+        }
+    }
+    for (auto& it : _commands) {
+        it._initAddr = optimizer.map(it._initAddr);
+        it._loopAddr = optimizer.map(it._loopAddr);
+    }
+    
+    auto annotations = _scanner.annotations();
+    if (annotations) {
+        for (auto& it : *annotations) {
+            if (it.first >= 0) {
+                it.first = optimizer.removed(it.first) ? -1 : optimizer.map(it.first);
+            }
+        }
+    }
+}
+
+// Verifies an executable being emitted, with the native functions of
+// the engine
+class CompileEngine::ExecutableVerifier : public Verifier
+{
+public:
+    ExecutableVerifier(const std::vector<uint8_t>& executable, const std::vector<Function>& functions)
+        : _executable(executable)
+    {
+        for (auto& it : _nativeParams) {
+            it = -1;
+        }
+        for (const auto& it : functions) {
+            if (it.isNative()) {
+                _nativeParams[uint8_t(it.nativeId())] = it.args();
+            }
+        }
+    }
+
+protected:
+    virtual uint8_t rom(uint16_t addr) const override
+    {
+        return (addr < _executable.size()) ? _executable[addr] : 0;
+    }
+
+    virtual int16_t numNativeParams(uint8_t id) const override { return _nativeParams[id]; }
+
+private:
+    const std::vector<uint8_t>& _executable;
+    int16_t _nativeParams[256];
+};
+
+void
+CompileEngine::emitImage(std::vector<uint8_t>& executable, const std::vector<uint32_t>& consts,
+                         const std::vector<Command>& commands, const std::vector<uint8_t>& code, uint16_t stackSize) const
+{
     executable.push_back('a');
     executable.push_back('r');
     executable.push_back('l');
     executable.push_back('y');
-    emitUInt16(executable, _rom32.size());
+    emitUInt16(executable, consts.size());
     emitUInt16(executable, _globalSize);
     emitUInt16(executable, stackSize);
     
-    char* buf = reinterpret_cast<char*>(&(_rom32[0]));
-    executable.insert(executable.end(), buf, buf + _rom32.size() * 4);
+    const char* buf = reinterpret_cast<const char*>(&(consts[0]));
+    executable.insert(executable.end(), buf, buf + consts.size() * 4);
 
-    for (int i = 0; i < _commands.size(); ++i) {
-        const std::string& cmd = _commands[i]._cmd;
+    for (int i = 0; i < commands.size(); ++i) {
+        const std::string& cmd = commands[i]._cmd;
         for (int i = 0; i < 7; ++i) {
             executable.push_back(cmd[i]);
         }
         
-        executable.push_back(_commands[i]._count);
-        emitUInt16(executable, _commands[i]._initAddr);
-        emitUInt16(executable, _commands[i]._loopAddr);
+        executable.push_back(commands[i]._count);
+        emitUInt16(executable, commands[i]._initAddr);
+        emitUInt16(executable, commands[i]._loopAddr);
     }
     executable.push_back(0);
     
-    buf = reinterpret_cast<char*>(&(_rom8[0]));
-    executable.insert(executable.end(), buf, buf + _rom8.size());
+    buf = reinterpret_cast<const char*>(&(code[0]));
+    executable.insert(executable.end(), buf, buf + code.size());
+}
+
+void
+CompileEngine::emit(std::vector<uint8_t>& executable)
+{
+    expect(_longTargs.empty(), Compiler::Error::InternalError);
+    expect(_rom8.size() <= MaxCodeSize, Compiler::Error::ExecutableTooBig);
+    
+    // Stack size is filled in below. Until then it's as big as it can be
+    // so the Verifier doesn't fail on it
+    emitImage(executable, _rom32, _commands, _rom8, Verifier::UnboundedStack);
+    
+    uint32_t stackSize = 0;
+    ExecutableVerifier verifier(executable, _functions);
+    _stackBounded = verifier.verify() && verifier.stackBounded();
+    if (_stackBounded) {
+        uint16_t codeOffset = ConstOffset + _rom32.size() * 4 + _commands.size() * 12 + 1;
+        for (const auto& it : _commands) {
+            uint16_t init = verifier.stackSize(it._initAddr + codeOffset);
+            uint16_t loop = verifier.stackSize(it._loopAddr + codeOffset);
+            stackSize = std::max(stackSize, uint32_t(std::max(init, loop)));
+        }
+    }
+    
+    // Without a bound, use whatever the high water was for function
+    // variable allocation plus StackOverhead
+    if (!_stackBounded) {
+        stackSize = uint32_t(_localHighWaterMark) + StackOverhead;
+    }
+    expect(stackSize <= MaxStackSize, Compiler::Error::StackTooBig);
+    executable[8] = uint8_t(stackSize);
+    executable[9] = uint8_t(stackSize >> 8);
+}
+
+// Runs code at compile time. The arg to the function being run is a
+// const, which setArg() changes between calls. Log output is dropped.
+class CompileEngine::Evaluator : public Interpreter
+{
+public:
+    Evaluator(std::vector<NativeModule*>& modules, std::vector<uint8_t>& executable, uint16_t argAddr)
+        : Interpreter(modules.empty() ? nullptr : &modules[0], uint32_t(modules.size()))
+        , _executable(executable)
+        , _argAddr(argAddr)
+    { }
+    
+    void setArg(int32_t arg)
+    {
+        for (uint8_t i = 0; i < 4; ++i) {
+            _executable[_argAddr + i] = uint8_t(uint32_t(arg) >> (i * 8));
+        }
+    }
+
+protected:
+    virtual uint8_t rom(uint16_t addr) const override
+    {
+        return (addr < _executable.size()) ? _executable[addr] : 0;
+    }
+    
+    virtual void log(const char*) const override { }
+
+private:
+    std::vector<uint8_t>& _executable;
+    uint16_t _argAddr;
+};
+
+static int32_t convertValue(int32_t v, CompileEngine::Type from, CompileEngine::Type to)
+{
+    if (from == to) {
+        return v;
+    }
+    
+    switch(from) {
+        case CompileEngine::Type::Float:
+            return (to == CompileEngine::Type::Int) ? int32_t(roundf(intToFloat(v))) : floatToFixed(intToFloat(v));
+        case CompileEngine::Type::Fixed:
+            return (to == CompileEngine::Type::Int) ? fixedToInt(v) : int32_t(floatToInt(fixedToFloat(v)));
+        default:
+            return (to == CompileEngine::Type::Float) ? int32_t(floatToInt(float(v))) : intToFixed(v);
+    }
+}
+
+void
+CompileEngine::tableFromFunction(const Function& fun, Type t, int32_t count)
+{
+    expect(!fun.isNative(), Compiler::Error::ExpectedFunction);
+    expect(fun.args() == 1, Compiler::Error::WrongNumberOfArgs);
+    expect(fun.local(0).type() == Type::Int && !fun.local(0).isPointer() &&
+           (fun.type() == Type::Int || fun.type() == Type::Float || fun.type() == Type::Fixed), Compiler::Error::WrongType);
+    expect(count > 0 && _rom32.size() + count < ConstSize, Compiler::Error::TooManyConstants);
+    
+    // The code so far with a command after it. Its init does nothing and
+    // its loop returns fun of the const after the others.
+    std::vector<uint8_t> code = _rom8;
+    std::vector<uint32_t> consts = _rom32;
+    uint16_t argId = consts.size();
+    consts.push_back(0);
+    
+    uint16_t initAddr = code.size();
+    code.insert(code.end(), { uint8_t(Op::SetFrame), 0, uint8_t(Op::PushIntConstS), uint8_t(Op::Return) });
+    uint16_t loopAddr = code.size();
+    code.insert(code.end(), { uint8_t(Op::SetFrame), 0, uint8_t(uint8_t(Op::Push) | (argId >> 8)), uint8_t(argId) });
+    if (fun.addr() < MaxShortCallTarg) {
+        code.insert(code.end(), { uint8_t(uint8_t(Op::Call) | (fun.addr() >> 8)), uint8_t(fun.addr()) });
+    } else {
+        code.insert(code.end(), { uint8_t(uint8_t(Op::Long) | uint8_t(LongOp::Call)), uint8_t(fun.addr()), uint8_t(fun.addr() >> 8) });
+    }
+    code.push_back(uint8_t(Op::Return));
+    
+    // Code with long targets has to be laid out to run
+    if (!_longTargs.empty()) {
+        std::vector<uint16_t> entries = { initAddr, loopAddr };
+        for (const auto& it : _functions) {
+            if (!it.isNative()) {
+                entries.push_back(it.addr());
+            }
+        }
+        Optimizer optimizer(code, _longTargs);
+        expect(optimizer.optimize(entries, false), Compiler::Error::InternalError);
+        initAddr = optimizer.map(initAddr);
+        loopAddr = optimizer.map(loopAddr);
+    }
+    expect(code.size() <= MaxCodeSize, Compiler::Error::ExecutableTooBig);
+    
+    std::vector<uint8_t> executable;
+    emitImage(executable, consts, { Command("table  ", 0, initAddr, loopAddr) }, code, MaxStackSize);
+    
+    Evaluator evaluator(_modules, executable, ConstOffset + argId * 4);
+    evaluator.setBudget(MaxCompileTimeInstrs);
+    
+    for (int32_t i = 0; i < count; ++i) {
+        evaluator.setArg(i);
+        bool ok = evaluator.init(uint8_t(0), nullptr, 0);
+        int32_t v = evaluator.loop();
+        expect(ok && !evaluator.suspended() && evaluator.error() == Interpreter::Error::None, Compiler::Error::CompileTimeCallFailed);
+        addConst(convertValue(v, fun.type(), t));
+    }
 }
 
 bool
@@ -144,18 +375,17 @@ CompileEngine::constant()
     expect(identifier(id), Compiler::Error::ExpectedIdentifier);
     expect(value(val, t), Compiler::Error::ExpectedValue);
     
-    // There is only enough room for ConstSize constant values
-    expect(_rom32.size() < ConstSize, Compiler::Error::TooManyConstants);
-
-    // If the constant is an int between -127 and 128, then put it in the
-    // Def list. It will be emitted as a PushConst or PushConstS to avoid
-    // taking up constant space
-    if (t == Type::Int && val >= -128 && val <= 127) {
-        _defs.emplace_back(id, val);
-    } else {
-        expect(addGlobal(id, _rom32.size(), t, Symbol::Storage::Const), Compiler::Error::DuplicateIdentifier);
-        _rom32.push_back(val);
-    }
+    expect(t == Type::Int || t == Type::Float || t == Type::Fixed, Compiler::Error::WrongType);
+
+    // Constants go in the Def list so they can be folded into expressions
+    // at compile time. When one is used as a value it's emitted as a
+    // PushIntConst or PushIntConstS if it's small enough, otherwise it
+    // is added to constant space then.
+    Def def;
+    Symbol sym;
+    expect(!findDef(id, def) && !findSymbol(id, sym), Compiler::Error::DuplicateIdentifier);
+    _defIndex.emplace(id, _defs.size());
+    _defs.emplace_back(id, val, t);
     
     return true;
 }
@@ -188,7 +418,11 @@ CompileEngine::command()
                     [id](const Command& cmd) { return cmd._cmd == id; });
     expect(it == _commands.end(), Compiler::Error::DuplicateIdentifier);
     
-    _commands.emplace_back(id, paramCount, handleFunctionName().addr(), handleFunctionName().addr());
+    // The order args are evaluated in is unspecified, so get the init
+    // and loop functions first
+    uint16_t initAddr = handleFunctionName().addr();
+    uint16_t loopAddr = handleFunctionName().addr();
+    _commands.emplace_back(id, paramCount, initAddr, loopAddr);
     return true;
 }
 
@@ -203,6 +437,10 @@ CompileEngine::type(Type& t)
         t = Type::Int;
         return true;
     }
+    if (match(Reserved::Fixed)) {
+        t = Type::Fixed;
+        return true;
+    }
     
     // See if it's a struct
     
@@ -220,7 +458,7 @@ CompileEngine::values(Type t)
         }
         haveValues = true;
         
-        _rom32.push_back(val);
+        addConst(val);
     }
     return haveValues;
 }
@@ -240,9 +478,11 @@ CompileEngine::value(int32_t& i, Type t)
             f = -f;
         }
 
-        // If we're expecting an Integer, convert it
+        // If we're expecting an Integer or Fixed, convert it
         if (t == Type::Int) {
             i = roundf(f);
+        } else if (t == Type::Fixed) {
+            i = floatToFixed(f);
         } else {
             i = *(reinterpret_cast<int32_t*>(&f));
         }
@@ -258,6 +498,8 @@ CompileEngine::value(int32_t& i, Type t)
         if (t == Type::Float) {
             f = float(i);
             i = *(reinterpret_cast<int32_t*>(&f));
+        } else if (t == Type::Fixed) {
+            i = intToFixed(i);
         }
         return true;
     }
@@ -411,11 +653,10 @@ CompileEngine::handleFunctionName()
     std::string targ;
     expect(identifier(targ), Compiler::Error::ExpectedIdentifier);
     
-    auto it = find_if(_functions.begin(), _functions.end(),
-                    [targ](const Function& fun) { return fun.name() == targ; });
-    expect(it != _functions.end(), Compiler::Error::UndefinedIdentifier);
+    auto it = _functionIndex.find(targ);
+    expect(it != _functionIndex.end(), Compiler::Error::UndefinedIdentifier);
 
-    return *it;
+    return _functions[it->second];
 }
 
 bool
@@ -455,6 +696,7 @@ CompileEngine::isReserved(Token token, const std::string str, Reserved& r)
         { "else",       Reserved::Else },
         { "float",      Reserved::Float },
         { "int",        Reserved::Int },
+        { "fixed",      Reserved::Fixed },
     };
 
     if (token != Token::Identifier) {
@@ -472,44 +714,116 @@ CompileEngine::isReserved(Token token, const std::string str, Reserved& r)
 bool
 CompileEngine::findSymbol(const std::string& s, Symbol& sym)
 {
-    const auto& it = find_if(_globals.begin(), _globals.end(),
-                    [s](const Symbol& sym) { return sym.name() == s; });
-
-    if (it != _globals.end()) {
-        sym = *it;
+    const auto& it = _globalIndex.find(s);
+    if (it != _globalIndex.end()) {
+        sym = _globals[it->second];
         return true;
     }
     
-    // Not found. See if it's a local to the current function (param or var)
-    return currentFunction().findLocal(s, sym);
+    // Not found. See if it's a local to the current function (param or var).
+    // Outside a function the current function is the last one defined,
+    // which may be a native, so don't look at it
+    return _inFunction && currentFunction().findLocal(s, sym);
 }
 
 bool
 CompileEngine::findDef(const std::string& s, Def& def)
 {
-    auto it = find_if(_defs.begin(), _defs.end(),
-                    [s](const Def& d) { return d._name == s; });
-
-    if (it != _defs.end()) {
-        def = *it;
+    auto it = _defIndex.find(s);
+    if (it != _defIndex.end()) {
+        def = _defs[it->second];
         return true;
     }
     return false;
 }
+
 bool
 CompileEngine::findFunction(const std::string& s, Function& fun)
 {
-    auto it = find_if(_functions.begin(), _functions.end(),
-                    [s](const Function& fun) { return fun.name() == s; });
-
-    if (it != _functions.end()) {
-        fun = *it;
+    auto it = _functionIndex.find(s);
+    if (it != _functionIndex.end()) {
+        fun = _functions[it->second];
         return true;
     }
     
     return false;
 }
 
+void
+CompileEngine::nativeSignatures(std::string& s) const
+{
+    for (const auto& it : _functions) {
+        if (!it.isNative()) {
+            continue;
+        }
+        s += it.name() + "," + std::to_string(it.nativeId()) + "," + std::to_string(int(it.type())) + "(";
+        for (uint8_t i = 0; i < it.args(); ++i) {
+            const Symbol& param = it.local(i);
+            s += std::to_string(int(param.type())) + (param.isPointer() ? "*" : "") + ",";
+        }
+        s += ");";
+    }
+}
+
+uint16_t
+CompileEngine::addConst(uint32_t v)
+{
+    expect(_rom32.size() < ConstSize, Compiler::Error::TooManyConstants);
+    
+    // Keep the first entry with this value if there already is one
+    _constIndex.emplace(v, uint16_t(_rom32.size()));
+    _rom32.push_back(v);
+    return _rom32.size() - 1;
+}
+
+uint16_t
+CompileEngine::internConst(uint32_t v)
+{
+    auto it = _constIndex.find(v);
+    if (it != _constIndex.end()) {
+        return it->second;
+    }
+    return addConst(v);
+}
+
+void
+CompileEngine::truncateConsts(size_t size)
+{
+    // An entry being removed is only in the index if it was the first
+    // with its value, in which case no earlier entry has that value
+    while (_rom32.size() > size) {
+        auto it = _constIndex.find(_rom32.back());
+        if (it != _constIndex.end() && it->second == _rom32.size() - 1) {
+            _constIndex.erase(it);
+        }
+        _rom32.pop_back();
+    }
+}
+
+void
+CompileEngine::setJumpTarg(uint16_t addr, uint16_t targ)
+{
+    int32_t offset = int32_t(targ) - int32_t(addr) - 2;
+    if (offset < -2048 || offset > 2047) {
+        _longTargs[addr] = targ;
+        return;
+    }
+    _rom8[addr] |= uint8_t((offset >> 8) & 0x0f);
+    _rom8[addr + 1] = uint8_t(offset);
+}
+
+void
+CompileEngine::truncateLongTargs(size_t size)
+{
+    for (auto it = _longTargs.begin(); it != _longTargs.end(); ) {
+        if (it->first >= size) {
+            it = _longTargs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 uint16_t
 CompileEngine::Symbol::addr() const
 {
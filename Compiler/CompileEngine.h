@@ -16,6 +16,7 @@
 #include "Scanner.h"
 #include <cstdint>
 #include <istream>
+#include <unordered_map>
 #include <vector>
 
 namespace clvr {
@@ -24,7 +25,7 @@ class CompileEngine
 {
 public:
     // Built-in types are 0x00-0x7f, custom types are 0x80-0xff
-    enum class Type : uint8_t { None = 0, Float = 1, Int = 2, UInt8 = 3, Ptr = 5 };
+    enum class Type : uint8_t { None = 0, Float = 1, Int = 2, UInt8 = 3, Fixed = 4, Ptr = 5 };
 
     class Symbol
     {
@@ -33,7 +34,7 @@ public:
         
         Symbol() { }
         
-        Symbol(const std::string& name, uint16_t addr, Type type, Storage storage = Storage::Local, bool ptr = false, uint8_t size = 1)
+        Symbol(const std::string& name, uint16_t addr, Type type, Storage storage = Storage::Local, bool ptr = false, uint16_t size = 1)
             : _name(name)
             , _addr(addr)
             , _type(type)
@@ -51,7 +52,7 @@ public:
         Type type() const { return _type; }
         bool isPointer() const { return _ptr; }
         Storage storage() const { return _storage; }
-        uint8_t size() const { return _size; }
+        uint16_t size() const { return _size; }
         
     private:
         std::string _name;
@@ -59,7 +60,7 @@ public:
         Type _type = Type::None;
         bool _ptr = false;
         Storage _storage = Storage::None;
-        uint8_t _size = 0;
+        uint16_t _size = 0;
     };
     
     using SymbolList = std::vector<Symbol>;
@@ -68,9 +69,48 @@ public:
     
     virtual ~CompileEngine() { }
     
+    // Compile the source in buf rather than the stream
+    void setSource(const char* buf, size_t size) { _scanner.setBuffer(buf, size); }
+    
     virtual bool program() = 0;
     
+    // Run the peephole optimizer over the generated code, if peephole is
+    // true, and lay it out with the long Jump, If and Call ops wherever the
+    // short ones can't reach. Addresses of functions, commands and
+    // annotations are updated to match. With peephole, functions only
+    // used to make tables are left out.
+    void optimize(bool peephole = true);
+    
+    // True if the code has targets the short ops can't reach, so it has to
+    // be laid out by optimize() even if it isn't optimized
+    bool needsLayout() const { return !_longTargs.empty(); }
+    
+    // The header's stack size is the most any command's init or loop needs,
+    // with everything it calls, found by running the Verifier on the code.
+    // If a command can recurse (or the code doesn't pass the Verifier)
+    // there's no bound, so it falls back to the local high water mark plus
+    // StackOverhead and stackBounded() is false.
     void emit(std::vector<uint8_t>& executable);
+    bool stackBounded() const { return _stackBounded; }
+    
+    // See Compiler::setLogLevel()
+    void setLogLevel(int32_t level) { _logLevel = level; }
+    
+    // The modules the executable will run with, for running functions at
+    // compile time (see tableFromFunction())
+    void setModules(const std::vector<NativeModule*>& modules) { _modules = modules; }
+    
+    static constexpr uint16_t MaxInlineSize = 32;       // Most code a function can have to be inlined
+    static constexpr uint32_t InlineBudgetFraction = 8; // Inlining adds at most 1/8 of the max
+
+    // Inline calls to small functions. The code inlining adds is limited to
+    // a fraction of maxExecutableSize. If the executable is still too big
+    // Compiler::compile() compiles it again without inlining
+    void setInline(bool inlineCalls, uint32_t maxExecutableSize)
+    {
+        _inline = inlineCalls;
+        _inlineBudget = int32_t(maxExecutableSize / InlineBudgetFraction);
+    }
 
     Compiler::Error error() const { return _error; }
     Token expectedToken() const { return _expectedToken; }
@@ -82,9 +122,14 @@ public:
 
     void addNative(const char* name, uint8_t nativeId, Type type, const SymbolList& locals)
     {
+        _functionIndex.emplace(name, _functions.size());
         _functions.emplace_back(name, nativeId, type, locals);
     }
 
+    // Append the name, id, return type and params of each native function
+    // to s. Calls to natives compile differently when any of them change.
+    void nativeSignatures(std::string& s) const;
+
 protected:
     enum class Reserved {
         None,
@@ -105,6 +150,7 @@ protected:
         Else,
         Float,
         Int,
+        Fixed,
         R0, R1, R2, R3,
         C0, C1, C2, C3,
     };
@@ -162,6 +208,23 @@ protected:
         _rom8.push_back(uint8_t(targ));
     }
     
+    // Call the function at targ, with LongCall if Call can't reach it
+    void addCall(uint16_t targ)
+    {
+        if (targ < MaxShortCallTarg) {
+            addOpTarg(Op::Call, targ);
+            return;
+        }
+        addOp(Op(uint8_t(Op::Long) | uint8_t(LongOp::Call)));
+        _rom8.push_back(uint8_t(targ));
+        _rom8.push_back(uint8_t(targ >> 8));
+    }
+    
+    // Fill in the targ of the If or Jump added at addr with addOpTarg(op, 0).
+    // If it's too far for a relTarg it's kept in _longTargs and optimize()
+    // makes it a long op.
+    void setJumpTarg(uint16_t addr, uint16_t targ);
+    
     void addOpIdI(Op op, uint8_t id, uint8_t i)
     {
         addOp(op);
@@ -195,29 +258,45 @@ protected:
 
     class Function;
     const Function& handleFunctionName();
+    
+    // Add count consts of type t, fun(0) to fun(count - 1). fun has to be
+    // compiled already and take one int. It's run in an Interpreter with
+    // the code so far, so it can call other functions and natives. Log
+    // output is dropped. It fails if fun doesn't return within
+    // MaxCompileTimeInstrs instructions or has a runtime error.
+    static constexpr uint32_t MaxCompileTimeInstrs = 1000000;
+    void tableFromFunction(const Function& fun, Type t, int32_t count);
+
+    class ExecutableVerifier;
+    class Evaluator;
 
     static bool opDataFromString(const std::string str, OpData& data);
 
-    bool addGlobal(const std::string& name, uint8_t addr, Type type, Symbol::Storage storage, bool ptr = false, uint8_t size = 1)
+    bool addGlobal(const std::string& name, uint16_t addr, Type type, Symbol::Storage storage, bool ptr = false, uint16_t size = 1)
     {
         // Check for duplicates
         Symbol sym;
         if (findSymbol(name, sym)) {
             return false;
         }
+        _globalIndex.emplace(name, _globals.size());
         _globals.emplace_back(name, addr, type, storage, ptr, size);
         return true;
     }
 
+    // A named compile time constant. _value is the bits of a float
+    // if _type is Float and a Q16.16 value if it is Fixed
     struct Def
     {
         Def() { }
-        Def(std::string name, uint8_t value)
+        Def(std::string name, int32_t value, Type type = Type::Int)
             : _name(name)
             , _value(value)
+            , _type(type)
         { }
         std::string _name;
-        uint8_t _value;
+        int32_t _value = 0;
+        Type _type = Type::Int;
     };
     
     class Function
@@ -240,10 +319,15 @@ protected:
             , _args(locals.size())
             , _type(type)
             , _native(true)
-        { }
+        {
+            for (uint8_t i = 0; i < _locals.size(); ++i) {
+                _localIndex.emplace(_locals[i].name(), i);
+            }
+        }
 
         const std::string& name() const { return _name; }
         int16_t addr() const { return _addr; }
+        void setAddr(int16_t addr) { _addr = addr; }
         uint8_t& args() { return _args; }
         const uint8_t& args() const { return _args; }
         Type type() const { return _type; }
@@ -255,6 +339,12 @@ protected:
         {
             // remove the last n locals and reduce _localSize
             while (n-- > 0) {
+                // Only drop the index entry if it's for this local and
+                // not an earlier one with the same name
+                auto it = _localIndex.find(_locals.back().name());
+                if (it != _localIndex.end() && it->second == _locals.size() - 1) {
+                    _localIndex.erase(it);
+                }
                 _localSize -= _locals.back().size();
                 _locals.pop_back();
             }
@@ -263,10 +353,36 @@ protected:
         bool isNative() const { return _native; }
         int16_t nativeId() const { return _addr; }
 
+        // Size of the code between SetFrame and the last Return if calls
+        // to the function can be inlined, otherwise 0
+        uint16_t inlineSize() const { return _inlineSize; }
+        void setInlineSize(uint16_t size) { _inlineSize = size; }
+        
+        // True if a table was made from it. If nothing calls it, it's
+        // left out of the optimized executable
+        bool usedByTable() const { return _usedByTable; }
+        void setUsedByTable() { _usedByTable = true; }
+        
+        // The first slot after the args and the locals in scope. The args
+        // and locals of a function inlined here go in the slots after it,
+        // which reserveLocals() adds to the frame
+        uint8_t nextSlot() const { return _args + _localSize; }
+        bool reserveLocals(uint8_t n)
+        {
+            if (uint16_t(_localSize) + n > 0xff) {
+                return false;
+            }
+            if (_localHighWaterMark < _localSize + n) {
+                _localHighWaterMark = _localSize + n;
+            }
+            return true;
+        }
+
         // Args are always 1 word and will always come before locals. So the
         // addr is the current locals size.
         void addArg(const std::string& name, Type type, bool isPtr)
         {
+            _localIndex.emplace(name, _locals.size());
             _locals.emplace_back(name, _locals.size(), type, Symbol::Storage::Local, isPtr);
             _args++;
         }
@@ -278,6 +394,7 @@ protected:
             if (findLocal(name, sym)) {
                 return false;
             }
+            _localIndex.emplace(name, _locals.size());
             _locals.emplace_back(name, _localSize + _args, type, Symbol::Storage::Local, ptr, size);
             _localSize += size;
             if (_localHighWaterMark < _localSize) {
@@ -288,11 +405,9 @@ protected:
 
         bool findLocal(const std::string& s, Symbol& sym)
         {
-            const auto& it = find_if(_locals.begin(), _locals.end(),
-                    [s](const Symbol& p) { return p.name() == s; });
-
-            if (it != _locals.end()) {
-                sym = *it;
+            const auto& it = _localIndex.find(s);
+            if (it != _localIndex.end()) {
+                sym = _locals[it->second];
                 return true;
             }
             return false;
@@ -302,11 +417,17 @@ protected:
         std::string _name;
         int16_t _addr = 0;
         std::vector<Symbol> _locals;
+        
+        // Index of each name in _locals. Args and locals are in scope
+        // until pruneLocals() removes them, which erases them here too.
+        std::unordered_map<std::string, uint8_t> _localIndex;
         uint8_t _args = 0;
         Type _type;
         bool _native = false;
         uint8_t _localSize = 0;
         uint8_t _localHighWaterMark = 0;
+        uint16_t _inlineSize = 0;
+        bool _usedByTable = false;
     };
     
     struct Command
@@ -324,6 +445,10 @@ protected:
         uint16_t _loopAddr = 0;
     };
     
+    // Write the header, consts, commands and code of an executable
+    void emitImage(std::vector<uint8_t>& executable, const std::vector<uint32_t>& consts,
+                   const std::vector<Command>& commands, const std::vector<uint8_t>& code, uint16_t stackSize) const;
+    
     Function& currentFunction()
     {
         if (_functions.empty()) {
@@ -346,6 +471,16 @@ protected:
     bool findDef(const std::string&, Def&);
     bool findFunction(const std::string&, Function&);
 
+    // Constant space. addConst() always adds a new entry, internConst()
+    // returns an existing entry with the same value if there is one. To
+    // throw away constants added after a point use truncateConsts().
+    uint16_t addConst(uint32_t);
+    uint16_t internConst(uint32_t);
+    void truncateConsts(size_t size);
+    
+    // Throw away the long targets of code after size, when it's removed
+    void truncateLongTargs(size_t size);
+
     Compiler::Error _error = Compiler::Error::None;
     Token _expectedToken = Token::None;
     std::string _expectedString;
@@ -359,6 +494,19 @@ protected:
     std::vector<uint32_t> _rom32;
     std::vector<uint8_t> _rom8;
 
+    // Lookups by name and constant value, so finding a symbol or a
+    // constant doesn't scan the lists above. Each holds the index of
+    // the first entry with that name or value, which is the one a
+    // search from the start would have found.
+    std::unordered_map<std::string, uint16_t> _defIndex;
+    std::unordered_map<std::string, uint16_t> _globalIndex;
+    std::unordered_map<std::string, uint16_t> _functionIndex;
+    std::unordered_map<uint32_t, uint16_t> _constIndex;
+    
+    // Targets of the If and Jump ops in _rom8 which are too far for a
+    // relTarg, by the address of the op. See setJumpTarg().
+    std::unordered_map<uint16_t, uint16_t> _longTargs;
+
     // Vars are defined in 2 places. At global scope (when there are
     // no active functions) they are placed in _global memory.
     // When a function is being defined the vars are placed on the
@@ -367,8 +515,13 @@ protected:
     uint16_t _nextMem = 0; // next available location in mem
     uint16_t _localHighWaterMark = 0;
     uint16_t _globalSize = 0;
+    bool _stackBounded = true;
+    int32_t _logLevel = Compiler::AllLogLevels;
+    bool _inline = false;
+    int32_t _inlineBudget = 0;
     bool _inFunction = false;
     uint8_t _nextNativeId = 0;
+    std::vector<NativeModule*> _modules;
 };
 
 }
@@ -10,6 +10,7 @@
 #include "Compiler.h"
 
 #include "CloverCompileEngine.h"
+#include "Compressor.h"
 #include "NativeCore.h"
 
 #include <map>
@@ -21,22 +22,31 @@ bool Compiler::compile(std::istream* istream, Language lang,
                        std::vector<uint8_t>& executable, uint32_t maxExecutableSize,
                        const std::vector<NativeModule*>& modules,
                        std::vector<std::pair<int32_t, std::string>>* annotations)
+{
+    return compile(istream, nullptr, 0, lang, executable, maxExecutableSize, modules, annotations);
+}
+
+bool Compiler::compile(const char* buf, size_t size, Language lang,
+                       std::vector<uint8_t>& executable, uint32_t maxExecutableSize,
+                       const std::vector<NativeModule*>& modules,
+                       std::vector<std::pair<int32_t, std::string>>* annotations)
+{
+    return compile(nullptr, buf, size, lang, executable, maxExecutableSize, modules, annotations);
+}
+
+CompileEngine* Compiler::newEngine(std::istream* istream, Language lang, const std::vector<NativeModule*>& modules,
+                                   std::vector<std::pair<int32_t, std::string>>* annotations)
 {
     CompileEngine* engine = nullptr;
     
     switch(lang) {
         default:
-            break;
+            return nullptr;
         case Language::Clover:
             engine = new CloverCompileEngine(istream, annotations);
             break;
     }
     
-    if (!engine) {
-        _error = Error::UnrecognizedLanguage;
-        return false;
-    }
-    
     // Install the modules in the engine
     // First add the core
     NativeCore().addFunctions(engine);
@@ -44,27 +54,93 @@ bool Compiler::compile(std::istream* istream, Language lang,
     for (const auto& it : modules) {
         it->addFunctions(engine);
     }
+    engine->setModules(modules);
+    return engine;
+}
+
+std::string Compiler::fingerprint(Language lang, uint32_t maxExecutableSize, const std::vector<NativeModule*>& modules) const
+{
+    // The build time is in it so a rebuilt compiler doesn't match the
+    // output of an older one, even if Version wasn't changed
+    std::string s = std::string("clover ") + Version + " " + __DATE__ + " " + __TIME__;
+    s += " lang=" + std::to_string(int(lang)) + " opt=" + (_optimize ? "1" : "0") + " z=" + (_compress ? "1" : "0");
+    s += " log=" + std::to_string(_logLevel) + " max=" + std::to_string(maxExecutableSize) + " natives=";
     
-    engine->program();
-    _error = engine->error();
-    _expectedToken = engine->expectedToken();
-    _expectedString = engine->expectedString();
-    _lineno = engine->lineno();
-    _charno = engine->charno();
-    
-    try {
-        if (_error == Error::None) {
-            engine->emit(executable);
-        }
-    }
-    catch(...) {
+    CompileEngine* engine = newEngine(nullptr, lang, modules, nullptr);
+    if (engine) {
+        engine->nativeSignatures(s);
+        delete engine;
     }
+    return s;
+}
+
+bool Compiler::compile(std::istream* istream, const char* buf, size_t size, Language lang,
+                       std::vector<uint8_t>& executable, uint32_t maxExecutableSize,
+                       const std::vector<NativeModule*>& modules,
+                       std::vector<std::pair<int32_t, std::string>>* annotations)
+{
+    // Inlining makes the code bigger. If it makes it too big, compile it
+    // again without
+    bool inlineCalls = _optimize;
     
-    if (_error == Error::None && executable.size() > maxExecutableSize) {
-        _error = Error::ExecutableTooBig;
+    while (true) {
+        CompileEngine* engine = newEngine(istream, lang, modules, annotations);
+        if (!engine) {
+            _error = Error::UnrecognizedLanguage;
+            return false;
+        }
+        
+        if (buf) {
+            engine->setSource(buf, size);
+        }
+        engine->setLogLevel(_logLevel);
+        engine->setInline(inlineCalls, maxExecutableSize);
+        
+        engine->program();
+        _error = engine->error();
+        _expectedToken = engine->expectedToken();
+        _expectedString = engine->expectedString();
+        _lineno = engine->lineno();
+        _charno = engine->charno();
+        
+        try {
+            if (_error == Error::None) {
+                if (_optimize || engine->needsLayout()) {
+                    engine->optimize(_optimize);
+                }
+                engine->emit(executable);
+                _stackBounded = engine->stackBounded();
+                if (_compress) {
+                    std::vector<uint8_t> uncompressed;
+                    uncompressed.swap(executable);
+                    Compressor::compress(uncompressed, executable);
+                }
+            }
+        }
+        catch(...) {
+            _error = engine->error();
+        }
+        
+        if (_error == Error::None && executable.size() > maxExecutableSize) {
+            _error = Error::ExecutableTooBig;
+        }
+        
+        delete engine;
+        
+        if (_error != Error::ExecutableTooBig || !inlineCalls) {
+            break;
+        }
+        
+        inlineCalls = false;
+        executable.clear();
+        if (annotations) {
+            annotations->clear();
+        }
+        if (istream) {
+            istream->clear();
+            istream->seekg(0);
+        }
     }
     
-    delete engine;
-    
     return _error == Error::None;
 }
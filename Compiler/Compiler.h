@@ -72,10 +72,28 @@ public:
         DuplicateIdentifier,
         ExecutableTooBig,
         InitializerNotAllowed,
+        CompileTimeCallFailed,
     };
     
+    // Change this whenever the executable for the same source changes
+    static constexpr const char* Version = "0.5";
+    
     Compiler() { }
     
+    // Turn off the peephole optimizer and inlining, to compare against
+    // unoptimized code
+    void setOptimize(bool optimize) { _optimize = optimize; }
+    
+    // Output a compressed executable (see Compressed.h). maxExecutableSize
+    // is then the most it can be compressed
+    void setCompress(bool compress) { _compress = compress; }
+    
+    // Leave out log statements with a level above level, so they cost
+    // nothing in the executable. A log without a level is at 0, so -1
+    // leaves them all out. By default they're all kept
+    static constexpr int32_t AllLogLevels = 0x7fffffff;
+    void setLogLevel(int32_t level) { _logLevel = level; }
+    
     enum class Language { Arly, Clover };
     
     bool compile(std::istream*, Language, 
@@ -83,14 +101,48 @@ public:
                  const std::vector<NativeModule*>&,
                  std::vector<std::pair<int32_t, std::string>>* annotations = nullptr);
 
+    // Compile size bytes of source at buf, which must stay valid until
+    // this returns. It isn't copied, so it can be a file mapped into
+    // memory. Separate Compilers can run on separate threads.
+    bool compile(const char* buf, size_t size, Language,
+                 std::vector<uint8_t>& executable, uint32_t maxExecutableSize,
+                 const std::vector<NativeModule*>&,
+                 std::vector<std::pair<int32_t, std::string>>* annotations = nullptr);
+
+    // Everything besides the source that the executable depends on: the
+    // Version and build of the compiler, the language, the optimize,
+    // compress and log level settings, the maxExecutableSize (which limits
+    // inlining) and the signatures of the natives in the core and the
+    // modules. The same source and fingerprint always compile to the same
+    // executable, so the pair can be used as a cache key.
+    std::string fingerprint(Language, uint32_t maxExecutableSize, const std::vector<NativeModule*>&) const;
+
     Error error() const { return _error; }
     Token expectedToken() const { return _expectedToken; }
     const std::string& expectedString() const { return _expectedString; }
     uint32_t lineno() const { return _lineno; }
     uint32_t charno() const { return _charno; }        
 
+    // False if a command can recurse, so its stack size couldn't be found
+    // and a fixed amount was used
+    bool stackBounded() const { return _stackBounded; }
+
 private:
+    // Make the engine for lang, with the core and modules installed.
+    // Returns nullptr if the language isn't supported
+    static CompileEngine* newEngine(std::istream*, Language, const std::vector<NativeModule*>&,
+                                    std::vector<std::pair<int32_t, std::string>>* annotations);
+
+    bool compile(std::istream*, const char* buf, size_t size, Language,
+                 std::vector<uint8_t>& executable, uint32_t maxExecutableSize,
+                 const std::vector<NativeModule*>&,
+                 std::vector<std::pair<int32_t, std::string>>* annotations);
+
     Error _error = Error::None;
+    bool _optimize = true;
+    bool _compress = false;
+    int32_t _logLevel = AllLogLevels;
+    bool _stackBounded = true;
     Token _expectedToken = Token::None;
     std::string _expectedString;
     uint32_t _lineno;
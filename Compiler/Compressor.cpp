@@ -0,0 +1,158 @@
+/*-------------------------------------------------------------------------
+    This source file is a part of Clover
+    For the latest info, see https://github.com/cmarrin/Clover
+    Copyright (c) 2021-2022, Chris Marrin
+    All rights reserved.
+    Use of this source code is governed by the MIT license that can be
+    found in the LICENSE file.
+-------------------------------------------------------------------------*/
+
+#include "Compressor.h"
+
+#include "Compressed.h"
+
+#include <algorithm>
+
+using namespace clvr;
+
+class Compressor::BitWriter
+{
+public:
+    BitWriter(std::vector<uint8_t>& out) : _out(out) { }
+    
+    void write(uint16_t value, uint8_t bits)
+    {
+        while (bits--) {
+            if (_bit == 0) {
+                _out.push_back(0);
+            }
+            if ((value >> bits) & 1) {
+                _out.back() |= 0x80 >> _bit;
+            }
+            _bit = (_bit + 1) & 7;
+        }
+    }
+    
+    void symbol(uint8_t s)
+    {
+        // Make the canonical code from the table the decoder uses
+        uint16_t code = 0;
+        uint8_t index = 0;
+        for (uint8_t len = 0; len < MaxCodeLength; ++len) {
+            for (uint8_t i = 0; i < CompressedCodeCounts[len]; ++i, ++index, ++code) {
+                if (CompressedCodeSymbols[index] == s) {
+                    write(code, len + 1);
+                    return;
+                }
+            }
+            code <<= 1;
+        }
+    }
+    
+private:
+    std::vector<uint8_t>& _out;
+    uint8_t _bit = 0;
+};
+
+bool
+Compressor::isCompressed(const std::vector<uint8_t>& in)
+{
+    return in.size() >= CompressedPageSizesOffset && isCompressedSignature(in[0], in[1], in[2], in[3]);
+}
+
+void
+Compressor::compressPage(const uint8_t* page, uint8_t size, std::vector<uint8_t>& out)
+{
+    BitWriter writer(out);
+    
+    for (uint8_t pos = 0; pos < size; ) {
+        uint8_t bestLen = 0;
+        uint8_t bestDistance = 0;
+        for (uint8_t distance = 1; distance <= pos; ++distance) {
+            uint8_t len = 0;
+            while (pos + len < size && len < MaxMatch && page[pos - distance + len] == page[pos + len]) {
+                ++len;
+            }
+            if (len > bestLen) {
+                bestLen = len;
+                bestDistance = distance;
+            }
+        }
+        
+        if (bestLen >= MinMatch) {
+            writer.symbol(FirstMatchSymbol + bestLen - MinMatch);
+            writer.write(bestDistance - 1, matchDistanceBits(pos));
+            pos += bestLen;
+            continue;
+        }
+        
+        uint8_t literal = 0;
+        while (literal < NumLiteralSymbols && CompressedLiterals[literal] != page[pos]) {
+            ++literal;
+        }
+        if (literal < NumLiteralSymbols) {
+            writer.symbol(literal);
+        } else {
+            writer.symbol(EscapeSymbol);
+            writer.write(page[pos], 8);
+        }
+        ++pos;
+    }
+}
+
+void
+Compressor::compress(const std::vector<uint8_t>& in, std::vector<uint8_t>& out)
+{
+    uint16_t numPages = (in.size() + CompressedPageSize - 1) / CompressedPageSize;
+    
+    out = { 'a', 'r', 'l', 'z', uint8_t(in.size()), uint8_t(in.size() >> 8) };
+    out.resize(CompressedPageSizesOffset + numPages);
+    
+    for (uint16_t i = 0; i < numPages; ++i) {
+        const uint8_t* page = in.data() + i * CompressedPageSize;
+        uint8_t size = uint8_t(std::min(size_t(CompressedPageSize), in.size() - i * CompressedPageSize));
+        
+        std::vector<uint8_t> codes;
+        compressPage(page, size, codes);
+        if (codes.size() >= size) {
+            codes.assign(page, page + size);
+        }
+        out[CompressedPageSizesOffset + i] = uint8_t(codes.size());
+        out.insert(out.end(), codes.begin(), codes.end());
+    }
+}
+
+bool
+Compressor::decompress(const std::vector<uint8_t>& in, std::vector<uint8_t>& out)
+{
+    if (!isCompressed(in)) {
+        out = in;
+        return true;
+    }
+    
+    uint16_t size = uint16_t(in[4]) | (uint16_t(in[5]) << 8);
+    uint16_t numPages = (size + CompressedPageSize - 1) / CompressedPageSize;
+    size_t offset = CompressedPageSizesOffset + numPages;
+    if (offset > in.size()) {
+        return false;
+    }
+    
+    out.resize(size);
+    for (uint16_t i = 0; i < numPages; ++i) {
+        uint8_t pageSize = uint8_t(std::min(uint16_t(CompressedPageSize), uint16_t(size - i * CompressedPageSize)));
+        uint8_t compressedSize = in[CompressedPageSizesOffset + i];
+        if (offset + compressedSize > in.size()) {
+            return false;
+        }
+        
+        uint8_t* page = out.data() + i * CompressedPageSize;
+        const uint8_t* codes = in.data() + offset;
+        if (compressedSize == pageSize) {
+            std::copy(codes, codes + pageSize, page);
+        } else if (!decompressPage([codes](uint8_t i) { return codes[i]; }, compressedSize, page, pageSize)) {
+            return false;
+        }
+        offset += compressedSize;
+    }
+    return true;
+}
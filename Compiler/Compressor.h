@@ -0,0 +1,42 @@
+/*-------------------------------------------------------------------------
+    This source file is a part of Clover
+    For the latest info, see https://github.com/cmarrin/Clover
+    Copyright (c) 2021-2022, Chris Marrin
+    All rights reserved.
+    Use of this source code is governed by the MIT license that can be
+    found in the LICENSE file.
+-------------------------------------------------------------------------*/
+
+// Compress an executable into the 'arlz' format (see Runtime/Compressed.h)
+//
+// Each page is parsed greedily into the longest match in the page so far
+// (the nearest one if there are several) or a literal. A page that
+// doesn't get smaller is stored as is. decompress() turns a compressed
+// executable back into the original, for tools that need to look at the
+// code, like the Decompiler.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace clvr {
+
+class Compressor
+{
+public:
+    static void compress(const std::vector<uint8_t>& in, std::vector<uint8_t>& out);
+    
+    // If in isn't compressed it is copied. Returns false if it's invalid
+    static bool decompress(const std::vector<uint8_t>& in, std::vector<uint8_t>& out);
+    
+    static bool isCompressed(const std::vector<uint8_t>&);
+    
+private:
+    class BitWriter;
+    
+    static void compressPage(const uint8_t* page, uint8_t size, std::vector<uint8_t>& out);
+};
+
+}
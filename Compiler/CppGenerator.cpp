@@ -0,0 +1,585 @@
+/*-------------------------------------------------------------------------
+    This source file is a part of Clover
+    For the latest info, see https://github.com/cmarrin/Clover
+    Copyright (c) 2021-2022, Chris Marrin
+    All rights reserved.
+    Use of this source code is governed by the MIT license that can be
+    found in the LICENSE file.
+-------------------------------------------------------------------------*/
+
+#include "CppGenerator.h"
+
+#include "NativeCore.h"
+
+#include <cstdio>
+
+using namespace clvr;
+
+class CppGenerator::BufferVerifier : public Verifier
+{
+public:
+    BufferVerifier(const CppGenerator* gen) : _gen(gen) { }
+
+protected:
+    virtual uint8_t rom(uint16_t addr) const override { return _gen->getUInt8(addr); }
+
+    virtual int16_t numNativeParams(uint8_t id) const override
+    {
+        if (_core.hasId(id)) {
+            return _core.numParams(id);
+        }
+        for (uint32_t i = 0; i < _gen->_modSize; ++i) {
+            if (_gen->_mod[i]->hasId(id)) {
+                return _gen->_mod[i]->numParams(id);
+            }
+        }
+        return -1;
+    }
+
+private:
+    const CppGenerator* _gen;
+    NativeCore _core;
+};
+
+static const char* compareOp(Op op)
+{
+    switch(op) {
+        case Op::LTInt: case Op::LTFloat: case Op::IfLTInt: return "<";
+        case Op::LEInt: case Op::LEFloat: case Op::IfLEInt: return "<=";
+        case Op::EQInt: case Op::EQFloat: case Op::IfEQInt: return "==";
+        case Op::NEInt: case Op::NEFloat: case Op::IfNEInt: return "!=";
+        case Op::GEInt: case Op::GEFloat: case Op::IfGEInt: return ">=";
+        default: return ">";
+    }
+}
+
+static const char* arithOp(Op op)
+{
+    switch(op) {
+        case Op::AddInt: case Op::AddFloat: return "+";
+        case Op::SubInt: case Op::SubFloat: return "-";
+        case Op::MulInt: case Op::MulFloat: return "*";
+        default: return "/";
+    }
+}
+
+// The op of the instruction starting with byte b. A Long op is given as
+// the short op it does the same thing as
+static Op opFromByte(uint8_t b)
+{
+    if (b < ExtOpcodeStart) {
+        return Op(b);
+    }
+    if (Op(b & 0xf0) != Op::Long) {
+        return Op(b & 0xf0);
+    }
+    switch(LongOp(b & 0x0f)) {
+        case LongOp::Jump: return Op::Jump;
+        case LongOp::If: return Op::If;
+        case LongOp::Call: return Op::Call;
+        default: return Op::Long;
+    }
+}
+
+static std::string hex(uint32_t v)
+{
+    char buf[12];
+    snprintf(buf, sizeof(buf), "0x%08xu", v);
+    return buf;
+}
+
+bool
+CppGenerator::generate()
+{
+    if (getUInt8(0) != 'a' || getUInt8(1) != 'r' || getUInt8(2) != 'l' || getUInt8(3) != 'y') {
+        _error = Error::InvalidSignature;
+        return false;
+    }
+
+    BufferVerifier verifier(this);
+    if (!verifier.verify()) {
+        _error = Error::VerifyFailed;
+        _verifyError = verifier.error();
+        _errorAddr = verifier.errorAddr();
+        return false;
+    }
+
+    uint16_t commandStart = ConstOffset + getUInt16(4) * 4;
+    uint16_t addr = commandStart;
+    for ( ; getUInt8(addr) != 0; addr += 12) {
+        _entries.insert(getUInt16(addr + 8));
+        _entries.insert(getUInt16(addr + 10));
+    }
+    _codeOffset = addr + 1;
+
+    std::set<uint16_t> entries;
+    for (auto it : _entries) {
+        entries.insert(it + _codeOffset);
+    }
+    _entries = entries;
+
+    // Find everything that needs a label
+    bool hasReturn = false;
+    for (addr = _codeOffset; addr < _in->size(); ) {
+        int32_t targ;
+        uint8_t len = parse(addr, targ);
+        if (len == 0) {
+            _error = Error::InvalidOp;
+            _errorAddr = addr;
+            return false;
+        }
+
+        Op op = opFromByte(getUInt8(addr));
+        if (op == Op::Call) {
+            _returnSites.insert(addr + len);
+        } else if (op == Op::Return) {
+            hasReturn = true;
+        }
+        if (targ >= 0) {
+            _labels.insert(targ);
+        }
+        addr += len;
+    }
+    _labels.insert(_returnSites.begin(), _returnSites.end());
+    _labels.insert(_entries.begin(), _entries.end());
+
+    _out->append("// Generated by 'compile -c', do not edit\n\n");
+    _out->append("#pragma once\n\n");
+    _out->append("#include \"Interpreter.h\"\n\n");
+    rom();
+
+    _out->append("static int32_t Clover_" + _name + "(clvr::Interpreter* interp, uint16_t addr)\n{\n");
+    if (hasReturn) {
+        line("int16_t pc;");
+        _out->append("\n");
+    }
+    line("switch(addr) {");
+    for (auto it : _entries) {
+        line("    case " + std::to_string(it) + ": goto " + labelName(it) + ";");
+    }
+    line("    default: return -1;");
+    line("}");
+
+    for (addr = _codeOffset; addr < _in->size(); ) {
+        int32_t targ;
+        uint8_t len = parse(addr, targ);
+        if (_labels.count(addr)) {
+            _out->append("\n" + labelName(addr) + ":\n");
+        }
+        if (!statement(addr, verifier)) {
+            _error = Error::InvalidOp;
+            _errorAddr = addr;
+            return false;
+        }
+        addr += len;
+    }
+
+    // Return to the instruction after the Call
+    if (hasReturn) {
+        _out->append("\nReturn:\n");
+        line("switch(pc) {");
+        for (auto it : _returnSites) {
+            line("    case " + std::to_string(it) + ": goto " + labelName(it) + ";");
+        }
+        line("    default: return -1;");
+        line("}");
+    }
+    _out->append("}\n");
+    return true;
+}
+
+void
+CppGenerator::rom()
+{
+    _out->append("static const uint8_t PROGMEM Clover_" + _name + "_ROM[ ] = {\n");
+
+    for (uint16_t i = 0; i < _codeOffset; ++i) {
+        char hexbuf[5];
+        snprintf(hexbuf, sizeof(hexbuf), "0x%02x", getUInt8(i));
+        _out->append(hexbuf);
+        _out->append((i % 8 == 7) ? ",\n" : ", ");
+    }
+    _out->append("\n};\n\n");
+}
+
+uint8_t
+CppGenerator::parse(uint16_t addr, int32_t& targ) const
+{
+    uint8_t cmd = getUInt8(addr);
+    uint8_t index = 0;
+    if (cmd >= ExtOpcodeStart) {
+        index = cmd & 0x0f;
+        cmd &= 0xf0;
+    }
+
+    targ = -1;
+    uint16_t operand = (uint16_t(index) << 8) | getUInt8(addr + 1);
+
+    switch(Op(cmd)) {
+        default:
+            return 0;
+        case Op::PushDeref:
+        case Op::PopDeref:
+        case Op::Dup:
+        case Op::Drop:
+        case Op::Swap:
+        case Op::Return:
+        case Op::Or:
+        case Op::Xor:
+        case Op::And:
+        case Op::Not:
+        case Op::LOr:
+        case Op::LAnd:
+        case Op::LNot:
+        case Op::LTInt:
+        case Op::LTFloat:
+        case Op::LEInt:
+        case Op::LEFloat:
+        case Op::EQInt:
+        case Op::EQFloat:
+        case Op::NEInt:
+        case Op::NEFloat:
+        case Op::GEInt:
+        case Op::GEFloat:
+        case Op::GTInt:
+        case Op::GTFloat:
+        case Op::AddInt:
+        case Op::AddFloat:
+        case Op::SubInt:
+        case Op::SubFloat:
+        case Op::MulInt:
+        case Op::MulFloat:
+        case Op::DivInt:
+        case Op::DivFloat:
+        case Op::NegInt:
+        case Op::NegFloat:
+        case Op::PreIncInt:
+        case Op::PreIncFloat:
+        case Op::PreDecInt:
+        case Op::PreDecFloat:
+        case Op::PostIncInt:
+        case Op::PostIncFloat:
+        case Op::PostDecInt:
+        case Op::PostDecFloat:
+        case Op::MulFixed:
+        case Op::DivFixed:
+        case Op::PreIncFixed:
+        case Op::PreDecFixed:
+        case Op::PostIncFixed:
+        case Op::PostDecFixed:
+        case Op::Offset:
+        case Op::Index:
+        case Op::PushIntConstS:
+            return 1;
+        case Op::PushIntConst:
+        case Op::CallNative:
+        case Op::AddIntConst:
+        case Op::AddToVar:
+        case Op::PushRef:
+        case Op::Push:
+        case Op::Pop:
+        case Op::SetFrame:
+            return 2;
+        case Op::Push2:
+        case Op::StoreIntConst:
+            return 3;
+        case Op::IfLTInt:
+        case Op::IfLEInt:
+        case Op::IfEQInt:
+        case Op::IfNEInt:
+        case Op::IfGEInt:
+        case Op::IfGTInt:
+            targ = addr + 2 + getUInt8(addr + 1);
+            return 2;
+        case Op::IncLoopLTInt:
+        case Op::IncLoopLTIntConst:
+            targ = addr + 4 - getUInt8(addr + 3);
+            return 4;
+        case Op::Call:
+            targ = operand + _codeOffset;
+            return 2;
+        case Op::Jump:
+        case Op::If:
+            targ = addr + 2 + ((operand & 0x800) ? int16_t(operand | 0xf000) : int16_t(operand));
+            return 2;
+        case Op::Long:
+            operand = getUInt16(addr + 1);
+            switch(LongOp(index)) {
+                default:
+                    return 0;
+                case LongOp::Jump:
+                case LongOp::If:
+                    targ = addr + 3 + int16_t(operand);
+                    break;
+                case LongOp::Call:
+                    targ = operand + _codeOffset;
+                    break;
+            }
+            return 3;
+        case Op::Log:
+            return 2 + getUInt8(addr + 1);
+    }
+}
+
+std::string
+CppGenerator::value(uint16_t id) const
+{
+    if (id < GlobalStart) {
+        return hex(getUInt32(ConstOffset + id * 4));
+    }
+    return var(id);
+}
+
+std::string
+CppGenerator::ref(uint16_t id) const
+{
+    // Only locals depend on the bp at runtime. See Interpreter::Address
+    if (id < GlobalStart) {
+        return std::to_string((1 << 12) | id);
+    }
+    if (id < LocalStart) {
+        return std::to_string((2 << 12) | (id - GlobalStart));
+    }
+    return "interp->aotRef(" + std::to_string(id) + ")";
+}
+
+std::string
+CppGenerator::var(uint16_t id) const
+{
+    if (id < LocalStart) {
+        return "interp->aotGlobal(" + std::to_string(id - GlobalStart) + ")";
+    }
+    return "interp->aotLocal(" + std::to_string(id - LocalStart) + ")";
+}
+
+bool
+CppGenerator::statement(uint16_t addr, const BufferVerifier& verifier)
+{
+    uint8_t cmd = getUInt8(addr);
+    uint8_t index = 0;
+    if (cmd >= ExtOpcodeStart) {
+        index = cmd & 0x0f;
+        cmd &= 0xf0;
+    }
+
+    // Long ops only differ in their targ
+    Op op = opFromByte(getUInt8(addr));
+    uint8_t b1 = getUInt8(addr + 1);
+    uint16_t id = (uint16_t(index) << 8) | b1;
+    int32_t targ;
+    uint8_t len = parse(addr, targ);
+
+    std::string s;
+
+    switch(op) {
+        default:
+            return false;
+        case Op::Push:
+            line("interp->aotPush(" + value(id) + ");");
+            break;
+        case Op::Pop:
+            // Storing to a const does nothing
+            if (id < GlobalStart) {
+                line("interp->aotPop();");
+            } else {
+                line(var(id) + " = interp->aotPop();");
+            }
+            break;
+        case Op::PushRef:
+            line("interp->aotPush(" + ref(id) + ");");
+            break;
+        case Op::PushIntConst:
+            line("interp->aotPush(" + std::to_string(b1) + ");");
+            break;
+        case Op::PushIntConstS:
+            line("interp->aotPush(" + std::to_string(index) + ");");
+            break;
+        case Op::PushDeref:
+            line("interp->aotTop() = interp->aotLoad(interp->aotTop());");
+            failCheck(addr);
+            break;
+        case Op::PopDeref:
+            line("{ uint32_t v = interp->aotPop(); interp->aotStore(interp->aotPop(), v); }");
+            failCheck(addr);
+            break;
+        case Op::Offset:
+            line("interp->aotTop() += " + std::to_string(index) + ";");
+            break;
+        case Op::Index:
+            line("{ uint32_t v = interp->aotPop(); interp->aotTop() += v * " + std::to_string(index) + "; }");
+            break;
+        case Op::Dup:
+            line("interp->aotPush(interp->aotTop());");
+            break;
+        case Op::Drop:
+            line("interp->aotPop();");
+            break;
+        case Op::Swap:
+            line("interp->aotSwap();");
+            break;
+        case Op::If:
+            line("if (interp->aotPop() == 0) goto " + labelName(targ) + ";");
+            break;
+        case Op::Jump:
+            line("goto " + labelName(targ) + ";");
+            break;
+        case Op::Log: {
+            // Octal escapes so nothing in the string can end the literal
+            s = "interp->aotLog(\"";
+            for (uint8_t i = 0; i < b1; ++i) {
+                char c = char(getUInt8(addr + 2 + i));
+                if (c >= ' ' && c <= '~' && c != '"' && c != '\\' && c != '?') {
+                    s += c;
+                } else {
+                    char buf[5];
+                    snprintf(buf, sizeof(buf), "\\%03o", uint8_t(c));
+                    s += buf;
+                }
+            }
+            line(s + "\", " + std::to_string(index) + ");");
+            break;
+        }
+        case Op::Call:
+            line("interp->aotPush(" + std::to_string(addr + len) + "); goto " + labelName(targ) + ";");
+            break;
+        case Op::CallNative:
+            line("interp->aotCallNative(" + std::to_string(b1) + ");");
+            failCheck(addr);
+            break;
+        case Op::Return:
+            line("{ uint32_t v; pc = interp->aotReturn(v); if (pc < 0) return v; }");
+            failCheck(addr);
+            line("goto Return;");
+            break;
+        case Op::SetFrame:
+            line("if (!interp->aotSetFrame(" + std::to_string(index) + ", " + std::to_string(b1) + ", " +
+                 std::to_string(verifier.maxDepth(addr)) + ") && interp->aotFailed(" + std::to_string(addr) + ")) return -1;");
+            break;
+
+        case Op::Or:    line("{ uint32_t v = interp->aotPop(); interp->aotTop() |= v; }"); break;
+        case Op::Xor:   line("{ uint32_t v = interp->aotPop(); interp->aotTop() ^= v; }"); break;
+        case Op::And:   line("{ uint32_t v = interp->aotPop(); interp->aotTop() &= v; }"); break;
+        case Op::Not:   line("interp->aotTop() = ~interp->aotTop();"); break;
+        case Op::LNot:  line("interp->aotTop() = !interp->aotTop();"); break;
+        case Op::LOr:   line("{ bool r = interp->aotPop() != 0; bool l = interp->aotPop() != 0; interp->aotPush(l || r); }"); break;
+        case Op::LAnd:  line("{ bool r = interp->aotPop() != 0; bool l = interp->aotPop() != 0; interp->aotPush(l && r); }"); break;
+
+        case Op::LTInt:
+        case Op::LEInt:
+        case Op::EQInt:
+        case Op::NEInt:
+        case Op::GEInt:
+        case Op::GTInt:
+            line(std::string("{ int32_t v = int32_t(interp->aotPop()); interp->aotTop() = int32_t(interp->aotTop()) ") +
+                 compareOp(op) + " v; }");
+            break;
+        case Op::LTFloat:
+        case Op::LEFloat:
+        case Op::EQFloat:
+        case Op::NEFloat:
+        case Op::GEFloat:
+        case Op::GTFloat:
+            line(std::string("{ float v = clvr::intToFloat(interp->aotPop()); interp->aotTop() = clvr::intToFloat(interp->aotTop()) ") +
+                 compareOp(op) + " v; }");
+            break;
+
+        case Op::AddInt:
+        case Op::SubInt:
+        case Op::MulInt:
+        case Op::DivInt:
+            line(std::string("{ int32_t v = int32_t(interp->aotPop()); interp->aotTop() = int32_t(interp->aotTop()) ") +
+                 arithOp(op) + " v; }");
+            break;
+        case Op::AddFloat:
+        case Op::SubFloat:
+        case Op::MulFloat:
+        case Op::DivFloat:
+            line(std::string("{ float v = clvr::intToFloat(interp->aotPop()); interp->aotTop() = clvr::floatToInt(clvr::intToFloat(interp->aotTop()) ") +
+                 arithOp(op) + " v); }");
+            break;
+        case Op::MulFixed:
+            line("{ int32_t v = int32_t(interp->aotPop()); interp->aotTop() = clvr::fixedMul(interp->aotTop(), v); }");
+            break;
+        case Op::DivFixed:
+            line("{ int32_t v = int32_t(interp->aotPop()); interp->aotTop() = clvr::fixedDiv(interp->aotTop(), v); }");
+            break;
+        case Op::NegInt:
+            line("interp->aotTop() = -int32_t(interp->aotTop());");
+            break;
+        case Op::NegFloat:
+            line("interp->aotTop() = clvr::floatToInt(-clvr::intToFloat(interp->aotTop()));");
+            break;
+
+        case Op::AddIntConst:
+            line("interp->aotTop() = int32_t(interp->aotTop()) + " + std::to_string(int8_t(b1)) + ";");
+            break;
+        case Op::Push2:
+            line("interp->aotPush(" + var(idFromSid(b1)) + ");");
+            line("interp->aotPush(" + var(idFromSid(getUInt8(addr + 2))) + ");");
+            break;
+        case Op::StoreIntConst:
+            line(var(idFromSid(b1)) + " = " + std::to_string(getUInt8(addr + 2)) + ";");
+            break;
+        case Op::AddToVar:
+            s = var(idFromSid(b1));
+            line(s + " = int32_t(" + s + ") + int32_t(interp->aotPop());");
+            break;
+
+        case Op::IfLTInt:
+        case Op::IfLEInt:
+        case Op::IfEQInt:
+        case Op::IfNEInt:
+        case Op::IfGEInt:
+        case Op::IfGTInt:
+            line(std::string("{ int32_t b = int32_t(interp->aotPop()); int32_t a = int32_t(interp->aotPop()); if (!(a ") +
+                 compareOp(op) + " b)) goto " + labelName(targ) + "; }");
+            break;
+        case Op::IncLoopLTInt:
+        case Op::IncLoopLTIntConst:
+            s = var(idFromSid(b1));
+            line(s + " = int32_t(" + s + ") + 1;");
+            line("if (int32_t(" + s + ") < " +
+                 ((op == Op::IncLoopLTInt) ? "int32_t(" + var(idFromSid(getUInt8(addr + 2))) + ")" : std::to_string(getUInt8(addr + 2))) +
+                 ") goto " + labelName(targ) + ";");
+            break;
+
+        case Op::PreIncInt:
+        case Op::PreDecInt:
+        case Op::PostIncInt:
+        case Op::PostDecInt:
+        case Op::PreIncFixed:
+        case Op::PreDecFixed:
+        case Op::PostIncFixed:
+        case Op::PostDecFixed: {
+            bool inc = op == Op::PreIncInt || op == Op::PostIncInt || op == Op::PreIncFixed || op == Op::PostIncFixed;
+            bool pre = op == Op::PreIncInt || op == Op::PreDecInt || op == Op::PreIncFixed || op == Op::PreDecFixed;
+            bool fixed = op >= Op::PreIncFixed && op <= Op::PostDecFixed;
+            line("{");
+            line("    uint32_t r = interp->aotPop();");
+            line("    int32_t v = int32_t(interp->aotLoad(r));");
+            line(std::string("    int32_t after = v ") + (inc ? "+ " : "- ") + (fixed ? "clvr::FixedOne;" : "1;"));
+            line("    interp->aotStore(r, after);");
+            line(std::string("    interp->aotPush(") + (pre ? "after" : "v") + ");");
+            line("}");
+            failCheck(addr);
+            break;
+        }
+        case Op::PreIncFloat:
+        case Op::PreDecFloat:
+        case Op::PostIncFloat:
+        case Op::PostDecFloat: {
+            bool inc = op == Op::PreIncFloat || op == Op::PostIncFloat;
+            bool pre = op == Op::PreIncFloat || op == Op::PreDecFloat;
+            line("{");
+            line("    uint32_t r = interp->aotPop();");
+            line("    float v = clvr::intToFloat(interp->aotLoad(r));");
+            line(std::string("    float after = v ") + (inc ? "+" : "-") + " 1;");
+            line("    interp->aotStore(r, clvr::floatToInt(after));");
+            line(std::string("    interp->aotPush(clvr::floatToInt(") + (pre ? "after" : "v") + "));");
+            line("}");
+            failCheck(addr);
+            break;
+        }
+    }
+    return true;
+}
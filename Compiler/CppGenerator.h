@@ -0,0 +1,104 @@
+/*-------------------------------------------------------------------------
+    This source file is a part of Clover
+    For the latest info, see https://github.com/cmarrin/Clover
+    Copyright (c) 2021-2022, Chris Marrin
+    All rights reserved.
+    Use of this source code is governed by the MIT license that can be
+    found in the LICENSE file.
+-------------------------------------------------------------------------*/
+
+// Translate an executable into C++ source
+//
+// The output has a PROGMEM array with the header, constants and command
+// entries of the executable and a function that runs its code, for use
+// with Interpreter::setCompiledCode(). The function has an entry for the
+// init and loop functions of each command. Each instruction becomes a few
+// lines of C++ using the aot functions of Interpreter. Jumps and calls are
+// gotos and returns dispatch on the saved pc, so the stack frames are the
+// same as when the code is interpreted.
+//
+// The executable must pass the Verifier, which gives the deepest stack of
+// each function. SetFrame checks that once, so no other op needs to check
+// the stack.
+//
+
+#pragma once
+
+#include "Interpreter.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace clvr {
+
+class CppGenerator
+{
+public:
+    enum class Error {
+        None,
+        InvalidSignature,
+        InvalidOp,
+        VerifyFailed,
+    };
+
+    // name is used to make the names of the array and function unique
+    CppGenerator(const std::vector<uint8_t>* in, std::string* out, const std::string& name,
+                 NativeModule** mod = nullptr, uint32_t modSize = 0)
+        : _in(in)
+        , _out(out)
+        , _name(name)
+        , _mod(mod)
+        , _modSize(mod ? modSize : 0)
+    { }
+
+    bool generate();
+
+    Error error() const { return _error; }
+
+    // Set when error() is VerifyFailed
+    Verifier::Error verifyError() const { return _verifyError; }
+    int16_t errorAddr() const { return _errorAddr; }
+
+private:
+    class BufferVerifier;
+
+    uint8_t getUInt8(uint16_t addr) const { return (addr < _in->size()) ? (*_in)[addr] : 0; }
+    uint16_t getUInt16(uint16_t addr) const { return uint16_t(getUInt8(addr)) | (uint16_t(getUInt8(addr + 1)) << 8); }
+    uint32_t getUInt32(uint16_t addr) const { return uint32_t(getUInt16(addr)) | (uint32_t(getUInt16(addr + 2)) << 16); }
+
+    // Return the length of the instruction at addr or 0 if it's invalid.
+    // If it jumps or calls, return the ROM addr of the target in targ.
+    uint8_t parse(uint16_t addr, int32_t& targ) const;
+
+    // Return false if the op at addr is invalid
+    bool statement(uint16_t addr, const BufferVerifier&);
+
+    // C++ expressions for a Push of id, a ref to id and a global or local
+    // variable
+    std::string value(uint16_t id) const;
+    std::string ref(uint16_t id) const;
+    std::string var(uint16_t id) const;
+
+    void rom();
+    void line(const std::string& s) { _out->append("    "); _out->append(s); _out->append("\n"); }
+    void failCheck(uint16_t addr) { line("if (interp->aotFailed(" + std::to_string(addr) + ")) return -1;"); }
+    std::string labelName(int32_t addr) const { return "L_" + std::to_string(addr); }
+
+    Error _error = Error::None;
+    Verifier::Error _verifyError = Verifier::Error::None;
+    int16_t _errorAddr = -1;
+
+    const std::vector<uint8_t>* _in;
+    std::string* _out;
+    std::string _name;
+    NativeModule** _mod;
+    uint32_t _modSize;
+
+    uint16_t _codeOffset = 0;
+    std::set<uint16_t> _entries;        // Command init and loop functions
+    std::set<uint16_t> _labels;         // Addrs that are jumped to
+    std::set<uint16_t> _returnSites;    // Addrs after each Call
+};
+
+}
@@ -50,7 +50,7 @@ Decompiler::constants()
     incIndent();
     _out->append("const\n");
     
-    uint8_t size = getUInt16();
+    uint16_t size = getUInt16();
     _it += 4;
     
     if (size == 0) {
@@ -61,7 +61,7 @@ Decompiler::constants()
     incIndent();
     _out->append("const\n");
     
-    for (uint8_t i = 0; i < size; ++i) {
+    for (uint16_t i = 0; i < size; ++i) {
         doIndent();
         _out->append("[");
         _out->append(std::to_string(i));
@@ -191,7 +191,8 @@ Decompiler::statement()
     }
 
     // Add blank like before if
-    if (opData._op == Op::If) {
+    if (opData._op == Op::If || (opData._op >= Op::IfLTInt && opData._op <= Op::IfGTInt) ||
+            (opData._op == Op::Long && LongOp(index) == LongOp::If)) {
         _out->append("\n");
     }
 
@@ -199,6 +200,16 @@ Decompiler::statement()
 
     outputAddr();
     _out->append(opData._str);
+    if (opData._op == Op::Long) {
+        switch(LongOp(index)) {
+            case LongOp::Jump: _out->append("Jump"); break;
+            case LongOp::If: _out->append("If"); break;
+            case LongOp::Call: _out->append("Call"); break;
+            default:
+                _error = Error::InvalidOp;
+                throw true;
+        }
+    }
     _out->append(" ");
     
     // Get params
@@ -240,6 +251,61 @@ Decompiler::statement()
             _out->append("]");
             break;
         }
+        case OpParams::Sid:
+            _out->append("[");
+            _out->append(std::to_string(idFromSid(getUInt8())));
+            _out->append("]");
+            break;
+        case OpParams::Sid_Sid:
+            _out->append("[");
+            _out->append(std::to_string(idFromSid(getUInt8())));
+            _out->append("] [");
+            _out->append(std::to_string(idFromSid(getUInt8())));
+            _out->append("]");
+            break;
+        case OpParams::Sid_Const:
+            _out->append("[");
+            _out->append(std::to_string(idFromSid(getUInt8())));
+            _out->append("] ");
+            _out->append(std::to_string(getUInt8()));
+            break;
+        case OpParams::SConst:
+            _out->append(std::to_string(int8_t(getUInt8())));
+            break;
+        case OpParams::FwdTarg:
+            _out->append("[");
+            _out->append(std::to_string(getUInt8()));
+            _out->append("]");
+            break;
+        case OpParams::Sid_Sid_BwdTarg:
+            _out->append("[");
+            _out->append(std::to_string(idFromSid(getUInt8())));
+            _out->append("] [");
+            _out->append(std::to_string(idFromSid(getUInt8())));
+            _out->append("] [-");
+            _out->append(std::to_string(getUInt8()));
+            _out->append("]");
+            break;
+        case OpParams::Sid_Const_BwdTarg:
+            _out->append("[");
+            _out->append(std::to_string(idFromSid(getUInt8())));
+            _out->append("] ");
+            _out->append(std::to_string(getUInt8()));
+            _out->append(" [-");
+            _out->append(std::to_string(getUInt8()));
+            _out->append("]");
+            break;
+        case OpParams::LongTarg: {
+            uint16_t targ = getUInt16();
+            _out->append("[");
+            if (LongOp(index) == LongOp::Call) {
+                _out->append(std::to_string(targ + _codeOffset));
+            } else {
+                _out->append(std::to_string(int16_t(targ)));
+            }
+            _out->append("]");
+            break;
+        }
         case OpParams::P_L:
             id = getUInt8();
             _out->append(std::to_string(index));
@@ -0,0 +1,976 @@
+/*-------------------------------------------------------------------------
+    This source file is a part of Clover
+    For the latest info, see https://github.com/cmarrin/Clover
+    Copyright (c) 2021-2022, Chris Marrin
+    All rights reserved.
+    Use of this source code is governed by the MIT license that can be
+    found in the LICENSE file.
+-------------------------------------------------------------------------*/
+
+#include "Optimizer.h"
+
+#include "CompileEngine.h"
+#include <algorithm>
+
+using namespace clvr;
+
+// The compare a fused if was made from
+static Op compareFromFusedIf(Op op)
+{
+    switch(op) {
+        case Op::IfLTInt: return Op::LTInt;
+        case Op::IfLEInt: return Op::LEInt;
+        case Op::IfEQInt: return Op::EQInt;
+        case Op::IfNEInt: return Op::NEInt;
+        case Op::IfGEInt: return Op::GEInt;
+        default: return Op::GTInt;
+    }
+}
+
+bool
+Optimizer::optimize(const std::vector<uint16_t>& entries, bool peephole, const std::vector<uint16_t>& removable)
+{
+    InstrList list;
+    if (!parse(list)) {
+        return false;
+    }
+
+    // Mark the labels. Every target and entry must be the start of an
+    // instruction, otherwise we can't safely move anything.
+    auto markLabel = [&list](int32_t addr) -> bool
+    {
+        auto it = std::lower_bound(list.begin(), list.end(), addr,
+                    [](const Instr& instr, int32_t a) { return instr.addr < a; });
+        if (it == list.end() || it->addr != addr) {
+            return false;
+        }
+        it->label = true;
+        return true;
+    };
+
+    for (const auto& it : list) {
+        if (it.targ != NoTarg && !markLabel(it.targ)) {
+            return false;
+        }
+    }
+    for (const auto& it : entries) {
+        if (!markLabel(it)) {
+            return false;
+        }
+    }
+
+    if (!removable.empty()) {
+        removeUnused(list, entries, removable);
+    }
+
+    // Keep going until nothing changes. Some sequences only show up
+    // after others have been replaced.
+    while (peephole) {
+        InstrList out;
+        bool changed = this->peephole(list, out);
+        list.swap(out);
+        if (!changed) {
+            break;
+        }
+    }
+    if (peephole) {
+        reduceIndexes(list);
+    }
+
+    // Assign new addresses. Making an instruction wide moves the ones
+    // after it, which can put others out of reach, so keep going until
+    // nothing changes. Instructions only get wider so this ends.
+    uint16_t addr;
+    while (true) {
+        _oldAddrs.clear();
+        _newAddrs.clear();
+        addr = 0;
+        for (const auto& it : list) {
+            _oldAddrs.push_back(it.addr);
+            _newAddrs.push_back(addr);
+            addr += size(it);
+        }
+        _oldAddrs.push_back(_code.size());
+        _newAddrs.push_back(addr);
+        
+        bool widened = false;
+        for (size_t i = 0; i < list.size(); ++i) {
+            Instr& instr = list[i];
+            if (instr.targ != NoTarg && !instr.wide && !fits(instr, _newAddrs[i], map(instr.targ))) {
+                instr.wide = true;
+                widened = true;
+            }
+        }
+        if (!widened) {
+            break;
+        }
+    }
+
+    // Emit the new code
+    std::vector<uint8_t> code;
+    code.reserve(addr);
+
+    for (const auto& it : list) {
+        if (it.targ == NoTarg) {
+            code.push_back(uint8_t(it.op) | it.index);
+            code.insert(code.end(), it.operands.begin(), it.operands.end());
+            continue;
+        }
+
+        uint16_t targ = map(it.targ);
+        uint16_t next = code.size() + 2;
+
+        if (it.wide) {
+            uint16_t rel = targ - (code.size() + 3);
+            switch(it.op) {
+                case Op::Call:
+                    code.push_back(uint8_t(Op::Long) | uint8_t(LongOp::Call));
+                    code.push_back(uint8_t(targ));
+                    code.push_back(uint8_t(targ >> 8));
+                    break;
+                case Op::If:
+                case Op::Jump:
+                    code.push_back(uint8_t(Op::Long) | uint8_t((it.op == Op::If) ? LongOp::If : LongOp::Jump));
+                    code.push_back(uint8_t(rel));
+                    code.push_back(uint8_t(rel >> 8));
+                    break;
+                case Op::IncLoopLTInt:
+                case Op::IncLoopLTIntConst: {
+                    // Split back into the increment and a compare and
+                    // LongIf back to the body
+                    uint8_t sid = it.operands[0];
+                    code.push_back(uint8_t(Op::PushIntConstS) | 1);
+                    code.push_back(uint8_t(Op::AddToVar));
+                    code.push_back(sid);
+                    if (it.op == Op::IncLoopLTInt) {
+                        code.push_back(uint8_t(Op::Push2));
+                        code.push_back(sid);
+                        code.push_back(it.operands[1]);
+                    } else {
+                        uint16_t id = idFromSid(sid);
+                        code.push_back(uint8_t(Op::Push) | uint8_t(id >> 8));
+                        code.push_back(uint8_t(id));
+                        code.push_back(uint8_t(Op::PushIntConst));
+                        code.push_back(it.operands[1]);
+                    }
+                    code.push_back(uint8_t(Op::GEInt));
+                    code.push_back(uint8_t(Op::Long) | uint8_t(LongOp::If));
+                    rel = targ - (code.size() + 2);
+                    code.push_back(uint8_t(rel));
+                    code.push_back(uint8_t(rel >> 8));
+                    break;
+                }
+                default:
+                    // Fused if, split back into the compare and an If
+                    code.push_back(uint8_t(compareFromFusedIf(it.op)));
+                    rel = targ - (code.size() + 2);
+                    code.push_back(uint8_t(Op::If) | ((rel >> 8) & 0x0f));
+                    code.push_back(uint8_t(rel));
+                    break;
+            }
+            continue;
+        }
+
+        switch(it.op) {
+            case Op::Call:
+                code.push_back(uint8_t(it.op) | ((targ >> 8) & 0x0f));
+                code.push_back(uint8_t(targ));
+                break;
+            case Op::If:
+            case Op::Jump: {
+                uint16_t rel = targ - next;
+                code.push_back(uint8_t(it.op) | ((rel >> 8) & 0x0f));
+                code.push_back(uint8_t(rel));
+                break;
+            }
+            case Op::IncLoopLTInt:
+            case Op::IncLoopLTIntConst:
+                // Always back, from the end of the instruction
+                code.push_back(uint8_t(it.op));
+                code.insert(code.end(), it.operands.begin(), it.operands.end());
+                code.push_back(uint8_t(code.size() + 1 - targ));
+                break;
+            default:
+                // Fused if, always forward
+                code.push_back(uint8_t(it.op));
+                code.push_back(uint8_t(targ - next));
+                break;
+        }
+    }
+
+    _code.swap(code);
+    return true;
+}
+
+uint16_t
+Optimizer::map(uint16_t addr) const
+{
+    if (_oldAddrs.empty()) {
+        return addr;
+    }
+
+    // Find the last instruction starting at or before addr. Instructions
+    // added by reduceIndexes() have the address of one next to them, so
+    // go back to the first one with that address.
+    auto it = std::upper_bound(_oldAddrs.begin(), _oldAddrs.end(), addr);
+    if (it != _oldAddrs.begin()) {
+        --it;
+        it = std::lower_bound(_oldAddrs.begin(), it, *it);
+    }
+    return _newAddrs[it - _oldAddrs.begin()];
+}
+
+bool
+Optimizer::removed(uint16_t addr) const
+{
+    for (const auto& it : _removed) {
+        if (addr >= it.first && addr < it.second) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+Optimizer::removeUnused(InstrList& list, const std::vector<uint16_t>& entries, const std::vector<uint16_t>& removable)
+{
+    // Each entry starts a function, which goes to the next one
+    std::vector<uint16_t> starts = entries;
+    std::sort(starts.begin(), starts.end());
+    starts.erase(std::unique(starts.begin(), starts.end()), starts.end());
+    
+    auto function = [&starts](int32_t addr) -> int32_t
+    {
+        return int32_t(std::upper_bound(starts.begin(), starts.end(), addr) - starts.begin()) - 1;
+    };
+    
+    // Follow the calls from every function which has to stay
+    std::vector<bool> used(starts.size(), false);
+    std::vector<int32_t> todo;
+    for (size_t f = 0; f < starts.size(); ++f) {
+        if (std::find(removable.begin(), removable.end(), starts[f]) == removable.end()) {
+            used[f] = true;
+            todo.push_back(int32_t(f));
+        }
+    }
+    
+    while (!todo.empty()) {
+        int32_t f = todo.back();
+        todo.pop_back();
+        for (const auto& it : list) {
+            if (it.op == Op::Call && function(it.addr) == f) {
+                int32_t g = function(it.targ);
+                if (g >= 0 && !used[g]) {
+                    used[g] = true;
+                    todo.push_back(g);
+                }
+            }
+        }
+    }
+    
+    InstrList out;
+    for (const auto& it : list) {
+        int32_t f = function(it.addr);
+        if (f < 0 || used[f]) {
+            out.push_back(it);
+        }
+    }
+    for (size_t f = 0; f < starts.size(); ++f) {
+        if (!used[f]) {
+            _removed.emplace_back(starts[f], (f + 1 < starts.size()) ? starts[f + 1] : uint16_t(_code.size()));
+        }
+    }
+    list.swap(out);
+}
+
+bool
+Optimizer::parse(InstrList& list)
+{
+    for (size_t pc = 0; pc < _code.size(); ) {
+        Instr instr;
+        instr.addr = pc;
+        bool bwdTarg = false;
+
+        uint8_t opInt = _code[pc++];
+        if (opInt >= ExtOpcodeStart) {
+            instr.index = opInt & 0x0f;
+            opInt &= 0xf0;
+        }
+
+        OpData opData;
+        if (!CompileEngine::opDataFromOp(Op(opInt), opData)) {
+            return false;
+        }
+        instr.op = opData._op;
+
+        uint16_t numOperands = 0;
+
+        switch(opData._par) {
+            case OpParams::None:
+            case OpParams::Index:
+                break;
+            case OpParams::Id:
+            case OpParams::I:
+            case OpParams::Const:
+            case OpParams::P_L:
+            case OpParams::Sid:
+            case OpParams::SConst:
+                numOperands = 1;
+                break;
+            case OpParams::Sid_Sid:
+            case OpParams::Sid_Const:
+                numOperands = 2;
+                break;
+            case OpParams::Sid_Sid_BwdTarg:
+            case OpParams::Sid_Const_BwdTarg:
+                numOperands = 2;
+                bwdTarg = true;
+                break;
+            case OpParams::Idx_Len_S:
+                if (pc >= _code.size()) {
+                    return false;
+                }
+                numOperands = 1 + _code[pc];
+                break;
+            case OpParams::LongTarg: {
+                // Laid out again like the short op
+                if (pc + 1 >= _code.size()) {
+                    return false;
+                }
+                uint16_t targ = uint16_t(_code[pc]) | (uint16_t(_code[pc + 1]) << 8);
+                pc += 2;
+                switch(LongOp(instr.index)) {
+                    case LongOp::Jump: instr.op = Op::Jump; break;
+                    case LongOp::If: instr.op = Op::If; break;
+                    case LongOp::Call: instr.op = Op::Call; break;
+                    default: return false;
+                }
+                instr.targ = (instr.op == Op::Call) ? int32_t(targ) : int32_t(pc) + int16_t(targ);
+                instr.index = 0;
+                break;
+            }
+            case OpParams::AbsTarg:
+            case OpParams::RelTarg:
+            case OpParams::FwdTarg: {
+                if (pc >= _code.size()) {
+                    return false;
+                }
+                uint16_t targ = (uint16_t(instr.index) << 8) | _code[pc++];
+                auto longTarg = _longTargs.find(instr.addr);
+                if (longTarg != _longTargs.end()) {
+                    instr.targ = longTarg->second;
+                } else if (opData._par == OpParams::RelTarg) {
+                    int16_t rel = (targ & 0x800) ? int16_t(targ | 0xf000) : int16_t(targ);
+                    instr.targ = int32_t(pc) + rel;
+                } else if (opData._par == OpParams::FwdTarg) {
+                    instr.targ = int32_t(pc) + targ;
+                } else {
+                    instr.targ = targ;
+                }
+                instr.index = 0;
+                break;
+            }
+        }
+
+        if (pc + numOperands > _code.size()) {
+            return false;
+        }
+        instr.operands.assign(_code.begin() + pc, _code.begin() + pc + numOperands);
+        pc += numOperands;
+        
+        // The target of the loop ops comes after the operands
+        if (bwdTarg) {
+            if (pc >= _code.size()) {
+                return false;
+            }
+            instr.targ = int32_t(pc) + 1 - _code[pc];
+            pc++;
+        }
+        list.push_back(instr);
+    }
+    return true;
+}
+
+uint16_t
+Optimizer::size(const Instr& instr) const
+{
+    if (instr.wide && isLoop(instr.op)) {
+        // PushIntConstS 1; AddToVar; Push2 or Push and PushIntConst; GEInt; LongIf
+        return (instr.op == Op::IncLoopLTInt) ? 10 : 11;
+    }
+    return 1 + instr.operands.size() + ((instr.targ == NoTarg) ? 0 : (instr.wide ? 2 : 1));
+}
+
+bool
+Optimizer::fits(const Instr& instr, uint16_t addr, uint16_t targ)
+{
+    int32_t rel = int32_t(targ) - (int32_t(addr) + 2);
+    switch(instr.op) {
+        case Op::Call: return targ < MaxShortCallTarg;
+        case Op::If:
+        case Op::Jump: return rel >= -2048 && rel <= 2047;
+        case Op::IncLoopLTInt:
+        case Op::IncLoopLTIntConst: return rel <= 2 && rel >= 2 - 255; // Back from addr + 4
+        default: return rel >= 0 && rel <= 255;
+    }
+}
+
+bool
+Optimizer::stackEffect(const Instr& instr, uint8_t& pops, uint8_t& pushes)
+{
+    switch(instr.op) {
+        case Op::Push:
+        case Op::PushRef:
+        case Op::PushIntConst:
+        case Op::PushIntConstS:
+            pops = 0; pushes = 1; return true;
+        case Op::Push2:
+            pops = 0; pushes = 2; return true;
+        case Op::StoreIntConst:
+            pops = 0; pushes = 0; return true;
+        case Op::Pop:
+        case Op::Drop:
+        case Op::AddToVar:
+            pops = 1; pushes = 0; return true;
+        case Op::PopDeref:
+            pops = 2; pushes = 0; return true;
+        case Op::Dup:
+            pops = 1; pushes = 2; return true;
+        case Op::Swap:
+            pops = 2; pushes = 2; return true;
+
+        case Op::PushDeref:
+        case Op::Offset:
+        case Op::Not:
+        case Op::LNot:
+        case Op::NegInt:
+        case Op::NegFloat:
+        case Op::AddIntConst:
+        case Op::PreIncInt:
+        case Op::PreIncFloat:
+        case Op::PreDecInt:
+        case Op::PreDecFloat:
+        case Op::PostIncInt:
+        case Op::PostIncFloat:
+        case Op::PostDecInt:
+        case Op::PostDecFloat:
+        case Op::PreIncFixed:
+        case Op::PreDecFixed:
+        case Op::PostIncFixed:
+        case Op::PostDecFixed:
+            pops = 1; pushes = 1; return true;
+
+        case Op::Index:
+        case Op::Or:
+        case Op::Xor:
+        case Op::And:
+        case Op::LOr:
+        case Op::LAnd:
+        case Op::LTInt:
+        case Op::LTFloat:
+        case Op::LEInt:
+        case Op::LEFloat:
+        case Op::EQInt:
+        case Op::EQFloat:
+        case Op::NEInt:
+        case Op::NEFloat:
+        case Op::GEInt:
+        case Op::GEFloat:
+        case Op::GTInt:
+        case Op::GTFloat:
+        case Op::AddInt:
+        case Op::AddFloat:
+        case Op::SubInt:
+        case Op::SubFloat:
+        case Op::MulInt:
+        case Op::MulFloat:
+        case Op::DivInt:
+        case Op::DivFloat:
+        case Op::MulFixed:
+        case Op::DivFixed:
+            pops = 2; pushes = 1; return true;
+
+        default:
+            // Control flow, calls and Log end a straight line sequence
+            return false;
+    }
+}
+
+int32_t
+Optimizer::findExprEnd(const InstrList& list, size_t i, Op op)
+{
+    uint8_t depth = 0;
+
+    for ( ; i < list.size(); ++i) {
+        const Instr& instr = list[i];
+        if (instr.label) {
+            return -1;
+        }
+        if (instr.op == op && depth == 1) {
+            return int32_t(i);
+        }
+
+        uint8_t pops, pushes;
+        if (!stackEffect(instr, pops, pushes) || pops > depth) {
+            return -1;
+        }
+        depth = depth - pops + pushes;
+    }
+    return -1;
+}
+
+bool
+Optimizer::sidFromInstr(const Instr& instr, uint8_t& sid)
+{
+    uint16_t id = idFromInstr(instr);
+    if (id < GlobalStart) {
+        return false;
+    }
+    if (id < LocalStart) {
+        if (id - GlobalStart >= SidSize) {
+            return false;
+        }
+        sid = id - GlobalStart;
+    } else {
+        if (id - LocalStart >= SidSize) {
+            return false;
+        }
+        sid = SidLocalStart + (id - LocalStart);
+    }
+    return true;
+}
+
+bool
+Optimizer::intConst(const Instr& instr, uint32_t& value)
+{
+    if (instr.op == Op::PushIntConstS) {
+        value = instr.index;
+        return true;
+    }
+    if (instr.op == Op::PushIntConst) {
+        value = instr.operands[0];
+        return true;
+    }
+    return false;
+}
+
+Optimizer::Instr
+Optimizer::idInstr(Op op, uint16_t id, const Instr& from)
+{
+    Instr instr;
+    instr.op = op;
+    instr.index = uint8_t(id >> 8);
+    instr.operands = { uint8_t(id) };
+    instr.addr = from.addr;
+    return instr;
+}
+
+bool
+Optimizer::mayWrite(const InstrList& list, size_t from, size_t to, uint8_t sid)
+{
+    for (size_t j = from; j < to; ++j) {
+        const Instr& instr = list[j];
+        if (storesTo(instr, sid) || (instr.op == Op::PushRef && idFromInstr(instr) == idFromSid(sid))) {
+            return true;
+        }
+        
+        // A pointer could point at the variable. An increment of a ref
+        // pushed just before it is safe, the check above caught it if the
+        // ref was to the variable
+        switch(instr.op) {
+            case Op::PreIncInt:
+            case Op::PreIncFloat:
+            case Op::PreDecInt:
+            case Op::PreDecFloat:
+            case Op::PostIncInt:
+            case Op::PostIncFloat:
+            case Op::PostDecInt:
+            case Op::PostDecFloat:
+            case Op::PreIncFixed:
+            case Op::PreDecFixed:
+            case Op::PostIncFixed:
+            case Op::PostDecFixed:
+                if (j > from && list[j - 1].op == Op::PushRef) {
+                    break;
+                }
+                return true;
+            case Op::PopDeref:
+                return true;
+            default:
+                break;
+        }
+    }
+    return false;
+}
+
+bool
+Optimizer::storesTo(const Instr& instr, uint8_t sid)
+{
+    switch(instr.op) {
+        case Op::Pop:
+            return idFromInstr(instr) == idFromSid(sid);
+        case Op::StoreIntConst:
+        case Op::AddToVar:
+        case Op::IncLoopLTInt:
+        case Op::IncLoopLTIntConst:
+            return instr.operands[0] == sid;
+        default:
+            return false;
+    }
+}
+
+static Op fusedIf(Op op)
+{
+    switch(op) {
+        case Op::LTInt: return Op::IfLTInt;
+        case Op::LEInt: return Op::IfLEInt;
+        case Op::EQInt: return Op::IfEQInt;
+        case Op::NEInt: return Op::IfNEInt;
+        case Op::GEInt: return Op::IfGEInt;
+        case Op::GTInt: return Op::IfGTInt;
+        default: return Op::None;
+    }
+}
+
+bool
+Optimizer::peephole(const InstrList& in, InstrList& out)
+{
+    bool changed = false;
+
+    // When the first instruction of a sequence is removed, the next one
+    // output takes over its address and label so jumps to it still work.
+    int32_t pendingAddr = -1;
+    bool pendingLabel = false;
+
+    auto emit = [&](Instr instr)
+    {
+        if (pendingAddr >= 0) {
+            instr.addr = pendingAddr;
+            instr.label |= pendingLabel;
+            pendingAddr = -1;
+            pendingLabel = false;
+        }
+        out.push_back(instr);
+    };
+
+    auto remove = [&](const Instr& instr)
+    {
+        if (pendingAddr < 0) {
+            pendingAddr = instr.addr;
+        }
+        pendingLabel |= instr.label;
+        changed = true;
+    };
+
+    auto fused = [](Op op, const Instr& from, std::vector<uint8_t> operands)
+    {
+        Instr instr;
+        instr.op = op;
+        instr.operands = operands;
+        instr.addr = from.addr;
+        instr.label = from.label;
+        return instr;
+    };
+
+    // True if none of the n instructions starting at i are labels
+    auto straight = [&in](size_t i, size_t n)
+    {
+        if (i + n > in.size()) {
+            return false;
+        }
+        for (size_t j = i; j < i + n; ++j) {
+            if (in[j].label) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    for (size_t i = 0; i < in.size(); ) {
+        const Instr& instr = in[i];
+        uint8_t sid, sid2;
+        uint32_t value;
+
+        if (instr.op == Op::PushRef && sidFromInstr(instr, sid)) {
+            // PushRef x; Dup; PushDeref; <expr>; AddInt; PopDeref
+            if (straight(i + 1, 2) && in[i + 1].op == Op::Dup && in[i + 2].op == Op::PushDeref) {
+                int32_t end = findExprEnd(in, i + 3, Op::AddInt);
+                if (end >= 0 && straight(end + 1, 1) && in[end + 1].op == Op::PopDeref &&
+                        !mayWrite(in, i + 3, end, sid)) {
+                    remove(instr);
+                    for (int32_t j = i + 3; j < end; ++j) {
+                        emit(in[j]);
+                    }
+                    emit(fused(Op::AddToVar, in[end], { sid }));
+                    i = end + 2;
+                    continue;
+                }
+            }
+
+            // PushRef x; PreIncInt or PostIncInt; Drop
+            if (straight(i + 1, 2) && (in[i + 1].op == Op::PreIncInt || in[i + 1].op == Op::PostIncInt) &&
+                    in[i + 2].op == Op::Drop) {
+                Instr one = fused(Op::PushIntConstS, instr, { });
+                one.index = 1;
+                emit(one);
+                emit(fused(Op::AddToVar, in[i + 1], { sid }));
+                changed = true;
+                i += 3;
+                continue;
+            }
+        }
+
+        if (instr.op == Op::PushRef && ((uint16_t(instr.index) << 8) | instr.operands[0]) >= GlobalStart) {
+            // PushRef x; <expr>; PopDeref
+            int32_t end = findExprEnd(in, i + 1, Op::PopDeref);
+            if (end >= 0) {
+                remove(instr);
+                for (int32_t j = i + 1; j < end; ++j) {
+                    emit(in[j]);
+                }
+                Instr pop = fused(Op::Pop, in[end], instr.operands);
+                pop.index = instr.index;
+                emit(pop);
+                i = end + 1;
+                continue;
+            }
+        }
+
+        // PushIntConstS 1; AddToVar i; Jump top, where top is Push2 i n;
+        // IfLTInt end (or Push i; PushIntConst c; IfLTInt end) with the
+        // body right after it and end right after the Jump. The body has
+        // to be in reach of the one byte target.
+        if (instr.op == Op::PushIntConstS && instr.index == 1 && straight(i + 1, 2) &&
+                in[i + 1].op == Op::AddToVar && in[i + 2].op == Op::Jump && i + 3 < in.size()) {
+            sid = in[i + 1].operands[0];
+            auto top = std::lower_bound(in.begin(), in.end(), in[i + 2].targ,
+                        [](const Instr& instr, int32_t a) { return instr.addr < a; });
+            size_t t = top - in.begin();
+            Op loopOp = Op::None;
+            uint8_t limit = 0;
+            size_t body = 0;
+            
+            if (t < i && top->addr == in[i + 2].targ) {
+                if (top->op == Op::Push2 && top->operands[0] == sid && in[t + 1].op == Op::IfLTInt) {
+                    loopOp = Op::IncLoopLTInt;
+                    limit = top->operands[1];
+                    body = t + 2;
+                } else if (top->op == Op::Push && sidFromInstr(*top, sid2) && sid2 == sid &&
+                        intConst(in[t + 1], value) && value <= 255 && in[t + 2].op == Op::IfLTInt) {
+                    loopOp = Op::IncLoopLTIntConst;
+                    limit = uint8_t(value);
+                    body = t + 3;
+                }
+            }
+            
+            if (loopOp != Op::None && in[body - 1].targ == in[i + 3].addr &&
+                    body <= i && int32_t(instr.addr) + 4 - in[body].addr <= 255) {
+                Instr loop = fused(loopOp, instr, { sid, limit });
+                loop.targ = in[body].addr;
+                
+                // The body is already in out unless it's this instruction
+                if (body == i) {
+                    loop.label = true;
+                } else {
+                    auto it = std::lower_bound(out.begin(), out.end(), in[body].addr,
+                                [](const Instr& instr, int32_t a) { return instr.addr < a; });
+                    if (it != out.end() && it->addr == in[body].addr) {
+                        it->label = true;
+                    }
+                }
+                emit(loop);
+                changed = true;
+                i += 3;
+                continue;
+            }
+        }
+
+        if (intConst(instr, value) && straight(i + 1, 1)) {
+            const Instr& next = in[i + 1];
+
+            // PushIntConst c; Pop x
+            if (next.op == Op::Pop && sidFromInstr(next, sid)) {
+                emit(fused(Op::StoreIntConst, instr, { sid, uint8_t(value) }));
+                changed = true;
+                i += 2;
+                continue;
+            }
+
+            // PushIntConst c; AddInt or SubInt
+            if ((next.op == Op::AddInt && value <= 127) || (next.op == Op::SubInt && value <= 128)) {
+                int8_t c = (next.op == Op::AddInt) ? int8_t(value) : int8_t(-int32_t(value));
+                emit(fused(Op::AddIntConst, instr, { uint8_t(c) }));
+                changed = true;
+                i += 2;
+                continue;
+            }
+        }
+
+        // Push x; Push y
+        if (instr.op == Op::Push && straight(i + 1, 1) && in[i + 1].op == Op::Push &&
+                sidFromInstr(instr, sid) && sidFromInstr(in[i + 1], sid2)) {
+            emit(fused(Op::Push2, instr, { sid, sid2 }));
+            changed = true;
+            i += 2;
+            continue;
+        }
+
+        // <compare>; If targ. The fused if only jumps forward 255 bytes.
+        // That's measured from the fused instruction, which is where the
+        // compare is now. If long ops after it put the target out of
+        // reach it's split up again when the code is laid out.
+        if (fusedIf(instr.op) != Op::None && straight(i + 1, 1) && in[i + 1].op == Op::If) {
+            int32_t offset = in[i + 1].targ - (int32_t(instr.addr) + 2);
+            if (offset >= 0 && offset <= 255) {
+                Instr instrIf = fused(fusedIf(instr.op), instr, { });
+                instrIf.targ = in[i + 1].targ;
+                emit(instrIf);
+                changed = true;
+                i += 2;
+                continue;
+            }
+        }
+
+        // Dup; Drop or <push>; Drop. There must be an instruction after
+        // these to take over their address.
+        if ((instr.op == Op::Dup || instr.op == Op::Push || instr.op == Op::PushRef ||
+                instr.op == Op::PushIntConst || instr.op == Op::PushIntConstS) &&
+                straight(i + 1, 1) && in[i + 1].op == Op::Drop && i + 2 < in.size()) {
+            remove(instr);
+            i += 2;
+            continue;
+        }
+
+        emit(instr);
+        ++i;
+    }
+
+    return changed;
+}
+
+void
+Optimizer::reduceIndexes(InstrList& list)
+{
+    auto find = [&list](int32_t addr) -> size_t
+    {
+        auto it = std::lower_bound(list.begin(), list.end(), addr,
+                    [](const Instr& instr, int32_t a) { return instr.addr < a; });
+        return it - list.begin();
+    };
+    
+    for (size_t e = 0; e < list.size(); ++e) {
+        if (!isLoop(list[e].op) || list[e].operands[0] < SidLocalStart) {
+            continue;
+        }
+        
+        uint8_t sid = list[e].operands[0];
+        uint16_t index = idFromSid(sid);
+        size_t b = find(list[e].targ);
+        if (b == 0 || b >= e || e + 1 >= list.size() || list[b].addr != list[e].targ ||
+                list[b - 1].op != Op::IfLTInt || list[b - 1].targ != list[e + 1].addr) {
+            continue;
+        }
+        
+        // Each ref needs a new local from the function's frame
+        size_t frame = b;
+        while (frame > 0 && list[frame].op != Op::SetFrame) {
+            --frame;
+        }
+        if (list[frame].op != Op::SetFrame) {
+            continue;
+        }
+        
+        // The body can only be entered at the top and the index can only
+        // be changed by the loop op. A ref to it anywhere in the function
+        // could change it too.
+        bool ok = true;
+        for (size_t j = 0; j < list.size() && ok; ++j) {
+            const Instr& instr = list[j];
+            if ((j < b || j > e) && instr.targ >= list[b].addr && instr.targ <= list[e].addr) {
+                ok = false;
+            }
+            if (j >= b && j < e && storesTo(instr, sid)) {
+                ok = false;
+            }
+        }
+        for (size_t j = frame + 1; j < list.size() && list[j].op != Op::SetFrame && ok; ++j) {
+            if (list[j].op == Op::PushRef && idFromInstr(list[j]) == index) {
+                ok = false;
+            }
+        }
+        if (!ok) {
+            continue;
+        }
+        
+        // Find the PushRef a; Push i; Index n triples, by a and n
+        std::vector<std::pair<uint32_t, uint8_t>> triples;
+        for (size_t j = b; j + 2 < e; ++j) {
+            if (list[j].op == Op::PushRef && idFromInstr(list[j]) >= GlobalStart &&
+                    list[j + 1].op == Op::Push && idFromInstr(list[j + 1]) == index &&
+                    list[j + 2].op == Op::Index && !list[j + 1].label && !list[j + 2].label) {
+                uint32_t key = (uint32_t(idFromInstr(list[j])) << 8) | list[j + 2].index;
+                auto it = std::find_if(triples.begin(), triples.end(),
+                            [key](const std::pair<uint32_t, uint8_t>& t) { return t.first == key; });
+                if (it == triples.end()) {
+                    triples.emplace_back(key, 1);
+                } else if (it->second < 2) {
+                    it->second++;
+                }
+            }
+        }
+        
+        for (const auto& triple : triples) {
+            Instr& setFrame = list[frame];
+            uint16_t slot = uint16_t(setFrame.index) + setFrame.operands[0];
+            if (triple.second < 2 || slot >= SidSize || setFrame.operands[0] == 0xff) {
+                continue;
+            }
+            setFrame.operands[0]++;
+            
+            uint16_t ref = uint16_t(triple.first >> 8);
+            uint8_t size = uint8_t(triple.first);
+            uint16_t p = LocalStart + slot;
+
+            // Replace the uses, from the end so the indexes stay good
+            for (size_t j = e - 2; j-- > b; ) {
+                if (list[j].op == Op::PushRef && idFromInstr(list[j]) == ref &&
+                        list[j + 1].op == Op::Push && idFromInstr(list[j + 1]) == index &&
+                        list[j + 2].op == Op::Index && list[j + 2].index == size &&
+                        !list[j + 1].label && !list[j + 2].label) {
+                    Instr push = idInstr(Op::Push, p, list[j]);
+                    push.label = list[j].label;
+                    list[j] = push;
+                    list.erase(list.begin() + j + 1, list.begin() + j + 3);
+                    e -= 2;
+                }
+            }
+            
+            // Bump it before the loop op. The bump takes its address and
+            // label, so map() and jumps to the loop op go to the bump.
+            uint8_t psid = SidLocalStart + uint8_t(slot);
+            Instr bump = list[e];
+            bump.op = Op::PushIntConstS;
+            bump.index = size;
+            bump.operands.clear();
+            bump.targ = NoTarg;
+            Instr add = bump;
+            add.op = Op::AddToVar;
+            add.index = 0;
+            add.operands = { psid };
+            add.label = false;
+            list[e].label = false;
+            list.insert(list.begin() + e, { bump, add });
+            e += 2;
+            
+            // And set it before the body
+            const Instr& before = list[b - 1];
+            Instr indexOp = idInstr(Op::Index, 0, before);
+            indexOp.index = size;
+            indexOp.operands.clear();
+            list.insert(list.begin() + b, { idInstr(Op::PushRef, ref, before), idInstr(Op::Push, index, before),
+                                            indexOp, idInstr(Op::Pop, p, before) });
+            b += 4;
+            e += 4;
+        }
+    }
+}
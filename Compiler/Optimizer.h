@@ -0,0 +1,149 @@
+/*-------------------------------------------------------------------------
+    This source file is a part of Clover
+    For the latest info, see https://github.com/cmarrin/Clover
+    Copyright (c) 2021-2022, Chris Marrin
+    All rights reserved.
+    Use of this source code is governed by the MIT license that can be
+    found in the LICENSE file.
+-------------------------------------------------------------------------*/
+
+// Peephole optimizer
+//
+// Runs over the generated code before it is emitted and replaces common
+// sequences with shorter ones, mostly using the fused opcodes:
+//
+//      PushRef x; <expr>; PopDeref                 -> <expr>; Pop x
+//      PushIntConst c; Pop x                       -> StoreIntConst x c
+//      PushRef x; Dup; PushDeref; <expr>;
+//          AddInt; PopDeref                        -> <expr>; AddToVar x
+//      PushRef x; PreIncInt/PostIncInt; Drop       -> PushIntConstS 1; AddToVar x
+//      PushIntConst c; AddInt (or SubInt)          -> AddIntConst c (or -c)
+//      Push x; Push y                              -> Push2 x y
+//      LTInt (etc.); If targ                       -> IfLTInt targ
+//      Dup; Drop and <push>; Drop                  -> removed
+//      PushIntConstS 1; AddToVar i; Jump top       -> IncLoopLTInt i n body
+//          where top is Push2 i n; IfLTInt end,
+//          body follows it and end follows the Jump
+//      (the same with Push i; PushIntConst c at top -> IncLoopLTIntConst i c body)
+//
+// <expr> is a straight line sequence which leaves one value on the
+// stack and doesn't touch anything below it. No sequence is combined
+// across a jump target, so the jumps fixed up by exitJumpContext are
+// just moved to their new addresses.
+//
+// The last is a counted for or while loop. The test stays at the top
+// for the first time through and the IncLoop op does the increment and
+// test at the bottom after that, jumping back to the first instruction
+// of the body.
+//
+// Then indexes in those loops are strength reduced. If the body has
+// PushRef a; Push i; Index n more than once for the same array a and
+// size n, and i is a local nothing in the body changes, the element ref
+// is kept in a new local p. It is set to the ref of a[i] before the body
+// and bumped by n before the IncLoop, and each PushRef a; Push i; Index n
+// becomes Push p. The added instructions have the address of the one
+// before them (for the ref) or after them (for the bump), so map() goes
+// to the first instruction with an address.
+//
+// Then the code is laid out. Every Jump, If and Call starts out short and
+// the ones which can't reach their target are made wide: the Long op, or
+// for a fused if the compare and If it came from. That moves the code
+// after it, so this repeats until everything fits. Code that fits in the
+// short ops comes out the same as if there were no long ops.
+//
+
+#pragma once
+
+#include "Opcodes.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace clvr {
+
+class Optimizer
+{
+public:
+    // code is the instruction area (not including the header) and all
+    // addresses are relative to its start. longTargs are the targets of
+    // Jump and If ops in code which were too far for a relTarg, by the
+    // address of the op (see CompileEngine::setJumpTarg()).
+    Optimizer(std::vector<uint8_t>& code, const std::unordered_map<uint16_t, uint16_t>& longTargs)
+        : _code(code)
+        , _longTargs(longTargs)
+    { }
+
+    // entries are addresses entered from outside the code, like function
+    // and command starts. If peephole is false the code is only laid out.
+    // removable are entries of functions which are left out if they can't
+    // be reached by calls from the other entries. Returns false and leaves
+    // the code untouched if it can't be parsed.
+    bool optimize(const std::vector<uint16_t>& entries, bool peephole = true,
+                  const std::vector<uint16_t>& removable = { });
+
+    // Returns the new address of an instruction given its address before
+    // optimization.
+    uint16_t map(uint16_t addr) const;
+    
+    // True if the instruction at addr before optimization was in a
+    // function which was left out
+    bool removed(uint16_t addr) const;
+
+private:
+    static constexpr int32_t NoTarg = -1;
+
+    struct Instr
+    {
+        Op op = Op::None;
+        uint8_t index = 0;              // Lower 4 bits of an ext opcode
+        std::vector<uint8_t> operands;  // Bytes after the opcode, except targets
+        int32_t targ = NoTarg;          // Original address of jump or call target
+        uint16_t addr = 0;              // Original address
+        bool label = false;             // Target of a jump, call or entry
+        bool wide = false;              // Target is too far for the short op
+    };
+
+    using InstrList = std::vector<Instr>;
+
+    bool parse(InstrList&);
+    void removeUnused(InstrList&, const std::vector<uint16_t>& entries, const std::vector<uint16_t>& removable);
+    bool peephole(const InstrList& in, InstrList& out);
+    void reduceIndexes(InstrList&);
+    uint16_t size(const Instr&) const;
+    
+    // Returns true if the short form of instr at addr reaches targ
+    static bool fits(const Instr&, uint16_t addr, uint16_t targ);
+
+    // Returns true and the number of pops and pushes if the op can appear
+    // in a straight line expression
+    static bool stackEffect(const Instr&, uint8_t& pops, uint8_t& pushes);
+
+    // Returns the index of the instruction ending a straight line expression
+    // that starts at i with an empty stack. It is the first instruction with
+    // op which is found when there is exactly 1 value on the stack. Returns
+    // -1 if there is none before the next label.
+    static int32_t findExprEnd(const InstrList&, size_t i, Op op);
+
+    static bool sidFromInstr(const Instr&, uint8_t& sid);
+    static bool intConst(const Instr&, uint32_t& value);
+    static uint16_t idFromInstr(const Instr& instr) { return (uint16_t(instr.index) << 8) | instr.operands[0]; }
+    static Instr idInstr(Op, uint16_t id, const Instr& from);
+    static bool isLoop(Op op) { return op == Op::IncLoopLTInt || op == Op::IncLoopLTIntConst; }
+    
+    // True if instr stores into the variable with sid
+    static bool storesTo(const Instr&, uint8_t sid);
+    
+    // True if the instructions from from up to to might change the
+    // variable with sid, by storing to it, taking its ref or storing
+    // through a ref that might be to it
+    static bool mayWrite(const InstrList&, size_t from, size_t to, uint8_t sid);
+
+    std::vector<uint8_t>& _code;
+    const std::unordered_map<uint16_t, uint16_t>& _longTargs;
+    std::vector<uint16_t> _oldAddrs;
+    std::vector<uint16_t> _newAddrs;
+    std::vector<std::pair<uint16_t, uint16_t>> _removed; // Start and end addrs
+};
+
+}
@@ -87,22 +87,28 @@ Token Scanner::scanString(char terminal)
 	return Token::String;
 }
 
-Token Scanner::scanIdentifier()
+Token Scanner::scanIdentifier(TokenType& tokenValue)
 {
 	uint8_t c;
-	_tokenString.clear();
-
+ 
+    // The identifier is a span of the source. A putback char is always
+    // the one before _cur
+    const char* start = _cur - ((_lastChar != C_EOF) ? 1 : 0);
+    const char* end = start;
+    
 	bool first = true;
 	while ((c = get()) != C_EOF) {
 		if (!((first && isIdFirst(c)) || (!first && isIdOther(c)))) {
 			putback(c);
 			break;
 		}
-		_tokenString += c;
+		end++;
 		first = false;
 	}
-    size_t len = _tokenString.size();
-    return len ? Token::Identifier : Token::EndOfFile;
+ 
+    tokenValue.str = start;
+    tokenValue.length = uint32_t(end - start);
+    return tokenValue.length ? Token::Identifier : Token::EndOfFile;
 }
 
 // Return the number of digits scanned
@@ -271,7 +277,12 @@ Token Scanner::scanComment()
 	}
 
     _tokenString.clear();
-    _tokenString += c;
+    _tokenString += '/';
+    if (c == '=') {
+        _tokenString += c;
+        return Token::DivSto;
+    }
+    putback(c);
 	return Token('/');
 }
 
@@ -322,23 +333,26 @@ uint8_t Scanner::get() const
         _lastChar = C_EOF;
         return c;
     }
-    int result = _stream->get();
-    _charno++;
-    
-    if (_stream->eof() || result < 0 || result > 0xff || result == EOF) {
+    if (_cur >= _end) {
+        // Finish the last line if it didn't end in a newline
+        if (_annotations && _lineStart < _end) {
+            _annotations->back().second.assign(_lineStart, _end);
+            _lineStart = _end;
+        }
         return C_EOF;
     }
-    uint8_t c = static_cast<uint8_t>(result);
-    if (_annotations) {
-        _annotations->back().second.push_back(char(c));
-    }
+    
+    uint8_t c = static_cast<uint8_t>(*_cur++);
+    _charno++;
     
     if (c == '\n') {
         ++_lineno;
         _charno = 1;
         if (_annotations) {
+            _annotations->back().second.assign(_lineStart, _cur);
             _annotations->emplace_back(-1, "");
         }
+        _lineStart = _cur;
     }
     return c;
 }
@@ -373,6 +387,7 @@ Token Scanner::getToken(TokenType& tokenValue)
 			case '\'':
 				token = scanString(c);
                 tokenValue.str = _tokenString.c_str();
+                tokenValue.length = uint32_t(_tokenString.size());
 				break;
 
 			default:
@@ -383,10 +398,7 @@ Token Scanner::getToken(TokenType& tokenValue)
 				if ((token = scanNumber(tokenValue)) != Token::EndOfFile) {
 					break;
 				}
-				if ((token = scanIdentifier()) != Token::EndOfFile) {
-                    if (token == Token::Identifier) {
-                        tokenValue.str = _tokenString.c_str();
-                    }
+				if ((token = scanIdentifier(tokenValue)) != Token::EndOfFile) {
 					break;
 				}
 				token = Token::Unknown;
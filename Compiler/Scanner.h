@@ -12,6 +12,8 @@
 #include <cassert>
 #include <cstdint>
 #include <istream>
+#include <iterator>
+#include <string>
 #include <vector>
 
 namespace clvr {
@@ -108,27 +110,50 @@ static constexpr uint8_t C_EOF = 0xff;
 
 class Scanner  {
 public:
+    // str and length are a span. For an identifier it points into the
+    // source buffer, so it isn't 0 terminated. A string has its escapes
+    // replaced, so it's in a buffer of the Scanner's, which changes with
+    // the next token
     typedef struct {
         float   	    number;
         uint32_t        integer;
         const char*     str;
+        uint32_t        length;
     } TokenType;
 
   	Scanner(std::istream* stream = nullptr, std::vector<std::pair<int32_t, std::string>>* annotations = nullptr)
   	 : _lastChar(0xff)
-  	 , _stream(stream)
      , _lineno(1)
      , _charno(1)
      , _annotations(annotations)
   	{
         if (_annotations) _annotations->emplace_back(-1, "");
+        setStream(stream);
     }
   	
   	~Scanner()
   	{
     }
     
-    void setStream(std::istream* stream) { _stream = stream; }
+    // The source is scanned from a buffer in memory. A stream is read into
+    // one of the Scanner's. A buffer passed to setBuffer (or a file mapped
+    // into memory) is used in place, so it must not change or go away
+    // while the Scanner is used.
+    void setStream(std::istream* stream)
+    {
+        _source.clear();
+        if (stream) {
+            _source.assign(std::istreambuf_iterator<char>(*stream), std::istreambuf_iterator<char>());
+        }
+        setBuffer(_source.data(), _source.size());
+    }
+    
+    void setBuffer(const char* buf, size_t size)
+    {
+        _cur = buf;
+        _end = buf + size;
+        _lineStart = buf;
+    }
   
     void setIgnoreNewlines(bool ignore) { _ignoreNewlines = ignore; }
     
@@ -154,7 +179,7 @@ public:
     const std::string getTokenString()
     {
         const TokenType tokenType = getTokenValue();
-        return (_currentToken == Token::Identifier || _currentToken == Token::String) ? tokenType.str : "";
+        return (_currentToken == Token::Identifier || _currentToken == Token::String) ? std::string(tokenType.str, tokenType.length) : "";
     }
     
     void retireToken() { _currentToken = Token::None; }
@@ -172,6 +197,7 @@ public:
     }
     
     const std::vector<std::pair<int32_t, std::string>>* annotations() const { return _annotations; }
+    std::vector<std::pair<int32_t, std::string>>* annotations() { return _annotations; }
 
 private:
   	Token getToken(TokenType& token);
@@ -185,7 +211,7 @@ private:
 	}
 
   	Token scanString(char terminal);
-  	Token scanIdentifier();
+  	Token scanIdentifier(TokenType& tokenValue);
   	Token scanNumber(TokenType& tokenValue);
   	Token scanComment();
     Token scanSpecial();
@@ -194,7 +220,11 @@ private:
     
   	mutable uint8_t _lastChar;
   	std::string _tokenString;
-  	std::istream* _stream;
+    
+    std::string _source;
+    mutable const char* _cur = nullptr;
+    const char* _end = nullptr;
+    mutable const char* _lineStart = nullptr;   // For annotations
     mutable uint32_t _lineno;
     mutable uint32_t _charno;
 
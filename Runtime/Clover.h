@@ -1 +1,2 @@
 #include "Interpreter.h"
+#include "Scheduler.h"
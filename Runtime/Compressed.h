@@ -0,0 +1,182 @@
+/*-------------------------------------------------------------------------
+    This source file is a part of Clover
+    For the latest info, see https://github.com/cmarrin/Clover
+    Copyright (c) 2021-2022, Chris Marrin
+    All rights reserved.
+    Use of this source code is governed by the MIT license that can be
+    found in the LICENSE file.
+-------------------------------------------------------------------------*/
+
+// Compressed executable format
+//
+// An executable can be uploaded compressed so more of them fit in a small
+// EEPROM. The Interpreter decompresses one 64 byte page at a time as it
+// reads ROM, into a single page of RAM, so nothing else changes. Each page
+// is compressed by itself for that reason:
+//
+//      Format Id           - 4 bytes: 'arlz'
+//      Size                - 2 bytes: size of the executable in bytes
+//      Page sizes          - 1 byte for each 64 byte page of the executable
+//                            (the last one may be shorter). A page whose
+//                            size is the same as its uncompressed size is
+//                            stored as is
+//      Pages               - The compressed pages, one after another
+//
+// A compressed page is a stream of codes, read from the high bit of each
+// byte down. Each code is one symbol from a fixed canonical Huffman code:
+//
+//      0 - 47      one of the 48 most common bytes in CompressedLiterals
+//      48          escape, followed by a byte in 8 bits
+//      49 - 64     a match of 3 to 18 bytes, followed by its distance - 1.
+//                  A match copies bytes from earlier in the same page, so
+//                  at page offset pos the distance is 1 to pos and it takes
+//                  as many bits as pos - 1 does
+//
+// The code stops when the page is full. The tables were made from the
+// executables of the tests and benchmarks. They are part of the format, so
+// the 'arlz' signature has to change if they do.
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef ARDUINO
+    #include <Arduino.h>
+    #define CLOVER_TABLE PROGMEM
+#else
+    #define CLOVER_TABLE
+#endif
+
+namespace clvr {
+
+static inline uint8_t tableByte(const uint8_t* p)
+{
+#ifdef ARDUINO
+    return pgm_read_byte(p);
+#else
+    return *p;
+#endif
+}
+
+static constexpr uint8_t CompressedPageSize = 64;
+static constexpr uint16_t CompressedPageSizesOffset = 6;
+
+static constexpr uint8_t NumLiteralSymbols = 48;
+static constexpr uint8_t EscapeSymbol = 48;
+static constexpr uint8_t FirstMatchSymbol = 49;
+static constexpr uint8_t NumSymbols = 65;
+static constexpr uint8_t MinMatch = 3;
+static constexpr uint8_t MaxMatch = MinMatch + NumSymbols - FirstMatchSymbol - 1;
+static constexpr uint8_t MaxCodeLength = 12;
+
+static const uint8_t CompressedLiterals[NumLiteralSymbols] CLOVER_TABLE = {
+    0x00, 0x01, 0x0a, 0x20, 0x50, 0x05, 0x5c, 0x02, 0x70, 0x03, 0x74, 0x65, 0x73, 0x4c, 0x37, 0xa0,
+    0x80, 0x81, 0x6f, 0xb0, 0x61, 0x0b, 0x0e, 0xa1, 0x6e, 0x07, 0x6c, 0x54, 0x69, 0xd0, 0x72, 0xdf,
+    0x48, 0x25, 0x38, 0x10, 0x14, 0x82, 0xc0, 0x83, 0xa5, 0x36, 0x40, 0x5d, 0x41, 0x15, 0x3a, 0x58,
+};
+
+// Number of codes of each length from 1 to MaxCodeLength
+static const uint8_t CompressedCodeCounts[MaxCodeLength] CLOVER_TABLE = {
+    0, 1, 0, 1, 8, 16, 19, 8, 2, 1, 3, 6,
+};
+
+// Symbols in order of their codes
+static const uint8_t CompressedCodeSymbols[NumSymbols] CLOVER_TABLE = {
+    48,  0,  1,  2,  3,  4,  5,  6,  7, 49,  8,  9, 10, 11, 12, 13,
+    14, 15, 16, 17, 18, 19, 20, 21, 22, 50, 23, 24, 25, 26, 27, 28,
+    29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 51, 41, 42, 43,
+    44, 45, 46, 47, 52, 53, 54, 55, 57, 58, 62, 56, 59, 60, 61, 63,
+    64,
+};
+
+static inline bool isCompressedSignature(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+{
+    return a == 'a' && b == 'r' && c == 'l' && d == 'z';
+}
+
+// Bits in the distance of a match at page offset pos
+static inline uint8_t matchDistanceBits(uint8_t pos)
+{
+    uint8_t bits = 0;
+    for (uint8_t v = pos - 1; v; v >>= 1) {
+        ++bits;
+    }
+    return bits;
+}
+
+// Decompress a page of size bytes from compressedSize bytes of codes.
+// read(i) returns byte i of the codes. Returns false if the codes are bad
+// or run out before the page is full.
+template<typename Read>
+bool decompressPage(Read read, uint8_t compressedSize, uint8_t* page, uint8_t size)
+{
+    uint16_t bitIndex = 0;
+    uint16_t numBits = uint16_t(compressedSize) * 8;
+    uint8_t byte = 0;
+
+    auto bits = [&](uint8_t n, uint16_t& value) -> bool
+    {
+        value = 0;
+        while (n--) {
+            if (bitIndex >= numBits) {
+                return false;
+            }
+            if ((bitIndex & 7) == 0) {
+                byte = read(uint8_t(bitIndex >> 3));
+            }
+            value = (value << 1) | ((byte >> (7 - (bitIndex & 7))) & 1);
+            bitIndex++;
+        }
+        return true;
+    };
+
+    uint8_t pos = 0;
+    while (pos < size) {
+        // Canonical decode, one length at a time
+        uint16_t code = 0;
+        uint16_t first = 0;
+        uint8_t index = 0;
+        int16_t symbol = -1;
+        for (uint8_t len = 0; len < MaxCodeLength; ++len) {
+            uint16_t bit;
+            if (!bits(1, bit)) {
+                return false;
+            }
+            code |= bit;
+            uint8_t count = tableByte(&CompressedCodeCounts[len]);
+            if (code - first < count) {
+                symbol = tableByte(&CompressedCodeSymbols[index + code - first]);
+                break;
+            }
+            index += count;
+            first = (first + count) << 1;
+            code <<= 1;
+        }
+
+        if (symbol < 0) {
+            return false;
+        }
+
+        if (symbol < NumLiteralSymbols) {
+            page[pos++] = tableByte(&CompressedLiterals[symbol]);
+        } else if (symbol == EscapeSymbol) {
+            uint16_t value;
+            if (!bits(8, value)) {
+                return false;
+            }
+            page[pos++] = uint8_t(value);
+        } else {
+            uint8_t len = symbol - FirstMatchSymbol + MinMatch;
+            uint16_t distance;
+            if (!bits(matchDistanceBits(pos), distance) || distance >= pos || pos + len > size) {
+                return false;
+            }
+            for (uint8_t i = 0; i < len; ++i, ++pos) {
+                page[pos] = page[pos - distance - 1];
+            }
+        }
+    }
+    return true;
+}
+
+}
@@ -11,142 +11,540 @@
 
 #include "NativeCore.h"
 
+#ifdef ARDUINO
+    #include <new.h>
+#else
+    #include <new>
+    #include <stdio.h>
+#endif
+
 using namespace clvr;
 
-Interpreter::Interpreter(NativeModule** mod, uint32_t modSize)
+class Interpreter::ROMVerifier : public Verifier
+{
+public:
+    ROMVerifier(const Interpreter* interp) : _interp(interp) { }
+    
+protected:
+    virtual uint8_t rom(uint16_t addr) const override { return _interp->getUInt8ROM(addr); }
+
+    virtual int16_t numNativeParams(uint8_t id) const override
+    {
+        if (id >= _interp->_nativeBindingsSize || _interp->_nativeBindings[id].module == NoModule) {
+            return -1;
+        }
+        return _interp->_nativeBindings[id].numParams;
+    }
+
+private:
+    const Interpreter* _interp;
+};
+
+Interpreter::Interpreter(NativeModule** mod, uint32_t modSize, uint8_t* arena, uint16_t arenaSize)
+    : _arena(arena)
+    , _arenaSize(arena ? arenaSize : 0)
 {
     // Just in case they don't match
     if (mod == nullptr) {
         modSize = 0;
     }
     
-    _nativeModules = new NativeModule*[modSize + 1];
+    invalidateROMCache();
+    
+    if (_arena) {
+        // Without room for the modules and their bindings nothing can run,
+        // so load() and init() fail with OutOfMemory
+        _nativeModules = reinterpret_cast<NativeModule**>(arenaAlloc((modSize + 1) * sizeof(NativeModule*)));
+        uint8_t* core = arenaAlloc(sizeof(NativeCore));
+        if (!_nativeModules || !core) {
+            _nativeModules = nullptr;
+            return;
+        }
+        _nativeModules[0] = new (core) NativeCore();
+    } else {
+        _nativeModules = new NativeModule*[modSize + 1];
+        _nativeModules[0] = new NativeCore();
+    }
     _nativeModulesSize = modSize + 1;
     
-    _nativeModules[0] = new NativeCore();
     for (int i = 0; i < modSize; ++i) {
         _nativeModules[i + 1] = mod[i];
     }
+    
+    bindNatives();
 }
 
 Interpreter::~Interpreter()
 {
     // We own the NativeCore, which is the first module
-    if (!_nativeModules) {
-        delete _nativeModules[0];
+    if (_arena) {
+        if (_nativeModulesSize) {
+            _nativeModules[0]->~NativeModule();
+        }
+    } else {
+        if (_nativeModules) {
+            delete _nativeModules[0];
+        }
+        delete [ ] _nativeModules;
+        delete [ ] _nativeBindings;
+        delete [ ] _global;
     }
-    delete [ ] _nativeModules;
+
+#if CLOVER_PREDECODE
+    freeDecoded();
+#endif
 }
 
+void
+Interpreter::bindNatives()
+{
+    // Find the highest id so we know how big the table needs to be
+    uint16_t size = 0;
+    for (uint16_t id = 0; id < 256; ++id) {
+        for (uint8_t i = 0; i < _nativeModulesSize; ++i) {
+            if (_nativeModules[i]->hasId(id)) {
+                size = id + 1;
+            }
+        }
+    }
+    
+    if (_arena) {
+        _nativeBindings = reinterpret_cast<NativeBinding*>(arenaAlloc(size * sizeof(NativeBinding)));
+        if (!_nativeBindings) {
+            return;
+        }
+        _arenaFixed = _arenaUsed;
+    } else {
+        _nativeBindings = new NativeBinding[size];
+    }
+    _nativeBindingsSize = size;
+    
+    for (uint16_t id = 0; id < size; ++id) {
+        NativeBinding& binding = _nativeBindings[id];
+        binding.module = NoModule;
+        binding.numParams = 0;
+        
+        for (uint8_t i = 0; i < _nativeModulesSize; ++i) {
+            if (!_nativeModules[i]->hasId(id)) {
+                continue;
+            }
+            
+            // More than one module implementing an id is an error. It
+            // is reported by init()
+            if (binding.module != NoModule) {
+                _nativeIdConflict = true;
+                continue;
+            }
+            binding.module = i;
+            binding.numParams = _nativeModules[i]->numParams(id);
+        }
+    }
+}
+
+void
+Interpreter::invalidateROMCache()
+{
+#if CLOVER_ROM_CACHE_PAGES
+    for (uint8_t i = 0; i < CLOVER_ROM_CACHE_PAGES; ++i) {
+        _romCacheTag[i] = 0xffff;
+    }
+#endif
+#if CLOVER_COMPRESSED_ROM
+    _compressedPageTag = 0xffff;
+#endif
+}
+
+#if CLOVER_COMPRESSED_ROM
+const uint8_t*
+Interpreter::compressedPage(uint16_t page) const
+{
+    if (_compressedPageTag == page) {
+        return _compressedPage;
+    }
+    _compressedPageTag = page;
+    
+    // Find the page by adding up the sizes of the ones before it
+    uint16_t numPages = (_program.size + CompressedPageSize - 1) / CompressedPageSize;
+    if (page >= numPages) {
+        memset(_compressedPage, 0, CompressedPageSize);
+        return _compressedPage;
+    }
+    
+    uint16_t addr = CompressedPageSizesOffset + numPages;
+    for (uint16_t i = 0; i < page; ++i) {
+        addr += rom(CompressedPageSizesOffset + i);
+    }
+    
+    uint8_t size = min(uint16_t(CompressedPageSize), uint16_t(_program.size - page * CompressedPageSize));
+    uint8_t compressedSize = rom(CompressedPageSizesOffset + page);
+    
+    memset(_compressedPage, 0, CompressedPageSize);
+    if (compressedSize == size) {
+        romRead(addr, _compressedPage, size);
+    } else if (!decompressPage([this, addr](uint8_t i) { return rom(addr + i); }, compressedSize, _compressedPage, size)) {
+        // Make a bad page 0, which isn't a valid header or opcode
+        memset(_compressedPage, 0, CompressedPageSize);
+    }
+    return _compressedPage;
+}
+#endif
+
 void
 Interpreter::initArray(uint32_t index, uint32_t value, uint32_t count)
+{
+    uint32_t* memAddr = arrayAddr(index, count);
+    if (!memAddr) {
+        return;
+    }
+    
+    for (uint32_t i = 0; i < count; ++i) {
+        memAddr[i] = value;
+    }
+}
+
+void
+Interpreter::randomArray(uint32_t index, int32_t min, int32_t max, uint32_t count)
+{
+    uint32_t* memAddr = arrayAddr(index, count);
+    if (!memAddr) {
+        return;
+    }
+    
+    for (uint32_t i = 0; i < count; ++i) {
+        memAddr[i] = uint32_t(random(min, max));
+    }
+}
+
+void
+Interpreter::copyArray(uint32_t dst, uint32_t src, uint32_t count)
+{
+    uint32_t* dstAddr = arrayAddr(dst, count);
+    if (!dstAddr) {
+        return;
+    }
+    
+    Address srcAddr = Address::fromVar(src);
+    if (srcAddr.type() == Address::Type::Const) {
+        if (srcAddr.addr() > _program.constSize || count > uint32_t(_program.constSize - srcAddr.addr())) {
+            _error = Error::AddressOutOfRange;
+            return;
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            dstAddr[i] = getUInt32ROM(((srcAddr.addr() + i) * 4) + ConstOffset);
+        }
+        return;
+    }
+    
+    uint32_t* srcAddrRAM = arrayAddr(src, count);
+    if (srcAddrRAM) {
+        memmove(dstAddr, srcAddrRAM, count * sizeof(uint32_t));
+    }
+}
+
+uint32_t*
+Interpreter::arrayAddr(uint32_t index, uint32_t count)
 {
     // index is actually an Address
     Address addr = Address::fromVar(index);
 
-    uint32_t* memAddr = nullptr;
+    // The stack pointer isn't looked at because the predecoded path keeps
+    // its own copy while it runs. Anything up to the stack size is RAM
+    uint32_t start;
+    uint32_t size;
+    uint32_t* base;
     switch(addr.type()) {
-        case Address::Type::None:
-            return;
-        case Address::Type::Const:
-            _error = Error::OnlyMemAddressesAllowed;
-            return;
         case Address::Type::Global:
-            memAddr = _global + addr.addr();
+            start = addr.addr();
+            size = _program.globalSize;
+            base = _global;
             break;
         case Address::Type::LocalRel:
-            memAddr = &_stack.local(addr.addr());
+            start = uint32_t(_stack.bp()) + addr.addr();
+            size = _stack.size();
+            base = _stack.data();
             break;
         case Address::Type::LocalAbs:
-            memAddr = &_stack.absolute(addr.addr());
+            start = addr.addr();
+            size = _stack.size();
+            base = _stack.data();
             break;
+        case Address::Type::Const:
+            _error = Error::OnlyMemAddressesAllowed;
+            return nullptr;
+        default:
+            _error = Error::AddressOutOfRange;
+            return nullptr;
     }
     
-    for (uint32_t i = 0; i < count; ++i) {
-        memAddr[i] = value;
+    if (start > size || count > size - start) {
+        _error = Error::AddressOutOfRange;
+        return nullptr;
     }
+    return base + start;
 }
 
 bool
-Interpreter::init(const char* cmd, const uint8_t* buf, uint8_t size)
+Interpreter::load()
 {
-    memcpy(_params, buf, size);
-    _paramsSize = size;
-	_error = Error::None;
- 
-    if (_global) {
-        delete [ ]_global;
-        _global = nullptr;
-        _globalSize = 0;
-    }
+    _error = Error::None;
+    _errorAddr = -1;
+    _suspended = false;
+    _program = Program();
     
-    uint32_t constSize = uint32_t(getUInt16ROM(4)) * 4;
-    bool found = false;
-    _codeOffset = ConstOffset + constSize;
+    // A new executable may have been uploaded since the last load
+    invalidateROMCache();
     
-    // Alloc globals
-    _globalSize = getUInt16ROM(6);
+#if CLOVER_COMPRESSED_ROM
+    if (isCompressedSignature(rom(0), rom(1), rom(2), rom(3))) {
+        _program.compressed = true;
+        _program.size = uint16_t(rom(4)) | (uint16_t(rom(5)) << 8);
+    }
+#endif
+
+    _program.constSize = getUInt16ROM(4);
+    _program.globalSize = getUInt16ROM(6);
+    _program.stackSize = getUInt16ROM(8);
+    _program.commandStart = ConstOffset + _program.constSize * 4;
+
+    // Count the commands. Code starts after the terminating 0
+    uint16_t addr = _program.commandStart;
+    while (getUInt8ROM(addr) != 0) {
+        _program.numCommands++;
+        addr += 12;
+    }
+    _program.codeOffset = addr + 1;
+
+#if CLOVER_PREDECODE
+    freeDecoded();
+#endif
+
+    if (!allocRAM()) {
+        _program = Program();
+        _error = Error::OutOfMemory;
+        return false;
+    }
+
+    // Compiled code was verified when it was generated and ROM doesn't
+    // have the instructions
+    if (_compiledCode) {
+        _program.verified = true;
+        _program.loaded = true;
+        return true;
+    }
     
-    if (_globalSize) {
-        _global = new uint32_t[_globalSize];
+    ROMVerifier verifier(this);
+    if (_arena) {
+        uint16_t size;
+        uint8_t* buf = arenaScratch(size);
+        verifier.setBuffer(buf, size);
+    }
+    _program.verified = verifier.verify();
+    _program.maxDepth = verifier.maxDepth();
+    _program.stackBounded = _program.verified && verifier.stackBounded();
+    _program.verifyError = verifier.error();
+    _program.verifyErrorAddr = verifier.errorAddr();
+
+#if CLOVER_PREDECODE
+    // If the code can't be decoded (e.g., a jump into the middle of an
+    // instruction) just fall back to interpreting it. The unchecked stack
+    // can only run verified code. Decoding needs the heap.
+    if (_execMode == ExecMode::Predecoded && !_arena && (CLOVER_CHECKED_STACK || _program.verified)) {
+        decode(verifier);
+    }
+#endif
+
+    _program.loaded = true;
+    return true;
+}
+
+bool
+Interpreter::load(const Interpreter& image)
+{
+    if (!image._program.loaded) {
+        return load();
     }
     
-    // Alloc stack
-    _stack.alloc(getUInt16ROM(8));
+    _error = Error::None;
+    _errorAddr = -1;
+    _suspended = false;
+    _program = image._program;
+    _compiledCode = image._compiledCode;
+    _execMode = image._execMode;
+    invalidateROMCache();
+    if (!allocRAM()) {
+        _program = Program();
+        _error = Error::OutOfMemory;
+        return false;
+    }
 
-    // Find command
-    while (1) {
-        uint8_t c = rom(_codeOffset);
-        if (c == 0) {
-            _codeOffset++;
-            break;
+#if CLOVER_PREDECODE
+    freeDecoded();
+    _decoded = image._decoded;
+    _decodedSize = image._decodedSize;
+#endif
+    return true;
+}
+
+bool
+Interpreter::allocRAM()
+{
+    if (_arena) {
+        // Anything a previous load took is given back
+        _arenaUsed = _arenaFixed;
+        if (!_nativeBindings) {
+            return false;
         }
         
+        uint32_t* global = reinterpret_cast<uint32_t*>(arenaAlloc(_program.globalSize * sizeof(uint32_t)));
+        uint32_t* stack = reinterpret_cast<uint32_t*>(arenaAlloc(_program.stackSize * sizeof(uint32_t)));
+        if (!global || !stack) {
+            _arenaUsed = _arenaFixed;
+            return false;
+        }
+        _global = global;
+        _globalSize = _program.globalSize;
+        _stack.setBuffer(stack, _program.stackSize);
+        return true;
+    }
+    
+    // Only reallocate if they need to grow
+    if (_program.globalSize > _globalSize) {
+        delete [ ] _global;
+        _global = new uint32_t[_program.globalSize];
+        _globalSize = _program.globalSize;
+    }
+    
+    _stack.alloc(_program.stackSize);
+    return true;
+}
+
+uint8_t*
+Interpreter::arenaAlloc(uint16_t size)
+{
+    uint16_t start = _arenaUsed + ((4 - (uintptr_t(_arena + _arenaUsed) & 3)) & 3);
+    if (start > _arenaSize || size > _arenaSize - start) {
+        return nullptr;
+    }
+    _arenaUsed = start + size;
+    return _arena + start;
+}
+
+uint8_t*
+Interpreter::arenaScratch(uint16_t& size)
+{
+    size = _arenaSize - _arenaUsed;
+    return _arena + _arenaUsed;
+}
+
+int16_t
+Interpreter::findCommand(const char* cmd)
+{
+    if (!_program.loaded && !load()) {
+        return -1;
+    }
+    
+    for (uint8_t i = 0; i < _program.numCommands; ++i) {
         char buf[8];
         buf[7] = '\0';
-        for (int i = 0; i < 7; ++i) {
-            buf[i] = getUInt8ROM(_codeOffset + i);
-        }
+        getROM(_program.commandStart + i * 12, reinterpret_cast<uint8_t*>(buf), 7);
         
         if (strcmp(buf, cmd) == 0) {
-            // found cmd
-            _numParams = getUInt8ROM(_codeOffset + 7);
-            _initStart = getUInt16ROM(_codeOffset + 8);
-            _loopStart = getUInt16ROM(_codeOffset + 10);
-            
-            found = true;
-            
-            //Need to keep looping through all commands
-            // to find where the code starts
+            return i;
         }
-        
-        _codeOffset += 12;
+    }
+    return -1;
+}
+
+bool
+Interpreter::init(const char* cmd, const uint8_t* buf, uint8_t size)
+{
+    _error = Error::None;
+    int16_t index = findCommand(cmd);
+    if (index < 0) {
+        // A load that failed has its own error
+        if (_error == Error::None) {
+            _error = Error::CmdNotFound;
+        }
+        _errorAddr = -1;
+        return false;
+    }
+    return init(uint8_t(index), buf, size);
+}
+
+bool
+Interpreter::init(uint8_t index, const uint8_t* buf, uint8_t size)
+{
+	_error = Error::None;
+ 
+    if (_nativeIdConflict) {
+        _error = Error::NativeIdConflict;
+        _errorAddr = -1;
+        return false;
     }
     
-    if (!found) {
+    if (!_program.loaded && !load()) {
+        return false;
+    }
+    
+    if (index >= _program.numCommands) {
         _error = Error::CmdNotFound;
         _errorAddr = -1;
         return false;
     }
 
-    _initStart += _codeOffset;
-    _loopStart += _codeOffset;
-    
-    if (_numParams != size) {
+    uint16_t entry = _program.commandStart + index * 12;
+    _numParams = getUInt8ROM(entry + 7);
+    _initStart = getUInt16ROM(entry + 8) + _program.codeOffset;
+    _loopStart = getUInt16ROM(entry + 10) + _program.codeOffset;
+
+    if (_numParams != size || size > ParamsSize) {
         _error = Error::WrongNumberOfArgs;
         return false;
     }
     
+    memcpy(_params, buf, size);
+    _paramsSize = size;
+
+    // Start the command with a fresh stack and zeroed globals
+    _stack.reset();
+    _suspended = false;
+#if CLOVER_PROFILE
+    _profileDepth = 0;
+#endif
+    if (_program.globalSize) {
+        memset(_global, 0, _program.globalSize * sizeof(uint32_t));
+    }
+    
+#if CLOVER_PREDECODE
+    if (_decoded) {
+        _initInstr = decodedIndex(_initStart);
+        _loopInstr = decodedIndex(_loopStart);
+    }
+#endif
+
     // Execute init();
     _pc = _initStart;
-    if (!isNextOpcodeSetFrame()) {
+    if (!_compiledCode && !isNextOpcodeSetFrame()) {
         _error = Error::ExpectedSetFrame;
         return false;
     }
 
     // Push a dummy pc, for the return
     _stack.push(uint32_t(-1));
-    execute(_initStart);
+
+    if (_compiledCode) {
+        _compiledCode(this, _initStart);
+    } else {
+#if CLOVER_PREDECODE
+        if (_decoded) {
+            executeDecoded(_initInstr);
+        } else {
+            execute(_initStart);
+        }
+#else
+        execute(_initStart);
+#endif
+    }
     if (_error == Error::None) {
         _error = _stack.error();
     }
@@ -156,32 +554,217 @@ Interpreter::init(const char* cmd, const uint8_t* buf, uint8_t size)
 int32_t
 Interpreter::loop()
 {
+    // Drop anything that was suspended
+    if (_suspended) {
+        _suspended = false;
+        _stack.reset();
+    }
+    
+#if CLOVER_PROFILE
+    // Any functions left from a failed run are abandoned
+    _profileDepth = 0;
+#endif
+
     _pc = _loopStart;
-    if (!isNextOpcodeSetFrame()) {
+    if (!_compiledCode && !isNextOpcodeSetFrame()) {
         _error = Error::ExpectedSetFrame;
         return false;
     }
 
     // Push a dummy pc, for the return
     _stack.push(uint32_t(-1));
+
+    if (_compiledCode) {
+        return _compiledCode(this, _loopStart);
+    }
+
+#if CLOVER_PREDECODE
+    if (_decoded) {
+        return executeDecoded(_loopInstr);
+    }
+#endif
     return execute(_loopStart);
 }
 
+int32_t
+Interpreter::resume()
+{
+    if (!_suspended) {
+        return 0;
+    }
+    _suspended = false;
+    
+#if CLOVER_PREDECODE
+    if (_decoded) {
+        return executeDecoded(_resumeInstr);
+    }
+#endif
+    return execute(_pc);
+}
+
+#if CLOVER_PROFILE
+void
+Interpreter::profileEnter(uint16_t addr)
+{
+    uint8_t function = 0;
+    while (function < _profile.numFunctions && _profile.functions[function].addr != addr) {
+        function++;
+    }
+    
+    if (function == _profile.numFunctions) {
+        if (function < CLOVER_PROFILE_FUNCTIONS) {
+            _profile.functions[function].addr = addr;
+            _profile.numFunctions++;
+        } else {
+            function = NoFunction;
+        }
+    }
+    
+    if (function != NoFunction) {
+        _profile.functions[function].calls++;
+    }
+    
+    // Keep counting the depth past the end of the frames so each Return
+    // still matches its SetFrame. The SetFrame has already been counted
+    if (_profileDepth < CLOVER_PROFILE_DEPTH) {
+        _profileFrames[_profileDepth] = { function, _profile.instrs - 1 };
+    }
+    _profileDepth++;
+}
+
+void
+Interpreter::profileReturn()
+{
+    if (_profileDepth == 0) {
+        return;
+    }
+    
+    if (--_profileDepth < CLOVER_PROFILE_DEPTH) {
+        const ProfileFrame& frame = _profileFrames[_profileDepth];
+        if (frame.function != NoFunction) {
+            _profile.functions[frame.function].instrs += _profile.instrs - frame.start;
+        }
+    }
+}
+#endif
+
+bool
+Interpreter::callNative(uint8_t id)
+{
+    if (id >= _nativeBindingsSize || _nativeBindings[id].module == NoModule) {
+        _error = Error::InvalidNativeFunction;
+        return false;
+    }
+    
+    const NativeBinding& binding = _nativeBindings[id];
+
+#if CLOVER_PROFILE
+    _profile.natives[id]++;
+#endif
+
+    // Push a dummy pc just to make setFrame work
+    _stack.push(uint32_t(0));
+    
+    if (!_stack.setFrame(binding.numParams, 0)) {
+        return false;
+    }
+
+    int32_t returnVal = _nativeModules[binding.module]->call(this, id);
+
+    _stack.restoreFrame(returnVal);
+    return true;
+}
+
+bool
+Interpreter::aotSetFrame(uint8_t params, uint8_t locals, uint8_t depth)
+{
+    // setFrame replaces the return pc with the locals, pc and bp
+    if (_stack.sp() + locals + 1 + depth > _stack.size()) {
+        _error = Error::StackOverrun;
+        return false;
+    }
+    return _stack.setFrame(params, locals);
+}
+
+int16_t
+Interpreter::aotReturn(uint32_t& value)
+{
+    value = _stack.empty() ? 0 : _stack.pop();
+    
+    if (_stack.empty()) {
+        // Returning from top level
+        return -1;
+    }
+    
+    // TOS has return value. Pop it and push it back after restore
+    int16_t pc = _stack.restoreFrame(value);
+    
+    // A pc of -1 returns from top level
+    if (pc < 0) {
+        // value was pushed, get rid of it
+        _stack.pop();
+    }
+    return pc;
+}
+
+bool
+Interpreter::aotFailed(uint16_t addr)
+{
+    if (_stack.error() != Error::None) {
+        _error = _stack.error();
+    }
+    if (_error != Error::None) {
+        _errorAddr = addr;
+        return true;
+    }
+    return false;
+}
+
+void
+Interpreter::logFromROM(uint16_t addr, uint8_t len, uint8_t numArgs)
+{
+    logFormat([this, addr](uint16_t i) { return char(getUInt8ROM(addr + i)); }, len, numArgs);
+}
+
+void
+Interpreter::aotLog(const char* fmt, uint8_t numArgs)
+{
+    logFormat([fmt](uint16_t i) { return fmt[i]; }, 0xffff, numArgs);
+}
+
 int32_t
 Interpreter::execute(uint16_t addr)
 {
     _pc = addr;
     
+    #define CLOVER_CHECK_ERROR() \
+        if (_stack.error() != Error::None) { \
+            _error = _stack.error(); \
+        } \
+        if (_error != Error::None) { \
+            _errorAddr = _pc - 1; \
+            return -1; \
+        }
+
+    // Verified code can't get a stack or id error except where it calls
+    // SetFrame, so only the ops which can otherwise fail are checked
+    bool checked = !_program.verified;
+    uint32_t remaining = _budget;
+    
     while(1) {
-        if (_stack.error() != Error::None) {
-            _error = _stack.error();
+        if (checked) {
+            CLOVER_CHECK_ERROR();
         }
-        if (_error != Error::None) {
-            _errorAddr = _pc - 1;
-            return -1;
+        
+        if (_budget && remaining-- == 0) {
+            _suspended = true;
+            return Suspended;
         }
         
         uint8_t cmd = getUInt8ROM(_pc++);
+#if CLOVER_PROFILE
+        profileOp(cmd, uint16_t(_stack.sp()));
+#endif
         uint8_t index = 0;
         if (cmd >= ExtOpcodeStart) {
             index = cmd & 0x0f;
@@ -199,10 +782,10 @@ Interpreter::execute(uint16_t addr)
 				_error = Error::InvalidOp;
 				return -1;
             case Op::Push:
-                _stack.push(loadInt(Address::fromId(getId(index))));
+                _stack.push(loadId(getId(index)));
                 break;
             case Op::Pop:
-                storeInt(Address::fromId(getId(index)), _stack.pop());
+                storeId(getId(index), _stack.pop());
                 break;
             case Op::PushRef:
                 // If this is a stack address we need to convert
@@ -219,11 +802,13 @@ Interpreter::execute(uint16_t addr)
             case Op::PushDeref:
                 addr = _stack.popAddr();
                 _stack.push(loadInt(addr));
+                CLOVER_CHECK_ERROR();
                 break;
             case Op::PopDeref:
                 value = _stack.pop();
                 addr = _stack.popAddr();
                 storeInt(addr, value);
+                CLOVER_CHECK_ERROR();
                 break;
 
             case Op::Offset:
@@ -256,26 +841,16 @@ Interpreter::execute(uint16_t addr)
                 _pc += getRelTarg(index);
                 break;
             
-            case Op::Log: {
-                if (_stringBuf) {
-                    delete [ ] _stringBuf;
-                }
-                _stringSize = getSz();
-                _stringBuf = new char[_stringSize + 1];
-                
-                for (int i = 0; i < _stringSize; ++i) {
-                    _stringBuf[i] = getConst();
-                }
-                
-                _stringBuf[_stringSize] = '\0';
-                log(_stringBuf, index);
+            case Op::Log:
+                sz = getSz();
+                logFromROM(_pc, sz, index);
+                _pc += sz;
                 break;
-            }
             
             case Op::Call: {
                 uint16_t targ = getAbsTarg(index);
                 _stack.push(_pc);
-                _pc = targ + _codeOffset;
+                _pc = targ + _program.codeOffset;
                 
                 if (!isNextOpcodeSetFrame()) {
                     _error = Error::ExpectedSetFrame;
@@ -283,36 +858,42 @@ Interpreter::execute(uint16_t addr)
                 }
                 break;
             }
-            case Op::CallNative: {
-                sz = getConst();
-                
-                // Find the function
-                bool found = false;
-                for (int i = 0; i < _nativeModulesSize; ++i) {
-                    if (_nativeModules[i]->hasId(sz)) {
-                        found = true;
-                        
-                        // Save the _pc just to make setFrame work
+            case Op::Long: {
+                uint16_t targ = getLongTarg();
+                switch(LongOp(index)) {
+                    default:
+                        _error = Error::InvalidOp;
+                        return -1;
+                    case LongOp::Jump:
+                        _pc += int16_t(targ);
+                        break;
+                    case LongOp::If:
+                        if (_stack.pop() == 0) {
+                            _pc += int16_t(targ);
+                        }
+                        break;
+                    case LongOp::Call:
                         _stack.push(_pc);
+                        _pc = targ + _program.codeOffset;
                         
-                        if (!_stack.setFrame(_nativeModules[i]->numParams(sz), 0)) {
+                        if (!isNextOpcodeSetFrame()) {
+                            _error = Error::ExpectedSetFrame;
                             return -1;
                         }
-
-                        int32_t returnVal = _nativeModules[i]->call(this, sz);
- 
-                        _pc = _stack.restoreFrame(returnVal);
                         break;
-                    }
                 }
-                
-                if (!found) {
-                    _error = Error::InvalidNativeFunction;
+                break;
+            }
+            case Op::CallNative:
+                if (!callNative(getConst())) {
                     return -1;
                 }
+                CLOVER_CHECK_ERROR();
                 break;
-            }
             case Op::Return: {
+#if CLOVER_PROFILE
+                profileReturn();
+#endif
                 uint32_t retVal = _stack.empty() ? 0 : _stack.pop();
                 
                 if (_stack.empty()) {
@@ -329,11 +910,23 @@ Interpreter::execute(uint16_t addr)
                     _stack.pop();
                     return retVal;
                 }
+                CLOVER_CHECK_ERROR();
                 break;
             }
             case Op::SetFrame:
+#if CLOVER_PROFILE
+                profileEnter(uint16_t(_pc - 1));
+#endif
                 numParams = index;
                 numLocals = getSz();
+                
+                // setFrame replaces the return pc with the locals, pc and
+                // bp. Make sure the deepest operand stack fits on top.
+                if (!checked && !_program.stackBounded && _stack.sp() + numLocals + 1 + _program.maxDepth > _stack.size()) {
+                    _error = Error::StackOverrun;
+                    _errorAddr = _pc - 2;
+                    return -1;
+                }
                 if (!_stack.setFrame(numParams, numLocals)) {
                     return -1;
                 }
@@ -433,6 +1026,12 @@ Interpreter::execute(uint16_t addr)
                 break;
             case Op::DivInt:
                 value = _stack.pop();
+#if CLOVER_CHECKED_DIVIDE
+                if (intDivFails(_stack.top(), value)) {
+                    _error = Error::DivideByZero;
+                    CLOVER_CHECK_ERROR();
+                }
+#endif
                 _stack.top() = int32_t(_stack.top()) / int32_t(value);
                 break;
             case Op::DivFloat:
@@ -445,6 +1044,75 @@ Interpreter::execute(uint16_t addr)
             case Op::NegFloat:
                 _stack.top() = floatToInt(-intToFloat(_stack.top()));
                 break;
+            case Op::MulFixed:
+                value = _stack.pop();
+                _stack.top() = fixedMul(_stack.top(), value);
+                break;
+            case Op::DivFixed:
+                value = _stack.pop();
+#if CLOVER_CHECKED_DIVIDE
+                if (value == 0) {
+                    _error = Error::DivideByZero;
+                    CLOVER_CHECK_ERROR();
+                }
+#endif
+                _stack.top() = fixedDiv(_stack.top(), value);
+                break;
+
+            case Op::AddIntConst:
+                _stack.top() = int32_t(_stack.top()) + int8_t(getConst());
+                break;
+            case Op::Push2:
+                _stack.push(loadId(idFromSid(getConst())));
+                _stack.push(loadId(idFromSid(getConst())));
+                break;
+            case Op::StoreIntConst: {
+                uint16_t id = idFromSid(getConst());
+                storeId(id, getConst());
+                break;
+            }
+            case Op::AddToVar: {
+                uint16_t id = idFromSid(getConst());
+                storeId(id, int32_t(loadId(id)) + int32_t(_stack.pop()));
+                break;
+            }
+
+            case Op::IfLTInt:
+            case Op::IfLEInt:
+            case Op::IfEQInt:
+            case Op::IfNEInt:
+            case Op::IfGEInt:
+            case Op::IfGTInt: {
+                int32_t b = _stack.pop();
+                int32_t a = _stack.pop();
+                uint8_t fwdTarg = getConst();
+                bool result;
+                switch(Op(cmd)) {
+                    case Op::IfLTInt: result = a < b; break;
+                    case Op::IfLEInt: result = a <= b; break;
+                    case Op::IfEQInt: result = a == b; break;
+                    case Op::IfNEInt: result = a != b; break;
+                    case Op::IfGEInt: result = a >= b; break;
+                    default         : result = a > b; break;
+                }
+                if (!result) {
+                    // Skip if
+                    _pc += fwdTarg;
+                }
+                break;
+            }
+            case Op::IncLoopLTInt:
+            case Op::IncLoopLTIntConst: {
+                uint16_t id = idFromSid(getConst());
+                uint8_t limit = getConst();
+                uint8_t bwdTarg = getConst();
+                int32_t i = int32_t(loadId(id)) + 1;
+                storeId(id, i);
+                if (i < ((Op(cmd) == Op::IncLoopLTInt) ? int32_t(loadId(idFromSid(limit))) : int32_t(limit))) {
+                    _pc -= bwdTarg;
+                }
+                break;
+            }
 
             case Op::PreIncInt:
             case Op::PreDecInt:
@@ -455,6 +1123,7 @@ Interpreter::execute(uint16_t addr)
                 int32_t valueAfter = (Op(cmd) == Op::PreIncInt || Op(cmd) == Op::PostIncInt) ? (value + 1) : (value - 1);
                 storeInt(addr, valueAfter);
                 _stack.push((Op(cmd) == Op::PreIncInt || Op(cmd) == Op::PreDecInt) ? valueAfter : value);
+                CLOVER_CHECK_ERROR();
                 break;
             }
             case Op::PreIncFloat:
@@ -466,11 +1135,1025 @@ Interpreter::execute(uint16_t addr)
                 float valueAfter = (Op(cmd) == Op::PreIncFloat || Op(cmd) == Op::PostIncFloat) ? (value + 1) : (value - 1);
                 storeFloat(addr, valueAfter);
                 _stack.push((Op(cmd) == Op::PreIncFloat || Op(cmd) == Op::PreDecFloat) ? floatToInt(valueAfter) : floatToInt(value));
+                CLOVER_CHECK_ERROR();
+                break;
+            }
+            case Op::PreIncFixed:
+            case Op::PreDecFixed:
+            case Op::PostIncFixed:
+            case Op::PostDecFixed: {
+                Address addr = _stack.popAddr();
+                int32_t value = int32_t(loadInt(addr));
+                int32_t valueAfter = (Op(cmd) == Op::PreIncFixed || Op(cmd) == Op::PostIncFixed) ? (value + FixedOne) : (value - FixedOne);
+                storeInt(addr, valueAfter);
+                _stack.push((Op(cmd) == Op::PreIncFixed || Op(cmd) == Op::PreDecFixed) ? valueAfter : value);
+                CLOVER_CHECK_ERROR();
+                break;
+            }
+        }
+    }
+    
+    #undef CLOVER_CHECK_ERROR
+}
+
+#if CLOVER_PREDECODE
+static constexpr uint16_t NoTarg = 0xffff;
+
+void
+Interpreter::freeDecoded()
+{
+    if (_decodedOwned) {
+        delete [ ] _decoded;
+    }
+    _decoded = nullptr;
+    _decodedSize = 0;
+    _decodedOwned = false;
+}
+
+// Decode the instruction at pc. Return its length in bytes, or 0 if it's
+// not a valid opcode. If the instruction has a jump or call target, its
+// ROM address is returned in targ, otherwise targ is NoTarg.
+uint8_t
+Interpreter::decodeOne(uint16_t pc, Instr& instr, uint16_t& targ) const
+{
+    uint8_t cmd = getUInt8ROM(pc);
+    uint8_t index = 0;
+    if (cmd >= ExtOpcodeStart) {
+        index = cmd & 0x0f;
+        cmd &= 0xf0;
+    }
+
+    instr.handler = nullptr;
+    instr.op = DecodedOp::Invalid;
+    instr.index = index;
+    instr.addr = pc;
+    instr.value = 0;
+    targ = NoTarg;
+    
+    // Only valid for ops with an id or target
+    uint16_t id = (uint16_t(index) << 8) | getUInt8ROM(pc + 1);
+    int16_t relTarg = (id & 0x800) ? int16_t(id | 0xf000) : int16_t(id);
+    Address addr = Address::fromId(id);
+
+    switch(Op(cmd)) {
+        default:
+            return 0;
+        case Op::Push:
+            switch(addr.type()) {
+                case Address::Type::Const:
+                    instr.op = DecodedOp::PushImm;
+                    instr.value = getUInt32ROM((addr.addr() * 4) + ConstOffset);
+                    break;
+                case Address::Type::Global:
+                    instr.op = DecodedOp::PushGlobal;
+                    instr.value = addr.addr();
+                    break;
+                default:
+                    instr.op = DecodedOp::PushLocal;
+                    instr.value = addr.addr();
+                    break;
+            }
+            return 2;
+        case Op::Pop:
+            switch(addr.type()) {
+                case Address::Type::Const:
+                    // Storing to a const is a no-op, just get rid of the value
+                    instr.op = DecodedOp::Drop;
+                    break;
+                case Address::Type::Global:
+                    instr.op = DecodedOp::PopGlobal;
+                    instr.value = addr.addr();
+                    break;
+                default:
+                    instr.op = DecodedOp::PopLocal;
+                    instr.value = addr.addr();
+                    break;
+            }
+            return 2;
+        case Op::PushRef:
+            // Only local addresses need the bp at runtime
+            if (addr.type() == Address::Type::LocalRel) {
+                instr.op = DecodedOp::PushRefLocal;
+                instr.value = id;
+            } else {
+                instr.op = DecodedOp::PushImm;
+                instr.value = addr.toVar();
+            }
+            return 2;
+        case Op::PushIntConst:
+            instr.op = DecodedOp::PushImm;
+            instr.value = getUInt8ROM(pc + 1);
+            return 2;
+        case Op::PushIntConstS:
+            instr.op = DecodedOp::PushImm;
+            instr.value = index;
+            return 1;
+        case Op::Offset:
+            instr.op = DecodedOp::Offset;
+            return 1;
+        case Op::Index:
+            instr.op = DecodedOp::Index;
+            return 1;
+        case Op::If:
+            instr.op = DecodedOp::If;
+            targ = pc + 2 + relTarg;
+            return 2;
+        case Op::Jump:
+            instr.op = DecodedOp::Jump;
+            targ = pc + 2 + relTarg;
+            return 2;
+        case Op::Call:
+            instr.op = DecodedOp::Call;
+            targ = id + _program.codeOffset;
+            return 2;
+        case Op::Long: {
+            uint16_t longTarg = getUInt16ROM(pc + 1);
+            switch(LongOp(index)) {
+                default:
+                    return 0;
+                case LongOp::Jump:
+                    instr.op = DecodedOp::Jump;
+                    targ = pc + 3 + int16_t(longTarg);
+                    break;
+                case LongOp::If:
+                    instr.op = DecodedOp::If;
+                    targ = pc + 3 + int16_t(longTarg);
+                    break;
+                case LongOp::Call:
+                    instr.op = DecodedOp::Call;
+                    targ = longTarg + _program.codeOffset;
+                    break;
+            }
+            return 3;
+        }
+        case Op::CallNative:
+            instr.op = DecodedOp::CallNative;
+            instr.value = getUInt8ROM(pc + 1);
+            return 2;
+        case Op::SetFrame:
+            instr.op = DecodedOp::SetFrame;
+            instr.value = getUInt8ROM(pc + 1);
+            return 2;
+        case Op::AddIntConst:
+            instr.op = DecodedOp::AddIntConst;
+            instr.value = int8_t(getUInt8ROM(pc + 1));
+            return 2;
+        case Op::Push2: {
+            // Value has the first Address in the upper 16 bits and the
+            // second in the lower 16. When both are locals it has their
+            // offsets in the frame instead.
+            uint8_t a = getUInt8ROM(pc + 1);
+            uint8_t b = getUInt8ROM(pc + 2);
+            if (a >= SidLocalStart && b >= SidLocalStart) {
+                instr.op = DecodedOp::Push2Local;
+                instr.value = (uint32_t(a - SidLocalStart) << 16) | (b - SidLocalStart);
+            } else {
+                instr.op = DecodedOp::Push2;
+                instr.value = (Address::fromId(idFromSid(a)).toVar() << 16) | Address::fromId(idFromSid(b)).toVar();
+            }
+            return 3;
+        }
+        case Op::StoreIntConst:
+            // Value has the local or global offset in the upper 16 bits
+            // and the const in the lower 16
+            addr = Address::fromId(idFromSid(getUInt8ROM(pc + 1)));
+            instr.op = (addr.type() == Address::Type::Global) ? DecodedOp::StoreGlobalConst : DecodedOp::StoreLocalConst;
+            instr.value = (uint32_t(addr.addr()) << 16) | getUInt8ROM(pc + 2);
+            return 3;
+        case Op::AddToVar:
+            addr = Address::fromId(idFromSid(getUInt8ROM(pc + 1)));
+            instr.op = (addr.type() == Address::Type::Global) ? DecodedOp::AddToGlobal : DecodedOp::AddToLocal;
+            instr.value = addr.addr();
+            return 2;
+        case Op::IfLTInt:
+        case Op::IfLEInt:
+        case Op::IfEQInt:
+        case Op::IfNEInt:
+        case Op::IfGEInt:
+        case Op::IfGTInt:
+            instr.op = DecodedOp(uint8_t(DecodedOp::IfLTInt) + (cmd - uint8_t(Op::IfLTInt)));
+            targ = pc + 2 + getUInt8ROM(pc + 1);
+            return 2;
+        case Op::IncLoopLTInt:
+        case Op::IncLoopLTIntConst:
+        {
+            // Value has the sid and the limit in the upper 16 bits. The
+            // target goes in the lower 16. When the variables are locals
+            // it has their offsets in the frame instead of sids.
+            uint8_t sid = getUInt8ROM(pc + 1);
+            uint8_t limit = getUInt8ROM(pc + 2);
+            bool isConst = Op(cmd) == Op::IncLoopLTIntConst;
+            if (sid >= SidLocalStart && (isConst || limit >= SidLocalStart)) {
+                instr.op = isConst ? DecodedOp::IncLoopLTIntConstLocal : DecodedOp::IncLoopLTIntLocal;
+                sid -= SidLocalStart;
+                limit -= isConst ? 0 : SidLocalStart;
+            } else {
+                instr.op = isConst ? DecodedOp::IncLoopLTIntConst : DecodedOp::IncLoopLTInt;
+            }
+            instr.value = (uint32_t(limit) << 24) | (uint32_t(sid) << 16);
+            targ = pc + 4 - getUInt8ROM(pc + 3);
+            return 4;
+        }
+        case Op::Log: {
+            // Value has the string length in the upper 16 bits and the
+            // ROM address of the string in the lower 16
+            uint8_t len = getUInt8ROM(pc + 1);
+            instr.op = DecodedOp::Log;
+            instr.value = (uint32_t(len) << 16) | uint16_t(pc + 2);
+            return 2 + len;
+        }
+
+        case Op::PushDeref     : instr.op = DecodedOp::PushDeref; return 1;
+        case Op::PopDeref      : instr.op = DecodedOp::PopDeref; return 1;
+        case Op::Dup           : instr.op = DecodedOp::Dup; return 1;
+        case Op::Drop          : instr.op = DecodedOp::Drop; return 1;
+        case Op::Swap          : instr.op = DecodedOp::Swap; return 1;
+        case Op::Return        : instr.op = DecodedOp::Return; return 1;
+        case Op::Or            : instr.op = DecodedOp::Or; return 1;
+        case Op::Xor           : instr.op = DecodedOp::Xor; return 1;
+        case Op::And           : instr.op = DecodedOp::And; return 1;
+        case Op::Not           : instr.op = DecodedOp::Not; return 1;
+        case Op::LOr           : instr.op = DecodedOp::LOr; return 1;
+        case Op::LAnd          : instr.op = DecodedOp::LAnd; return 1;
+        case Op::LNot          : instr.op = DecodedOp::LNot; return 1;
+        case Op::LTInt         : instr.op = DecodedOp::LTInt; return 1;
+        case Op::LTFloat       : instr.op = DecodedOp::LTFloat; return 1;
+        case Op::LEInt         : instr.op = DecodedOp::LEInt; return 1;
+        case Op::LEFloat       : instr.op = DecodedOp::LEFloat; return 1;
+        case Op::EQInt         : instr.op = DecodedOp::EQInt; return 1;
+        case Op::EQFloat       : instr.op = DecodedOp::EQFloat; return 1;
+        case Op::NEInt         : instr.op = DecodedOp::NEInt; return 1;
+        case Op::NEFloat       : instr.op = DecodedOp::NEFloat; return 1;
+        case Op::GEInt         : instr.op = DecodedOp::GEInt; return 1;
+        case Op::GEFloat       : instr.op = DecodedOp::GEFloat; return 1;
+        case Op::GTInt         : instr.op = DecodedOp::GTInt; return 1;
+        case Op::GTFloat       : instr.op = DecodedOp::GTFloat; return 1;
+        case Op::AddInt        : instr.op = DecodedOp::AddInt; return 1;
+        case Op::AddFloat      : instr.op = DecodedOp::AddFloat; return 1;
+        case Op::SubInt        : instr.op = DecodedOp::SubInt; return 1;
+        case Op::SubFloat      : instr.op = DecodedOp::SubFloat; return 1;
+        case Op::MulInt        : instr.op = DecodedOp::MulInt; return 1;
+        case Op::MulFloat      : instr.op = DecodedOp::MulFloat; return 1;
+        case Op::DivInt        : instr.op = DecodedOp::DivInt; return 1;
+        case Op::DivFloat      : instr.op = DecodedOp::DivFloat; return 1;
+        case Op::NegInt        : instr.op = DecodedOp::NegInt; return 1;
+        case Op::NegFloat      : instr.op = DecodedOp::NegFloat; return 1;
+        case Op::PreIncInt     : instr.op = DecodedOp::PreIncInt; return 1;
+        case Op::PreIncFloat   : instr.op = DecodedOp::PreIncFloat; return 1;
+        case Op::PreDecInt     : instr.op = DecodedOp::PreDecInt; return 1;
+        case Op::PreDecFloat   : instr.op = DecodedOp::PreDecFloat; return 1;
+        case Op::PostIncInt    : instr.op = DecodedOp::PostIncInt; return 1;
+        case Op::PostIncFloat  : instr.op = DecodedOp::PostIncFloat; return 1;
+        case Op::PostDecInt    : instr.op = DecodedOp::PostDecInt; return 1;
+        case Op::PostDecFloat  : instr.op = DecodedOp::PostDecFloat; return 1;
+        case Op::MulFixed      : instr.op = DecodedOp::MulFixed; return 1;
+        case Op::DivFixed      : instr.op = DecodedOp::DivFixed; return 1;
+        case Op::PreIncFixed   : instr.op = DecodedOp::PreIncFixed; return 1;
+        case Op::PreDecFixed   : instr.op = DecodedOp::PreDecFixed; return 1;
+        case Op::PostIncFixed  : instr.op = DecodedOp::PostIncFixed; return 1;
+        case Op::PostDecFixed  : instr.op = DecodedOp::PostDecFixed; return 1;
+    }
+}
+
+// Decode all the code reachable from the init and loop functions of
+// every command into _decoded. Instructions are kept in ROM address
+// order so falling through to the next instruction still works. Returns
+// false (and leaves _decoded empty) if the code can't be decoded.
+bool
+Interpreter::decode(const Verifier& verifier)
+{
+    // Pass 1: Mark the start of every reachable instruction
+    uint8_t* starts = new uint8_t[(MaxCodeSize + 7) / 8]();
+    uint32_t workSize = uint32_t(MaxCodeSize) + 32;
+    uint16_t* work = new uint16_t[workSize];
+    uint32_t numWork = 0;
+    bool success = true;
+    
+    for (uint16_t cmd = _program.commandStart; getUInt8ROM(cmd) != 0; cmd += 12) {
+        if (numWork + 2 > workSize) {
+            success = false;
+            break;
+        }
+        work[numWork++] = getUInt16ROM(cmd + 8) + _program.codeOffset;
+        work[numWork++] = getUInt16ROM(cmd + 10) + _program.codeOffset;
+    }
+    
+    while (success && numWork) {
+        uint16_t pc = work[--numWork];
+        
+        while (true) {
+            uint16_t rel = pc - _program.codeOffset;
+            if (pc < _program.codeOffset || rel >= MaxCodeSize || (starts[rel / 8] & (1 << (rel % 8)))) {
+                break;
+            }
+            starts[rel / 8] |= 1 << (rel % 8);
+            
+            Instr instr;
+            uint16_t targ;
+            uint8_t len = decodeOne(pc, instr, targ);
+            if (len == 0) {
+                // Executing this will give an InvalidOp error
+                break;
+            }
+            if (targ != NoTarg) {
+                if (numWork == workSize) {
+                    success = false;
+                    break;
+                }
+                work[numWork++] = targ;
+            }
+            if (instr.op == DecodedOp::Return || instr.op == DecodedOp::Jump) {
+                break;
+            }
+            pc += len;
+        }
+    }
+    delete [ ] work;
+
+    // Pass 2: Decode each instruction into its slot. Leave room for
+    // an Invalid instruction at the end in case the last one falls
+    // through.
+    uint16_t* indexes = new uint16_t[MaxCodeSize];
+    
+    if (success) {
+        uint16_t count = 1;
+        for (uint16_t rel = 0; rel < MaxCodeSize; ++rel) {
+            if (starts[rel / 8] & (1 << (rel % 8))) {
+                ++count;
+            }
+        }
+        
+        _decoded = new Instr[count];
+        _decodedOwned = true;
+        _decodedSize = count;
+        
+        uint16_t i = 0;
+        uint16_t end = 0;
+        for (uint16_t rel = 0; rel < MaxCodeSize; ++rel) {
+            if (!(starts[rel / 8] & (1 << (rel % 8)))) {
+                continue;
+            }
+            
+            if (rel < end) {
+                // This instruction starts in the middle of the previous one
+                success = false;
                 break;
             }
+            
+            uint16_t targ;
+            uint8_t len = decodeOne(rel + _program.codeOffset, _decoded[i], targ);
+            
+            // Save the target addr so we can resolve it below. The loop
+            // ops keep their operands in the upper 16 bits
+            if (targ != NoTarg) {
+                _decoded[i].value = (isLoop(_decoded[i].op) ? (_decoded[i].value & 0xffff0000) : 0) | targ;
+            }
+            
+            // The unchecked stack needs the depth of every function
+            if (_decoded[i].op == DecodedOp::SetFrame) {
+                _decoded[i].value |= uint32_t(verifier.maxDepth(rel + _program.codeOffset)) << 8;
+            }
+            indexes[rel] = i++;
+            end = rel + ((len == 0) ? 1 : len);
+        }
+        
+        Instr& last = _decoded[i];
+        last.handler = nullptr;
+        last.op = DecodedOp::Invalid;
+        last.index = 0;
+        last.addr = end + _program.codeOffset;
+        last.value = 0;
+    }
+    
+    // Pass 3: Turn target addrs into instruction indexes
+    for (uint16_t i = 0; success && i < _decodedSize - 1; ++i) {
+        Instr& instr = _decoded[i];
+        if (!isBranch(instr.op)) {
+            continue;
+        }
+        
+        uint16_t targ = uint16_t(instr.value);
+        uint16_t rel = targ - _program.codeOffset;
+        if (targ < _program.codeOffset || rel >= MaxCodeSize) {
+            instr.op = DecodedOp::Invalid;
+            continue;
+        }
+        
+        instr.value = (instr.value & 0xffff0000) | indexes[rel];
+        if (instr.op == DecodedOp::Call && _decoded[instr.value].op != DecodedOp::SetFrame) {
+            instr.op = DecodedOp::CallNoFrame;
+        }
+    }
+    
+    if (!success) {
+        freeDecoded();
+    }
+    
+#if CLOVER_THREADED
+    if (success) {
+        executeDecoded(ResolveHandlers);
+    }
+#endif
+
+    delete [ ] starts;
+    delete [ ] indexes;
+    return success;
+}
+
+uint16_t
+Interpreter::decodedIndex(uint16_t addr) const
+{
+    // Instructions are in addr order. The last one is the Invalid
+    // entry added at the end, return that if addr isn't found.
+    uint16_t lo = 0;
+    uint16_t hi = _decodedSize - 1;
+    while (lo < hi) {
+        uint16_t mid = (lo + hi) / 2;
+        if (_decoded[mid].addr < addr) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return (_decoded[lo].addr == addr) ? lo : (_decodedSize - 1);
+}
+
+int32_t
+Interpreter::executeDecoded(uint16_t index)
+{
+#if CLOVER_THREADED
+    static const void* const handlers[] = {
+        #define CLOVER_DECODED_LABEL(op) &&L_##op,
+        CLOVER_DECODED_OPS(CLOVER_DECODED_LABEL)
+        #undef CLOVER_DECODED_LABEL
+    };
+    
+    // The label addresses can only be taken in this function, so decode()
+    // calls it to fill them in. Nothing writes the decoded code after
+    // that, which lets other Interpreters share it
+    if (index == ResolveHandlers) {
+        for (uint16_t i = 0; i < _decodedSize; ++i) {
+            _decoded[i].handler = handlers[uint8_t(_decoded[i].op)];
+        }
+        return 0;
+    }
+#endif
+
+    const Instr* ip = _decoded + index;
+    const Instr* cur = ip;
+    uint32_t value;
+    Address addr;
+    
+    #define CLOVER_CHECK_ERROR() \
+        if (_stack.error() != Error::None) { \
+            _error = _stack.error(); \
+        } \
+        if (_error != Error::None) { \
+            _errorAddr = cur->addr; \
+            return -1; \
+        }
+
+    // With the checked stack the code may not be verified, so errors are
+    // checked after every op. Otherwise the code is verified and only
+    // the ops which can still fail check
+#if CLOVER_CHECKED_STACK
+    #define CLOVER_CHECK_EACH() CLOVER_CHECK_ERROR()
+    #define PUSH(v) _stack.push(v)
+    #define POP() _stack.pop()
+    #define POP_ADDR() _stack.popAddr()
+    #define TOP() _stack.top()
+    #define SWAP() _stack.swap()
+    #define LOCAL(i) _stack.local(i)
+    #define SPILL()
+    #define RELOAD()
+    #define DEPTH() uint16_t(_stack.sp())
+#else
+    // The top of stack is kept in tos and sp points at its slot. Everything
+    // below it is in memory. SPILL writes tos back and updates the Stack so
+    // its functions can be used and RELOAD picks up any changes they made.
+    // fp points at the params and locals of the current function. The
+    // SetFrame check makes sure nothing in the function can overrun.
+    #define CLOVER_CHECK_EACH()
+    uint32_t* const base = _stack.data();
+    uint32_t* sp;
+    uint32_t* fp;
+    uint32_t tos;
+    uint32_t popped;
+    
+    #define PUSH(v) do { uint32_t pushed = (v); *sp++ = tos; tos = pushed; } while (0)
+    #define POP() (popped = tos, tos = *--sp, popped)
+    #define POP_ADDR() Address::fromVar(POP())
+    #define TOP() tos
+    #define SWAP() do { popped = tos; tos = sp[-1]; sp[-1] = popped; } while (0)
+    #define LOCAL(i) fp[i]
+    #define SPILL() do { *sp = tos; _stack.setSP(sp - base + 1); } while (0)
+    #define RELOAD() do { sp = base + _stack.sp() - 1; tos = *sp; fp = base + _stack.bp(); } while (0)
+    #define DEPTH() uint16_t(sp - base + 1)
+    
+    RELOAD();
+#endif
+
+    // A test on every instruction costs too much here, so the budget is
+    // charged at each If, Jump, Call and Return with the instructions run
+    // since the last one. Code between them is a straight line, so this
+    // count is exact, but the code can run past the budget to the next of
+    // these. With no budget set, the count just starts over.
+    const Instr* start = ip;
+    uint32_t remaining = _budget ? _budget : 0xffffffff;
+    #define CLOVER_CHECK_BUDGET() do { \
+        uint32_t used = uint32_t(cur - start) + 1; \
+        start = ip; \
+        if (used < remaining) { \
+            remaining -= used; \
+        } else if (_budget) { \
+            goto Suspend; \
+        } else { \
+            remaining = 0xffffffff; \
+        } \
+    } while (0)
+
+#if CLOVER_PROFILE
+    #define CLOVER_PROFILE_EACH() profileOp(getUInt8ROM(cur->addr), DEPTH())
+#else
+    #define CLOVER_PROFILE_EACH()
+#endif
+
+#if CLOVER_THREADED
+    #define OPCODE(op) L_##op:
+    #define NEXT() do { CLOVER_CHECK_EACH(); cur = ip++; CLOVER_PROFILE_EACH(); goto *cur->handler; } while (0)
+    
+    NEXT();
+    {
+#else
+    #define OPCODE(op) case DecodedOp::op:
+    #define NEXT() break
+
+    while (true) {
+        CLOVER_CHECK_EACH();
+        cur = ip++;
+        CLOVER_PROFILE_EACH();
+        
+        switch(cur->op) {
+            default:
+#endif
+            OPCODE(Invalid)
+                _error = Error::InvalidOp;
+                _errorAddr = cur->addr;
+                return -1;
+            OPCODE(PushImm)
+                PUSH(cur->value);
+                NEXT();
+            OPCODE(PushGlobal)
+                PUSH(_global[cur->value]);
+                NEXT();
+            OPCODE(PushLocal)
+                PUSH(LOCAL(cur->value));
+                NEXT();
+            OPCODE(PopGlobal)
+                _global[cur->value] = POP();
+                NEXT();
+            OPCODE(PopLocal)
+                value = POP();
+                LOCAL(cur->value) = value;
+                NEXT();
+            OPCODE(PushRefLocal)
+                PUSH(_stack.toAbsAddress(cur->value).toVar());
+                NEXT();
+            OPCODE(PushDeref)
+                addr = POP_ADDR();
+                PUSH(loadInt(addr));
+                CLOVER_CHECK_ERROR();
+                NEXT();
+            OPCODE(PopDeref)
+                value = POP();
+                addr = POP_ADDR();
+                storeInt(addr, value);
+                CLOVER_CHECK_ERROR();
+                NEXT();
+            OPCODE(Offset)
+                TOP() += cur->index;
+                NEXT();
+            OPCODE(Index)
+                value = POP();
+                TOP() += value * cur->index;
+                NEXT();
+            OPCODE(Dup)
+                PUSH(TOP());
+                NEXT();
+            OPCODE(Drop)
+                POP();
+                NEXT();
+            OPCODE(Swap)
+                SWAP();
+                NEXT();
+            OPCODE(If)
+                if (POP() == 0) {
+                    ip = _decoded + cur->value;
+                }
+                CLOVER_CHECK_BUDGET();
+                NEXT();
+            OPCODE(Jump)
+                ip = _decoded + cur->value;
+                CLOVER_CHECK_BUDGET();
+                NEXT();
+            OPCODE(AddIntConst)
+                TOP() += cur->value;
+                NEXT();
+            OPCODE(Push2)
+                PUSH(loadInt(Address::fromVar(cur->value >> 16)));
+                PUSH(loadInt(Address::fromVar(cur->value & 0xffff)));
+                NEXT();
+            OPCODE(Push2Local)
+                PUSH(LOCAL(cur->value >> 16));
+                PUSH(LOCAL(cur->value & 0xffff));
+                NEXT();
+            OPCODE(StoreLocalConst)
+                LOCAL(cur->value >> 16) = cur->value & 0xffff;
+                NEXT();
+            OPCODE(StoreGlobalConst)
+                _global[cur->value >> 16] = cur->value & 0xffff;
+                NEXT();
+            OPCODE(AddToLocal)
+                value = POP();
+                LOCAL(cur->value) += value;
+                NEXT();
+            OPCODE(AddToGlobal)
+                _global[cur->value] += POP();
+                NEXT();
+                
+            #define CLOVER_IF_INT(op, cmp) \
+            OPCODE(op) \
+                value = POP(); \
+                if (!(int32_t(POP()) cmp int32_t(value))) { \
+                    ip = _decoded + cur->value; \
+                } \
+                CLOVER_CHECK_BUDGET(); \
+                NEXT();
+                
+            CLOVER_IF_INT(IfLTInt, <)
+            CLOVER_IF_INT(IfLEInt, <=)
+            CLOVER_IF_INT(IfEQInt, ==)
+            CLOVER_IF_INT(IfNEInt, !=)
+            CLOVER_IF_INT(IfGEInt, >=)
+            CLOVER_IF_INT(IfGTInt, >)
+            #undef CLOVER_IF_INT
+
+            OPCODE(IncLoopLTInt)
+                addr = Address::fromId(idFromSid(uint8_t(cur->value >> 16)));
+                value = int32_t(loadInt(addr)) + 1;
+                storeInt(addr, value);
+                if (int32_t(value) < int32_t(loadInt(Address::fromId(idFromSid(uint8_t(cur->value >> 24)))))) {
+                    ip = _decoded + uint16_t(cur->value);
+                }
+                CLOVER_CHECK_BUDGET();
+                NEXT();
+            OPCODE(IncLoopLTIntConst)
+                addr = Address::fromId(idFromSid(uint8_t(cur->value >> 16)));
+                value = int32_t(loadInt(addr)) + 1;
+                storeInt(addr, value);
+                if (int32_t(value) < int32_t(cur->value >> 24)) {
+                    ip = _decoded + uint16_t(cur->value);
+                }
+                CLOVER_CHECK_BUDGET();
+                NEXT();
+            OPCODE(IncLoopLTIntLocal)
+                value = LOCAL(uint8_t(cur->value >> 16)) + 1;
+                LOCAL(uint8_t(cur->value >> 16)) = value;
+                if (int32_t(value) < int32_t(LOCAL(cur->value >> 24))) {
+                    ip = _decoded + uint16_t(cur->value);
+                }
+                CLOVER_CHECK_BUDGET();
+                NEXT();
+            OPCODE(IncLoopLTIntConstLocal)
+                value = LOCAL(uint8_t(cur->value >> 16)) + 1;
+                LOCAL(uint8_t(cur->value >> 16)) = value;
+                if (int32_t(value) < int32_t(cur->value >> 24)) {
+                    ip = _decoded + uint16_t(cur->value);
+                }
+                CLOVER_CHECK_BUDGET();
+                NEXT();
+
+            OPCODE(Log)
+                SPILL();
+                logFromROM(uint16_t(cur->value), uint8_t(cur->value >> 16), cur->index);
+                RELOAD();
+                NEXT();
+            OPCODE(Call)
+                PUSH(uint32_t(ip - _decoded));
+                ip = _decoded + cur->value;
+                CLOVER_CHECK_BUDGET();
+                NEXT();
+            OPCODE(CallNoFrame)
+                _error = Error::ExpectedSetFrame;
+                _errorAddr = cur->addr;
+                return -1;
+            OPCODE(CallNative)
+                SPILL();
+                if (!callNative(cur->value)) {
+                    return -1;
+                }
+                CLOVER_CHECK_ERROR();
+                RELOAD();
+                NEXT();
+            OPCODE(Return) {
+#if CLOVER_PROFILE
+                profileReturn();
+#endif
+                SPILL();
+                uint32_t retVal = _stack.empty() ? 0 : _stack.pop();
+                
+                if (_stack.empty()) {
+                    // Returning from top level
+                    return 0;
+                }
+                
+                // TOS has return value. Pop it and push it back after restore
+                int16_t next = _stack.restoreFrame(retVal);
+                
+                // A next of -1 returns from top level
+                if (next < 0) {
+                    // retVal was pushed, get rid of it
+                    _stack.pop();
+                    return retVal;
+                }
+                ip = _decoded + next;
+                CLOVER_CHECK_ERROR();
+                RELOAD();
+                CLOVER_CHECK_BUDGET();
+                NEXT();
+            }
+            OPCODE(SetFrame)
+#if CLOVER_PROFILE
+                profileEnter(cur->addr);
+#endif
+                SPILL();
+#if !CLOVER_CHECKED_STACK
+                // setFrame replaces the return pc with the locals, pc and
+                // bp. The function's operand stack goes on top of that.
+                if (_stack.sp() + uint8_t(cur->value) + 1 + int16_t(cur->value >> 8) > _stack.size()) {
+                    _error = Error::StackOverrun;
+                    _errorAddr = cur->addr;
+                    return -1;
+                }
+#endif
+                if (!_stack.setFrame(cur->index, uint8_t(cur->value))) {
+                    return -1;
+                }
+                RELOAD();
+                NEXT();
+
+            OPCODE(Or)      value = POP(); TOP() |= value; NEXT();
+            OPCODE(Xor)     value = POP(); TOP() ^= value; NEXT();
+            OPCODE(And)     value = POP(); TOP() &= value; NEXT();
+            OPCODE(Not)     TOP() = ~TOP(); NEXT();
+            OPCODE(LNot)    TOP() = !TOP(); NEXT();
+
+            OPCODE(LOr) {
+                bool l = POP() != 0;
+                bool r = POP() != 0;
+                PUSH(l || r);
+                NEXT();
+            }
+            OPCODE(LAnd) {
+                bool l = POP() != 0;
+                bool r = POP() != 0;
+                PUSH(l && r);
+                NEXT();
+            }
+
+            OPCODE(LTInt)
+                value = POP();
+                TOP() = int32_t(TOP()) < int32_t(value);
+                NEXT();
+            OPCODE(LTFloat)
+                value = POP();
+                TOP() = intToFloat(TOP()) < intToFloat(value);
+                NEXT();
+            OPCODE(LEInt)
+                value = POP();
+                TOP() = int32_t(TOP()) <= int32_t(value);
+                NEXT();
+            OPCODE(LEFloat)
+                value = POP();
+                TOP() = intToFloat(TOP()) <= intToFloat(value);
+                NEXT();
+            OPCODE(EQInt)
+                value = POP();
+                TOP() = int32_t(TOP()) == int32_t(value);
+                NEXT();
+            OPCODE(EQFloat)
+                value = POP();
+                TOP() = intToFloat(TOP()) == intToFloat(value);
+                NEXT();
+            OPCODE(NEInt)
+                value = POP();
+                TOP() = int32_t(TOP()) != int32_t(value);
+                NEXT();
+            OPCODE(NEFloat)
+                value = POP();
+                TOP() = intToFloat(TOP()) != intToFloat(value);
+                NEXT();
+            OPCODE(GEInt)
+                value = POP();
+                TOP() = int32_t(TOP()) >= int32_t(value);
+                NEXT();
+            OPCODE(GEFloat)
+                value = POP();
+                TOP() = intToFloat(TOP()) >= intToFloat(value);
+                NEXT();
+            OPCODE(GTInt)
+                value = POP();
+                TOP() = int32_t(TOP()) > int32_t(value);
+                NEXT();
+            OPCODE(GTFloat)
+                value = POP();
+                TOP() = intToFloat(TOP()) > intToFloat(value);
+                NEXT();
+
+            OPCODE(AddInt)
+                value = POP();
+                TOP() = int32_t(TOP()) + int32_t(value);
+                NEXT();
+            OPCODE(AddFloat)
+                value = POP();
+                TOP() = floatToInt(intToFloat(TOP()) + intToFloat(value));
+                NEXT();
+            OPCODE(SubInt)
+                value = POP();
+                TOP() = int32_t(TOP()) - int32_t(value);
+                NEXT();
+            OPCODE(SubFloat)
+                value = POP();
+                TOP() = floatToInt(intToFloat(TOP()) - intToFloat(value));
+                NEXT();
+            OPCODE(MulInt)
+                value = POP();
+                TOP() = int32_t(TOP()) * int32_t(value);
+                NEXT();
+            OPCODE(MulFloat)
+                value = POP();
+                TOP() = floatToInt(intToFloat(TOP()) * intToFloat(value));
+                NEXT();
+            OPCODE(DivInt)
+                value = POP();
+#if CLOVER_CHECKED_DIVIDE
+                if (intDivFails(TOP(), value)) {
+                    _error = Error::DivideByZero;
+                    CLOVER_CHECK_ERROR();
+                }
+#endif
+                TOP() = int32_t(TOP()) / int32_t(value);
+                NEXT();
+            OPCODE(DivFloat)
+                value = POP();
+                TOP() = floatToInt(intToFloat(TOP()) / intToFloat(value));
+                NEXT();
+            OPCODE(NegInt)
+                TOP() = -int32_t(TOP());
+                NEXT();
+            OPCODE(NegFloat)
+                TOP() = floatToInt(-intToFloat(TOP()));
+                NEXT();
+            OPCODE(MulFixed)
+                value = POP();
+                TOP() = fixedMul(TOP(), value);
+                NEXT();
+            OPCODE(DivFixed)
+                value = POP();
+#if CLOVER_CHECKED_DIVIDE
+                if (value == 0) {
+                    _error = Error::DivideByZero;
+                    CLOVER_CHECK_ERROR();
+                }
+#endif
+                TOP() = fixedDiv(TOP(), value);
+                NEXT();
+
+            OPCODE(PreIncInt) {
+                addr = POP_ADDR();
+                int32_t v = int32_t(loadInt(addr)) + 1;
+                storeInt(addr, v);
+                PUSH(v);
+                CLOVER_CHECK_ERROR();
+                NEXT();
+            }
+            OPCODE(PreDecInt) {
+                addr = POP_ADDR();
+                int32_t v = int32_t(loadInt(addr)) - 1;
+                storeInt(addr, v);
+                PUSH(v);
+                CLOVER_CHECK_ERROR();
+                NEXT();
+            }
+            OPCODE(PostIncInt) {
+                addr = POP_ADDR();
+                int32_t v = int32_t(loadInt(addr));
+                storeInt(addr, v + 1);
+                PUSH(v);
+                CLOVER_CHECK_ERROR();
+                NEXT();
+            }
+            OPCODE(PostDecInt) {
+                addr = POP_ADDR();
+                int32_t v = int32_t(loadInt(addr));
+                storeInt(addr, v - 1);
+                PUSH(v);
+                CLOVER_CHECK_ERROR();
+                NEXT();
+            }
+            OPCODE(PreIncFloat) {
+                addr = POP_ADDR();
+                float v = loadFloat(addr) + 1;
+                storeFloat(addr, v);
+                PUSH(floatToInt(v));
+                CLOVER_CHECK_ERROR();
+                NEXT();
+            }
+            OPCODE(PreDecFloat) {
+                addr = POP_ADDR();
+                float v = loadFloat(addr) - 1;
+                storeFloat(addr, v);
+                PUSH(floatToInt(v));
+                CLOVER_CHECK_ERROR();
+                NEXT();
+            }
+            OPCODE(PostIncFloat) {
+                addr = POP_ADDR();
+                float v = loadFloat(addr);
+                storeFloat(addr, v + 1);
+                PUSH(floatToInt(v));
+                CLOVER_CHECK_ERROR();
+                NEXT();
+            }
+            OPCODE(PostDecFloat) {
+                addr = POP_ADDR();
+                float v = loadFloat(addr);
+                storeFloat(addr, v - 1);
+                PUSH(floatToInt(v));
+                CLOVER_CHECK_ERROR();
+                NEXT();
+            }
+            OPCODE(PreIncFixed) {
+                addr = POP_ADDR();
+                int32_t v = int32_t(loadInt(addr)) + FixedOne;
+                storeInt(addr, v);
+                PUSH(v);
+                CLOVER_CHECK_ERROR();
+                NEXT();
+            }
+            OPCODE(PreDecFixed) {
+                addr = POP_ADDR();
+                int32_t v = int32_t(loadInt(addr)) - FixedOne;
+                storeInt(addr, v);
+                PUSH(v);
+                CLOVER_CHECK_ERROR();
+                NEXT();
+            }
+            OPCODE(PostIncFixed) {
+                addr = POP_ADDR();
+                int32_t v = int32_t(loadInt(addr));
+                storeInt(addr, v + FixedOne);
+                PUSH(v);
+                CLOVER_CHECK_ERROR();
+                NEXT();
+            }
+            OPCODE(PostDecFixed) {
+                addr = POP_ADDR();
+                int32_t v = int32_t(loadInt(addr));
+                storeInt(addr, v - FixedOne);
+                PUSH(v);
+                CLOVER_CHECK_ERROR();
+                NEXT();
+            }
+#if !CLOVER_THREADED
         }
+#endif
     }
+
+Suspend:
+    // ip is the next instruction to run
+    SPILL();
+    _resumeInstr = uint16_t(ip - _decoded);
+    _suspended = true;
+    return Suspended;
+    
+    #undef OPCODE
+    #undef NEXT
+    #undef CLOVER_CHECK_BUDGET
+    #undef CLOVER_CHECK_ERROR
+    #undef CLOVER_CHECK_EACH
+    #undef CLOVER_PROFILE_EACH
+    #undef PUSH
+    #undef POP
+    #undef POP_ADDR
+    #undef TOP
+    #undef SWAP
+    #undef LOCAL
+    #undef SPILL
+    #undef RELOAD
+    #undef DEPTH
 }
+#endif
 
 // Return -1 if we just finished going down, or 1 
 // if we just finished going up. Otherwise return 0.
@@ -507,47 +2190,119 @@ Interpreter::animate(uint32_t index)
     return 0;
 }
 
+int32_t
+Interpreter::animateFixed(uint32_t index)
+{
+    // Same as animate() but the struct has fixed values
+    Address addr = Address::fromVar(index);
+    int32_t cur = loadInt(addr, 0);
+    int32_t inc = loadInt(addr, 1);
+    int32_t min = loadInt(addr, 2);
+    int32_t max = loadInt(addr, 3);
+
+    cur = int32_t(uint32_t(cur) + uint32_t(inc));
+    storeInt(addr, 0, cur);
+
+    if (0 < inc) {
+        if (cur >= max) {
+            cur = max;
+            inc = -inc;
+            storeInt(addr, 0, cur);
+            storeInt(addr, 1, inc);
+            return 1;
+        }
+    } else {
+        if (cur <= min) {
+            cur = min;
+            inc = -inc;
+            storeInt(addr, 0, cur);
+            storeInt(addr, 1, inc);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// A number is formatted the way String (on Arduino) or std::to_string would
+// format it, into a buffer on the stack
+static constexpr uint8_t LogNumberSize = 50;
+
+static void formatInt(int32_t v, char* buf)
+{
+#ifdef ARDUINO
+    ltoa(v, buf, 10);
+#else
+    snprintf(buf, LogNumberSize, "%d", int(v));
+#endif
+}
+
+static void formatFloat(float v, char* buf)
+{
+#ifdef ARDUINO
+    dtostrf(v, 4, 2, buf);
+#else
+    snprintf(buf, LogNumberSize, "%f", double(v));
+#endif
+}
+
+template<typename Read>
 bool
-Interpreter::log(const char* fmt, uint8_t numArgs)
+Interpreter::logFormat(Read read, uint16_t len, uint8_t numArgs)
 {
     // This is a very simplified version of printf. It
     // handles '%i' and '%f'
+    char chunk[LogChunkSize + 1];
+    uint8_t n = 0;
     uint8_t arg = numArgs;
+    bool ok = true;
+    
+    auto flush = [&]()
+    {
+        if (n) {
+            chunk[n] = '\0';
+            log(chunk);
+            n = 0;
+        }
+    };
     
-    for (int i = 0; ; ) {
-        char c[2];;
-        c[1] = '\0';
-        c[0] = fmt[i++];
-        if (c[0] == '\0') {
+    for (uint16_t i = 0; i < len; ) {
+        char c = read(i++);
+        if (c == '\0') {
             break;
         }
         
-        if (c[0] == '%') {
-            c[0] = fmt[i++];
-            if (c[0] == '%') {
-                log(c);
-            } else if (c[0] == 'i') {
+        if (c == '%') {
+            c = (i < len) ? read(i++) : '\0';
+            if (c == 'i' || c == 'f') {
                 if (arg == 0) {
-                    return false;
+                    ok = false;
+                    break;
                 }
-                String v = to_string(int32_t(_stack.top(arg - 1)));
-                --arg;
-                log(v.c_str());
-            } else if (c[0] == 'f') {
-                if (arg == 0) {
-                    return false;
+                flush();
+                
+                char num[LogNumberSize];
+                uint32_t v = _stack.top(--arg);
+                if (c == 'i') {
+                    formatInt(int32_t(v), num);
+                } else {
+                    formatFloat(intToFloat(v), num);
                 }
-                String v = to_string(intToFloat(_stack.top(arg - 1)));
-                --arg;
-                log(v.c_str());
-            } else {
-                return false;
+                log(num);
+                continue;
             }
-        } else {
-            log(c);
+            if (c != '%') {
+                ok = false;
+                break;
+            }
+        }
+        
+        chunk[n++] = c;
+        if (n == LogChunkSize) {
+            flush();
         }
     }
     
+    flush();
     _stack.pop(numArgs);
-    return true;
+    return ok;
 }
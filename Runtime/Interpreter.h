@@ -11,28 +11,18 @@
 //
 #pragma once
 
+#include "Compressed.h"
 #include "Opcodes.h"
+#include "Verifier.h"
 
 #include <stdlib.h>
 #include <string.h>
 
 #ifdef ARDUINO
     #include <Arduino.h>
-    static inline String to_string(int32_t v) { return String(v); }
-    static inline String to_string(float v) { return String(v); }
 #else
     #include <string>
     
-    static inline void randomSeed(uint32_t s) { srand(s); }
-    static inline int32_t random(int32_t min, int32_t max)
-    {
-        if (min >= max) {
-            return max;
-        }
-        int r = rand() % (max - min);
-        return r + min;
-    }
-    
     template<class T> 
     const T& min(const T& a, const T& b)
     {
@@ -44,10 +34,87 @@
     {
         return (b > a) ? b : a;
     }
-    
-    using String = std::string;
-    static inline String to_string(int32_t v) { return std::to_string(v); }
-    static inline String to_string(float v) { return std::to_string(v); }
+#endif
+
+// CLOVER_PREDECODE enables the predecoded execution mode. It is on by default
+// everywhere except Arduino, where RAM is too small to hold the decoded
+// instruction array. When the compiler supports labels as values (gcc and
+// clang) the decoded instructions are run with direct threaded dispatch.
+#ifndef CLOVER_PREDECODE
+    #ifdef ARDUINO
+        #define CLOVER_PREDECODE 0
+    #else
+        #define CLOVER_PREDECODE 1
+    #endif
+#endif
+
+#if CLOVER_PREDECODE && defined(__GNUC__)
+    #define CLOVER_THREADED 1
+#else
+    #define CLOVER_THREADED 0
+#endif
+
+// CLOVER_CHECKED_STACK makes the predecoded mode check the stack bounds on
+// every push and pop, like the interpreted mode does. Otherwise the top of
+// the stack is kept in a register and the maximum depth each function can
+// reach (found by the Verifier) is checked once at its SetFrame.
+// Turn it on to debug code that gets a stack error.
+#ifndef CLOVER_CHECKED_STACK
+    #define CLOVER_CHECKED_STACK 0
+#endif
+
+// CLOVER_CHECKED_DIVIDE makes DivInt and DivFixed fail with DivideByZero
+// when the divisor is 0, or the result doesn't fit as with INT32_MIN / -1,
+// rather than trapping. That takes the process down on a host, which is
+// where the compiler runs code to make tables. On an AVR it just gives a
+// wrong result, so it's off there to save the test.
+#ifndef CLOVER_CHECKED_DIVIDE
+    #ifdef ARDUINO
+        #define CLOVER_CHECKED_DIVIDE 0
+    #else
+        #define CLOVER_CHECKED_DIVIDE 1
+    #endif
+#endif
+
+// CLOVER_ROM_CACHE_PAGES is the number of CLOVER_ROM_PAGE_SIZE byte pages of
+// ROM kept in RAM. Pages are filled with a single romRead() call. This
+// avoids a virtual call (and an EEPROM access on Arduino) for every opcode
+// and operand byte in hot loops. Setting it to 0 turns off the cache.
+#ifndef CLOVER_ROM_CACHE_PAGES
+    #ifdef ARDUINO
+        #define CLOVER_ROM_CACHE_PAGES 4
+    #else
+        #define CLOVER_ROM_CACHE_PAGES 0
+    #endif
+#endif
+
+#ifndef CLOVER_ROM_PAGE_SIZE
+    #define CLOVER_ROM_PAGE_SIZE 16
+#endif
+
+// CLOVER_COMPRESSED_ROM lets load() take a compressed executable (see
+// Compressed.h). Reads of ROM then go through a single decompressed 64
+// byte page in RAM, which is refilled when a read is outside it. Setting
+// it to 0 saves that RAM and the decoder when uploads aren't compressed.
+#ifndef CLOVER_COMPRESSED_ROM
+    #define CLOVER_COMPRESSED_ROM 1
+#endif
+
+// CLOVER_PROFILE counts what the interpreted and predecoded modes execute,
+// see Interpreter::profile(). It adds work to every instruction, so it's
+// off by default. CLOVER_PROFILE_FUNCTIONS is the most functions counted
+// and CLOVER_PROFILE_DEPTH the deepest nesting of calls whose instructions
+// are counted.
+#ifndef CLOVER_PROFILE
+    #define CLOVER_PROFILE 0
+#endif
+
+#ifndef CLOVER_PROFILE_FUNCTIONS
+    #define CLOVER_PROFILE_FUNCTIONS 32
+#endif
+
+#ifndef CLOVER_PROFILE_DEPTH
+    #define CLOVER_PROFILE_DEPTH 16
 #endif
 
 namespace clvr {
@@ -59,7 +126,6 @@ static constexpr uint8_t StackOverhead = 64;    // Amount added to var mem high
 static constexpr uint8_t MaxTempSize = 32;      // Allocator uses a uint32_t map. That would 
                                                 // need to be changed to increase this.
 static constexpr uint8_t ParamsSize = 16;       // Constrained by the 4 bit field with the index
-static constexpr uint16_t ConstOffset = 10;
 
 static inline float intToFloat(uint32_t i)
 {
@@ -75,6 +141,70 @@ static inline uint32_t floatToInt(float f)
     return i;
 }
 
+// Fixed point values are Q16.16 in an int32_t. They don't need an FPU
+static constexpr uint8_t FixedFracBits = 16;
+static constexpr int32_t FixedOne = int32_t(1) << FixedFracBits;
+
+static inline int32_t intToFixed(int32_t i) { return int32_t(uint32_t(i) << FixedFracBits); }
+static inline int32_t floatToFixed(float f) { return int32_t(f * FixedOne + ((f < 0) ? -0.5f : 0.5f)); }
+static inline float fixedToFloat(int32_t f) { return float(f) / FixedOne; }
+
+// Truncates toward 0, like converting a float to an int
+static inline int32_t fixedToInt(int32_t f)
+{
+    return (f < 0) ? -int32_t((0 - uint32_t(f)) >> FixedFracBits) : (f >> FixedFracBits);
+}
+
+static inline int32_t fixedMul(int32_t a, int32_t b)
+{
+    // Multiply the 16 bit halves so this doesn't need a 64 bit multiply,
+    // which is slow on AVR. Unsigned so overflow wraps like MulInt. The
+    // low 32 bits of a product are the same signed or unsigned.
+    uint32_t ah = uint32_t(a >> FixedFracBits);
+    uint32_t bh = uint32_t(b >> FixedFracBits);
+    uint32_t al = uint32_t(a) & 0xffff;
+    uint32_t bl = uint32_t(b) & 0xffff;
+    return int32_t(((ah * bh) << FixedFracBits) + ah * bl + al * bh + ((al * bl) >> FixedFracBits));
+}
+
+// The one int divide that overflows is INT32_MIN / -1
+static inline bool intDivFails(int32_t a, int32_t b)
+{
+    return b == 0 || (a == INT32_MIN && b == -1);
+}
+
+// A shift and subtract divide of a << 16 by b, a quotient bit at a time.
+// A 64 bit divide is a slow library call on AVR, slower than soft float.
+// Leading 0 bits of a are skipped, so small values take fewer steps. The
+// quotient truncates toward 0 and overflow wraps, like DivInt. A b of 0
+// gives garbage (see CLOVER_CHECKED_DIVIDE).
+static inline int32_t fixedDiv(int32_t a, int32_t b)
+{
+    bool negative = (a < 0) != (b < 0);
+    uint32_t n = (a < 0) ? (0 - uint32_t(a)) : uint32_t(a);
+    uint32_t d = (b < 0) ? (0 - uint32_t(b)) : uint32_t(b);
+    
+    uint8_t bits = 32 + FixedFracBits;
+    while (bits > FixedFracBits && !(n & 0x80000000)) {
+        n <<= 1;
+        --bits;
+    }
+    
+    // d is at most 2^31 and r is kept below it, so r << 1 fits
+    uint32_t q = 0;
+    uint32_t r = 0;
+    while (bits--) {
+        r = (r << 1) | (n >> 31);
+        n <<= 1;
+        q <<= 1;
+        if (r >= d) {
+            r -= d;
+            q |= 1;
+        }
+    }
+    return int32_t(negative ? (0 - q) : q);
+}
+
 //
 // Core Native Functions
 //
@@ -97,6 +227,36 @@ public:
 #endif
 };
 
+// Program
+//
+// The parsed header of the executable in ROM. It is filled in by
+// Interpreter::load() and doesn't change until the next load().
+struct Program
+{
+    uint16_t constSize = 0;     // In 4 byte units
+    uint16_t globalSize = 0;    // In 4 byte units
+    uint16_t stackSize = 0;     // In 4 byte units
+    uint16_t commandStart = 0;  // ROM addr of the first command entry
+    uint16_t codeOffset = 0;    // ROM addr of the first instruction
+    uint8_t numCommands = 0;
+    bool loaded = false;
+    
+    // Set if ROM has a compressed executable. size is its size when it
+    // isn't compressed, which is what all ROM addrs refer to
+    bool compressed = false;
+    uint16_t size = 0;
+    
+    // Set if the code passed the Verifier. maxDepth is the deepest the
+    // operand stack gets in any function. stackBounded is set if the
+    // Verifier found every command fits in the stack with everything it
+    // calls, so SetFrame doesn't have to check it
+    bool verified = false;
+    uint8_t maxDepth = 0;
+    bool stackBounded = false;
+    Verifier::Error verifyError = Verifier::Error::None;
+    int16_t verifyErrorAddr = -1;
+};
+
 class Interpreter
 {
 public:
@@ -115,58 +275,282 @@ public:
         StackOverrun,
         StackUnderrun,
         StackOutOfRange,
+        NativeIdConflict,
+        OutOfMemory,
+        DivideByZero,
     };
 
-    Interpreter(NativeModule** mod = nullptr, uint32_t modSize = 0);
+    // Interpreted fetches and decodes each opcode from rom() as it is executed.
+    // Predecoded translates the code once at init() into an array of
+    // instructions with resolved operands and jump targets and runs that.
+    // If CLOVER_PREDECODE is 0, Predecoded falls back to Interpreted.
+    enum class ExecMode { Interpreted, Predecoded };
+
+    // With an arena, everything the Interpreter needs comes out of the
+    // arenaSize bytes at arena and it never uses the heap. The native
+    // module table is taken here. Each load() takes the globals and stack
+    // (sized from the header) after that and the rest is scratch for the
+    // Verifier. If they don't fit load() and init() fail
+    // with OutOfMemory. Predecoded needs the heap, so with an arena it
+    // falls back to Interpreted unless load(image) shares the instructions
+    // of an image without one. The arena must outlive the Interpreter.
+    Interpreter(NativeModule** mod = nullptr, uint32_t modSize = 0, uint8_t* arena = nullptr, uint16_t arenaSize = 0);
     ~Interpreter();
     
+    // Bytes of the arena in use after load(), not counting scratch
+    uint16_t arenaUsed() const { return _arenaUsed; }
+    
+    // Takes effect at the next load()
+    void setExecMode(ExecMode mode)
+    {
+        if (mode != _execMode) {
+            _execMode = mode;
+            _program.loaded = false;
+        }
+    }
+    ExecMode execMode() const { return _execMode; }
+
+    // Parse the executable header, verify the code and size the globals
+    // and stack. This is done by the first init() or findCommand(). Call
+    // it again after uploading a new executable. Code that doesn't pass
+    // the Verifier still runs, but every instruction is checked.
+    bool load();
+    
+    // Share the executable loaded by image rather than loading it again.
+    // Only the globals, stack and params belong to this Interpreter, so
+    // many instances can run one executable. rom() must return the same
+    // bytes as it does for image, and image must not be loaded again or
+    // destroyed while this uses it. The native modules must match.
+    bool load(const Interpreter& image);
+    
+    const Program& program() const { return _program; }
+    
+    // Returns the index of the command or -1 if not found
+    int16_t findCommand(const char* cmd);
+    
+    // Start a command by name or by index. Switching commands by index
+    // doesn't search the command table or reallocate anything.
     bool init(const char* cmd, const uint8_t* buf, uint8_t size);
+    bool init(uint8_t index, const uint8_t* buf, uint8_t size);
     int32_t loop();
+    
+    // Budgeted execution
+    //
+    // With a budget of n, init(), loop() and resume() return after at most
+    // n instructions, so the caller can service serial input or LEDs in a
+    // long init or loop. If the code isn't done it's suspended, with its
+    // pc and stack saved. init() returns true, loop() and resume() return
+    // Suspended and suspended() is true. resume() continues it, returning
+    // what loop() would have (0 for init). Calling init() or loop() while
+    // suspended drops the suspended code. A budget of 0 (the default) runs
+    // to the end. Predecoded code only checks the budget at jumps, calls
+    // and returns, so it can go over by the rest of a straight run of
+    // code. Compiled code ignores the budget.
+    static constexpr int32_t Suspended = -2;
+    
+    void setBudget(uint32_t n) { _budget = n; }
+    uint32_t budget() const { return _budget; }
+    bool suspended() const { return _suspended; }
+    int32_t resume();
+    
+    // Words in use on the stack. Only meaningful between calls, for
+    // instance while suspended
+    uint16_t stackDepth() const { return uint16_t(_stack.sp()); }
+
+#if CLOVER_PROFILE
+    // Profiling
+    //
+    // Every instruction is counted by opcode (ext opcodes by their upper 4
+    // bits) and every native call by id (the module is the upper 4 bits).
+    // Functions are counted by the ROM address of their SetFrame, which is
+    // their Call target. A function's instrs include those of the functions
+    // it calls, so a recursive function counts its inner calls more than
+    // once. Counts add up until resetProfile(). Compiled code only counts
+    // native calls.
+    struct FunctionProfile
+    {
+        uint16_t addr = 0;
+        uint32_t calls = 0;
+        uint32_t instrs = 0;
+    };
+    
+    struct Profile
+    {
+        uint32_t instrs = 0;
+        uint16_t maxStack = 0;          // In 4 byte units
+        uint32_t ops[256] = { };
+        uint32_t natives[256] = { };
+        FunctionProfile functions[CLOVER_PROFILE_FUNCTIONS];
+        uint8_t numFunctions = 0;
+    };
+    
+    const Profile& profile() const { return _profile; }
+    void resetProfile() { _profile = Profile(); _profileDepth = 0; }
+#endif
 
     Error error() const { return _error; }
     
     // Returns -1 if error was not at any pc addr
     int16_t errorAddr() const { return _errorAddr; }
     
-	// Return a float with a random number between min and max.
-	// The random function takes ints. Multiply inputs by 1000 then divide the result
-    // by the same to get a floating point result. That effectively makes the range
-    // +/-2,000,000.
-	static float random(float min, float max)
-	{
-		return float(::random(int32_t(min * 1000), int32_t(max * 1000))) / 1000;
-	}
-	
-	static int32_t random(int32_t min, int32_t max)
-	{
-		int32_t r = ::random(min, max);
-		return r;
-	}
+    // Random numbers
+    //
+    // Each Interpreter has its own xorshift32 generator, so instances don't
+    // share a sequence and a run can be repeated by seeding it the same way.
+    // It starts out seeded with DefaultRandomSeed and isn't reseeded by
+    // load() or init(). A seed of 0 would stick at 0, so it's taken as
+    // DefaultRandomSeed. A range is mapped with a multiply and shift of the
+    // high bits rather than a %, which is a slow division on AVR and would
+    // use the weaker low bits.
+    static constexpr uint32_t DefaultRandomSeed = 0x2545f491;
+    
+    void seedRandom(uint32_t seed) { _random = seed ? seed : DefaultRandomSeed; }
+    
+    uint32_t randomBits()
+    {
+        _random ^= _random << 13;
+        _random ^= _random >> 17;
+        _random ^= _random << 5;
+        return _random;
+    }
+    
+    // Returns min up to but not including max, or max if min >= max
+    int32_t random(int32_t min, int32_t max)
+    {
+        if (min >= max) {
+            return max;
+        }
+        uint32_t range = uint32_t(max) - uint32_t(min);
+        uint32_t r;
+        if (range <= 0xffff) {
+            r = ((randomBits() >> 16) * range) >> 16;
+        } else {
+            r = uint32_t((uint64_t(randomBits()) * range) >> 32);
+        }
+        return int32_t(uint32_t(min) + r);
+    }
+    
+    // Uses the top 24 bits, all a float holds
+    float random(float min, float max)
+    {
+        if (min >= max) {
+            return max;
+        }
+        return min + (max - min) * (float(randomBits() >> 8) * (1.0f / 16777216));
+    }
+    
+    // Fill count values at addr with random(min, max)
+    void randomArray(uint32_t addr, int32_t min, int32_t max, uint32_t count);
 
     uint32_t stackLocal(uint16_t addr) const { return _stack.local(addr); }
 
     int32_t animate(uint32_t index);
+    int32_t animateFixed(uint32_t index);
     uint8_t param(uint32_t i) const { return (i >= ParamsSize) ? 0 : _params[i]; }
     void initArray(uint32_t addr, uint32_t value, uint32_t count);
+    
+    // Copy count words from src to dst. src can be a table in ROM.
+    // The arrays can overlap
+    void copyArray(uint32_t dst, uint32_t src, uint32_t count);
+    
+    // addr is a pointer pushed by PushRef. Return the RAM it points to
+    // if count words starting there are all in globals or the stack.
+    // Otherwise set an error and return nullptr
+    uint32_t* arrayAddr(uint32_t addr, uint32_t count);
 
     void setError(Error error) { _error = error; }
 
+    // The constructor and load() invalidate the ROM cache. Call this if
+    // the contents of ROM change at any other time
+    void invalidateROMCache();
+
     virtual uint8_t rom(uint16_t i) const = 0;
     virtual void log(const char* s) const = 0;
+    
+    // Read len bytes of ROM starting at addr into buf. The default calls
+    // rom() for each byte. Override it if the device has a faster way to
+    // read a block
+    virtual void romRead(uint16_t addr, uint8_t* buf, uint16_t len) const
+    {
+        for (uint16_t i = 0; i < len; ++i) {
+            buf[i] = rom(addr + i);
+        }
+    }
+
+    // Ahead of time compiled code
+    //
+    // 'compile -c' translates an executable into a C++ function which runs
+    // it using the Interpreter's stack, globals and native functions. Pass
+    // it to setCompiledCode() and init() and loop() will call it rather
+    // than running the code in ROM. ROM must still have the header,
+    // constants and command entries, which the generated file includes.
+    // The aot functions are only for use by the generated code. The code
+    // is verified when it is generated, so the stack is not checked.
+    using CompiledCode = int32_t (*)(Interpreter*, uint16_t addr);
+    
+    // Takes effect at the next load(). Pass nullptr to run the code in ROM
+    void setCompiledCode(CompiledCode code)
+    {
+        _compiledCode = code;
+        _program.loaded = false;
+    }
+    
+    uint32_t& aotGlobal(uint16_t i) { return _global[i]; }
+    uint32_t& aotLocal(uint8_t i) { return _stack.data()[_stack.bp() + i]; }
+    uint32_t& aotTop() { return _stack.data()[_stack.sp() - 1]; }
+    
+    void aotPush(uint32_t v)
+    {
+        int16_t sp = _stack.sp();
+        _stack.data()[sp] = v;
+        _stack.setSP(sp + 1);
+    }
+    
+    uint32_t aotPop()
+    {
+        int16_t sp = _stack.sp() - 1;
+        _stack.setSP(sp);
+        return _stack.data()[sp];
+    }
+    
+    void aotSwap()
+    {
+        uint32_t* t = _stack.data() + _stack.sp();
+        uint32_t v = t[-1];
+        t[-1] = t[-2];
+        t[-2] = v;
+    }
+    
+    uint32_t aotRef(uint16_t id) const { return _stack.toAbsAddress(id).toVar(); }
+    uint32_t aotLoad(uint32_t ref) { return loadInt(Address::fromVar(ref)); }
+    void aotStore(uint32_t ref, uint32_t v) { storeInt(Address::fromVar(ref), v); }
+    bool aotCallNative(uint8_t id) { return callNative(id); }
+    void aotLog(const char* fmt, uint8_t numArgs);
+    
+    // depth is the deepest the operand stack of the function gets
+    bool aotSetFrame(uint8_t params, uint8_t locals, uint8_t depth);
+    
+    // Returns the pc saved by the call or -1 if returning from the top
+    // level, with the return value in value
+    int16_t aotReturn(uint32_t& value);
+    
+    // Returns true if there was an error, setting errorAddr() to addr
+    bool aotFailed(uint16_t addr);
 
 private:
     // Address:
     //
-    // opcodes with ids have 8 bit addresses. If an address is < GlobalStart
+    // opcodes with ids have 12 bit addresses. If an address is < GlobalStart
     // it is a constant. If it is < LocalStart it is a global address. Otherwise
     // it's a local address. There are two types of local addresses. Those
     // in the opcode are on the stack and relative to the current bp. But when
     // a local address is pushed on the stack (as a 32 bit value) it is
     // "baked" into an absolute stack address so it can be passed as a param.
     // This Address class encapsulates all this. It is an enum with the address
-    // type and an 8 bit value that is the actual offset in the area of memory
+    // type and a 12 bit value that is the actual offset in the area of memory
     // described by the address type. Unlike the id, this offset of always
-    // zero based.
+    // zero based. On the stack it is the type in bits 15:12 and the offset
+    // in bits 11:0, so two of them fit in a decoded instruction's value.
     //
     class Address
     {
@@ -183,10 +567,10 @@ private:
                 addr._addr = id;
             } else if (id < LocalStart) {
                 addr._type = Type::Global;
-                addr._addr = id & 0x3f;
+                addr._addr = id - GlobalStart;
             } else {
                 addr._type = Type::LocalRel;
-                addr._addr = id & 0x3f;
+                addr._addr = id - LocalStart;
             }
             return addr;
         }
@@ -194,12 +578,12 @@ private:
         static Address fromVar(uint32_t v)
         {
             Address addr;
-            addr._type = Type(v >> 8);
-            addr._addr = uint8_t(v);
+            addr._type = Type(v >> 12);
+            addr._addr = uint16_t(v & 0xfff);
             return addr;
         }
         
-        static Address fromLocalAbs(uint8_t a)
+        static Address fromLocalAbs(uint16_t a)
         {
             Address addr;
             addr._type = Type::LocalAbs;
@@ -207,27 +591,51 @@ private:
             return addr;
         }
 
-        uint32_t toVar() { return (uint32_t(_type) << 8) | _addr; }
+        uint32_t toVar() { return (uint32_t(_type) << 12) | _addr; }
 
-        uint8_t addr() const { return _addr; }
+        uint16_t addr() const { return _addr; }
         Type type() const { return _type; }
         
     private:
         Type _type = Type::None;
-        uint8_t _addr = 0;
+        uint16_t _addr = 0;
     };
 
     class Stack
     {
     public:
-        void alloc(uint16_t size)
+        ~Stack() { if (_owned) delete [ ] _stack; }
+        
+        // Use size words at buf, which the stack doesn't own
+        void setBuffer(uint32_t* buf, uint16_t size)
         {
-            if (_stack) {
+            if (_owned) {
                 delete [ ] _stack;
             }
+            _stack = buf;
+            _capacity = 0;
+            _owned = false;
             _size = size;
-            _stack = new uint32_t [size];
-            
+            reset();
+        }
+        
+        // Only reallocates if size is more than the current capacity
+        void alloc(uint16_t size)
+        {
+            if (size > _capacity) {
+                if (_owned) {
+                    delete [ ] _stack;
+                }
+                _stack = new uint32_t [size];
+                _capacity = size;
+                _owned = true;
+            }
+            _size = size;
+            reset();
+        }
+        
+        void reset()
+        {
             _sp = 0;
             _bp = 0;
             _error = Error::None;
@@ -263,6 +671,14 @@ private:
 
         bool empty() const { return _sp == 0; }
         Error error() const { return _error; }
+
+        // Raw access for the unchecked path in executeDecoded, which
+        // keeps its own copy of sp while it runs
+        uint32_t* data() const { return _stack; }
+        int16_t sp() const { return _sp; }
+        void setSP(int16_t sp) { _sp = sp; }
+        int16_t bp() const { return _bp; }
+        int16_t size() const { return _size; }
                 
         bool setFrame(uint8_t params, uint8_t locals)
         {
@@ -345,24 +761,207 @@ private:
         
         uint32_t* _stack = nullptr;
         int16_t _size = 0;
+        uint16_t _capacity = 0;
+        bool _owned = true;
         int16_t _sp = 0;
         int16_t _bp = 0;
         mutable Error _error = Error::None;
     };
 
+    // Verifier of the code in ROM
+    class ROMVerifier;
+    
     int32_t execute(uint16_t addr);
+
+    // Shared by execute() and executeDecoded()
+    bool callNative(uint8_t id);
+    void logFromROM(uint16_t addr, uint8_t len, uint8_t numArgs);
+
+#if CLOVER_PROFILE
+    void profileOp(uint8_t op, uint16_t depth)
+    {
+        _profile.instrs++;
+        _profile.ops[(op >= ExtOpcodeStart) ? (op & 0xf0) : op]++;
+        if (depth > _profile.maxStack) {
+            _profile.maxStack = depth;
+        }
+    }
+    
+    void profileEnter(uint16_t addr);
+    void profileReturn();
+    
+    // The functions being run, innermost last. function is NoFunction if
+    // the functions table was full
+    static constexpr uint8_t NoFunction = 0xff;
     
+    struct ProfileFrame
+    {
+        uint8_t function;
+        uint32_t start;                 // _profile.instrs before its SetFrame
+    };
+#endif
+
+#if CLOVER_PREDECODE
+    // Decoded opcodes. Most are the same as the Arly opcodes. Push, Pop and
+    // PushRef are split by address type so the operand is fully resolved.
+    // So are the fused ops which name variables, with a Local version for
+    // the common case of a loop over locals. Only refs and pointers go
+    // through an Address at runtime.
+    // Jump and call targets are instruction indexes. SetFrame has the
+    // number of locals in the lower 8 bits of value and the maximum
+    // depth of the function's operand stack (from the Verifier) in the
+    // upper bits.
+    #define CLOVER_DECODED_OPS(X) \
+        X(Invalid) X(PushImm) X(PushGlobal) X(PushLocal) X(PopGlobal) X(PopLocal) \
+        X(PushRefLocal) X(PushDeref) X(PopDeref) X(Offset) X(Index) \
+        X(Dup) X(Drop) X(Swap) X(If) X(Jump) X(Log) X(Call) X(CallNoFrame) \
+        X(CallNative) X(Return) X(SetFrame) \
+        X(Or) X(Xor) X(And) X(Not) X(LNot) X(LOr) X(LAnd) \
+        X(LTInt) X(LTFloat) X(LEInt) X(LEFloat) X(EQInt) X(EQFloat) \
+        X(NEInt) X(NEFloat) X(GEInt) X(GEFloat) X(GTInt) X(GTFloat) \
+        X(AddInt) X(AddFloat) X(SubInt) X(SubFloat) X(MulInt) X(MulFloat) \
+        X(DivInt) X(DivFloat) X(NegInt) X(NegFloat) X(MulFixed) X(DivFixed) \
+        X(PreIncInt) X(PreIncFloat) X(PreDecInt) X(PreDecFloat) \
+        X(PostIncInt) X(PostIncFloat) X(PostDecInt) X(PostDecFloat) \
+        X(PreIncFixed) X(PreDecFixed) X(PostIncFixed) X(PostDecFixed) \
+        X(AddIntConst) X(Push2) X(Push2Local) X(StoreLocalConst) X(StoreGlobalConst) \
+        X(AddToLocal) X(AddToGlobal) \
+        X(IfLTInt) X(IfLEInt) X(IfEQInt) X(IfNEInt) X(IfGEInt) X(IfGTInt) \
+        X(IncLoopLTInt) X(IncLoopLTIntConst) X(IncLoopLTIntLocal) X(IncLoopLTIntConstLocal)
+
+    enum class DecodedOp : uint8_t {
+        #define CLOVER_DECODED_ENUM(op) op,
+        CLOVER_DECODED_OPS(CLOVER_DECODED_ENUM)
+        #undef CLOVER_DECODED_ENUM
+    };
+
+    struct Instr
+    {
+        const void* handler;    // Dispatch target when CLOVER_THREADED
+        DecodedOp op;
+        uint8_t index;          // Lower 4 bits of the Arly opcode
+        uint16_t addr;          // ROM address of the Arly opcode, for errorAddr
+        uint32_t value;         // Resolved operand
+    };
+
+    // Ops whose value is a target instruction index after decoding
+    static bool isBranch(DecodedOp op)
+    {
+        return op == DecodedOp::If || op == DecodedOp::Jump || op == DecodedOp::Call ||
+               (op >= DecodedOp::IfLTInt && op <= DecodedOp::IfGTInt) || isLoop(op);
+    }
+    
+    // Branches which keep operands in the upper 16 bits of value, with
+    // the target instruction index in the lower 16
+    static bool isLoop(DecodedOp op)
+    {
+        return op == DecodedOp::IncLoopLTInt || op == DecodedOp::IncLoopLTIntConst ||
+               op == DecodedOp::IncLoopLTIntLocal || op == DecodedOp::IncLoopLTIntConstLocal;
+    }
+
+    bool decode(const Verifier&);
+    void freeDecoded();
+    uint8_t decodeOne(uint16_t pc, Instr& instr, uint16_t& targ) const;
+    uint16_t decodedIndex(uint16_t addr) const;
+    int32_t executeDecoded(uint16_t index);
+
+    Instr* _decoded = nullptr;
+    uint16_t _decodedSize = 0;
+    uint16_t _initInstr = 0;
+    uint16_t _loopInstr = 0;
+    uint16_t _resumeInstr = 0;
+    bool _decodedOwned = false;     // False if it belongs to the image passed to load()
+    
+    static constexpr uint16_t ResolveHandlers = 0xffff;
+#endif
+    
+#if CLOVER_ROM_CACHE_PAGES
+    // Return the cached page containing index, filling it if needed
+    const uint8_t* romPage(uint16_t index) const
+    {
+        uint16_t page = index / CLOVER_ROM_PAGE_SIZE;
+        uint8_t slot = page % CLOVER_ROM_CACHE_PAGES;
+        if (_romCacheTag[slot] != page) {
+            fillROM(page * CLOVER_ROM_PAGE_SIZE, _romCache[slot], CLOVER_ROM_PAGE_SIZE);
+            _romCacheTag[slot] = page;
+        }
+        return _romCache[slot];
+    }
+#endif
+
     // Index is in bytes
     uint8_t getUInt8ROM(uint16_t index) const
     {
+#if CLOVER_ROM_CACHE_PAGES
+        return romPage(index)[index % CLOVER_ROM_PAGE_SIZE];
+#else
+#if CLOVER_COMPRESSED_ROM
+        if (_program.compressed) {
+            return compressedPage(index / CompressedPageSize)[index % CompressedPageSize];
+        }
+#endif
         return rom(index);
+#endif
+    }
+    
+    // Read a block of ROM, through the cache if there is one
+    void getROM(uint16_t index, uint8_t* buf, uint16_t len) const
+    {
+#if CLOVER_ROM_CACHE_PAGES
+        while (len) {
+            uint8_t offset = index % CLOVER_ROM_PAGE_SIZE;
+            uint16_t n = min(uint16_t(CLOVER_ROM_PAGE_SIZE - offset), len);
+            memcpy(buf, romPage(index) + offset, n);
+            index += n;
+            buf += n;
+            len -= n;
+        }
+#else
+        fillROM(index, buf, len);
+#endif
     }
     
+    // Read len bytes of the executable starting at addr, decompressing
+    // it if needed
+    void fillROM(uint16_t addr, uint8_t* buf, uint16_t len) const
+    {
+#if CLOVER_COMPRESSED_ROM
+        if (_program.compressed) {
+            while (len) {
+                uint8_t offset = addr % CompressedPageSize;
+                uint16_t n = min(uint16_t(CompressedPageSize - offset), len);
+                memcpy(buf, compressedPage(addr / CompressedPageSize) + offset, n);
+                addr += n;
+                buf += n;
+                len -= n;
+            }
+            return;
+        }
+#endif
+        romRead(addr, buf, len);
+    }
+
+#if CLOVER_COMPRESSED_ROM
+    // Return the decompressed page, decompressing it if it isn't the
+    // one there now
+    const uint8_t* compressedPage(uint16_t page) const;
+#endif
+    
     uint16_t getUInt16ROM(uint16_t index) const
     {
         // Little endian
-        return uint32_t(getUInt8ROM(index)) | 
-               (uint32_t(getUInt8ROM(index + 1)) << 8);
+        uint8_t b[2];
+        getROM(index, b, 2);
+        return uint16_t(b[0]) | (uint16_t(b[1]) << 8);
+    }
+
+    uint32_t getUInt32ROM(uint16_t index) const
+    {
+        // Little endian
+        uint8_t b[4];
+        getROM(index, b, 4);
+        return uint32_t(b[0]) | (uint32_t(b[1]) << 8) |
+               (uint32_t(b[2]) << 16) | (uint32_t(b[3]) << 24);
     }
 
     uint16_t getId(uint8_t i)
@@ -372,6 +971,14 @@ private:
     
     uint16_t getAbsTarg(uint8_t i) { return getId(i); }
     
+    // The 16 bit target after a Long opcode
+    uint16_t getLongTarg()
+    {
+        uint16_t targ = getUInt16ROM(_pc);
+        _pc += 2;
+        return targ;
+    }
+    
     int16_t getRelTarg(uint8_t i)
     {
         uint16_t targ = getId(i);
@@ -398,20 +1005,35 @@ private:
         return f;
     }
     
+    // Load and store by id. The id says where the variable is, so this
+    // is one test instead of making an Address and switching on it. Only
+    // refs and pointers need loadInt and storeInt.
+    uint32_t loadId(uint16_t id)
+    {
+        if (id >= LocalStart) {
+            return _stack.local(id - LocalStart);
+        }
+        if (id >= GlobalStart) {
+            return _global[id - GlobalStart];
+        }
+        return getUInt32ROM((id * 4) + ConstOffset);
+    }
+    
+    void storeId(uint16_t id, uint32_t v)
+    {
+        // Storing to a const does nothing
+        if (id >= LocalStart) {
+            _stack.local(id - LocalStart) = v;
+        } else if (id >= GlobalStart) {
+            _global[id - GlobalStart] = v;
+        }
+    }
+    
     uint32_t loadInt(Address addr, uint8_t index = 0)
     {
         switch(addr.type()) {
-            case Address::Type::Const: {
-                uint16_t a = ((addr.addr() + index) * 4) + ConstOffset;
-
-                // Little endian
-                uint32_t u = uint32_t(getUInt8ROM(a)) |
-                            (uint32_t(getUInt8ROM(a + 1)) << 8) |
-                            (uint32_t(getUInt8ROM(a + 2)) << 16) |
-                            (uint32_t(getUInt8ROM(a + 3)) << 24);
-
-                return u;
-            }
+            case Address::Type::Const:
+                return getUInt32ROM(((addr.addr() + index) * 4) + ConstOffset);
             case Address::Type::Global:
                 return _global[addr.addr() + index];
             case Address::Type::LocalRel:
@@ -458,7 +1080,28 @@ private:
         }
     }
     
-    bool log(const char* fmt, uint8_t numArgs);
+    // Log numArgs values from the stack with the len chars of format
+    // given by read(i), stopping early at a '\0'. Text goes to log() in
+    // chunks of up to LogChunkSize chars and each number is formatted
+    // into its own small buffer, so the format is never copied whole and
+    // nothing is allocated. The args are always popped. Returns false if
+    // the format is bad.
+    static constexpr uint8_t LogChunkSize = 16;
+    
+    template<typename Read>
+    bool logFormat(Read read, uint16_t len, uint8_t numArgs);
+    
+    // Size the globals and stack for _program. Returns false if they
+    // don't fit in the arena
+    bool allocRAM();
+    
+    // Take size bytes from the arena, aligned for a uint32_t. Returns
+    // nullptr if there isn't room
+    uint8_t* arenaAlloc(uint16_t size);
+    
+    // The arena after what's in use. Nothing is taken, so it's only good
+    // until the next arenaAlloc()
+    uint8_t* arenaScratch(uint16_t& size);
     
     bool isNextOpcodeSetFrame() const
     {
@@ -471,8 +1114,16 @@ private:
     uint8_t _params[ParamsSize];
     uint8_t _paramsSize = 0;
 
+    Program _program;
+    
     uint32_t* _global = nullptr;
-    uint16_t _globalSize = 0;
+    uint16_t _globalSize = 0;   // Allocated size, may be more than the program needs
+    
+    // _arenaFixed is what the constructor took, which stays across loads
+    uint8_t* _arena = nullptr;
+    uint16_t _arenaSize = 0;
+    uint16_t _arenaFixed = 0;
+    uint16_t _arenaUsed = 0;
     
     int16_t _pc = 0;
     Stack _stack;
@@ -480,13 +1131,53 @@ private:
     NativeModule** _nativeModules = nullptr;
     uint8_t _nativeModulesSize = 0;
     
+    // Native functions are bound to their module at construction. The
+    // table is indexed by nativeId and only goes up to the highest id
+    // implemented by any module.
+    static constexpr uint8_t NoModule = 0xff;
+    
+    struct NativeBinding
+    {
+        uint8_t module;
+        uint8_t numParams;
+    };
+    
+    void bindNatives();
+    
+    NativeBinding* _nativeBindings = nullptr;
+    uint16_t _nativeBindingsSize = 0;
+    bool _nativeIdConflict = false;
+    
     uint8_t _numParams = 0;
     uint16_t _initStart = 0;
     uint16_t _loopStart = 0;
-    uint16_t _codeOffset = 0; // Used by Call to go to the correct absolute address
     
-    char* _stringBuf = nullptr;
-    uint8_t _stringSize = 0;
+
+    ExecMode _execMode = ExecMode::Interpreted;
+    CompiledCode _compiledCode = nullptr;
+    
+    // When suspended, _pc (or _resumeInstr if predecoded) is the next
+    // instruction to run
+    uint32_t _budget = 0;
+    bool _suspended = false;
+    
+    uint32_t _random = DefaultRandomSeed;
+
+#if CLOVER_PROFILE
+    Profile _profile;
+    ProfileFrame _profileFrames[CLOVER_PROFILE_DEPTH];
+    uint8_t _profileDepth = 0;          // Can be more than CLOVER_PROFILE_DEPTH
+#endif
+
+#if CLOVER_ROM_CACHE_PAGES
+    mutable uint8_t _romCache[CLOVER_ROM_CACHE_PAGES][CLOVER_ROM_PAGE_SIZE];
+    mutable uint16_t _romCacheTag[CLOVER_ROM_CACHE_PAGES];
+#endif
+
+#if CLOVER_COMPRESSED_ROM
+    mutable uint8_t _compressedPage[CompressedPageSize];
+    mutable uint16_t _compressedPageTag = 0xffff;
+#endif
 };
 
 }
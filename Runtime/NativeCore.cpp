@@ -45,6 +45,13 @@ NativeCore::addFunctions(CompileEngine* comp)
                                 { "min", 0, CompileEngine::Type::Float },
                                 { "max", 0, CompileEngine::Type::Float },
                             });
+    comp->addNative("RandomFillArray", uint8_t(Id::RandomFillArray), CompileEngine::Type::None,
+                            CompileEngine::SymbolList {
+                                { "dst", 0, CompileEngine::Type::Ptr },
+                                { "min", 0, CompileEngine::Type::Int },
+                                { "max", 0, CompileEngine::Type::Int },
+                                { "n",   0, CompileEngine::Type::Int },
+                            });
     comp->addNative("InitArray", uint8_t(Id::InitArray), CompileEngine::Type::None,
                             CompileEngine::SymbolList {
                                 { "dst", 0, CompileEngine::Type::Ptr },
@@ -71,6 +78,91 @@ NativeCore::addFunctions(CompileEngine* comp)
                                 { "a",   0, CompileEngine::Type::Float },
                                 { "b",   0, CompileEngine::Type::Float },
                             });
+    comp->addNative("IntToFixed", uint8_t(Id::IntToFixed), CompileEngine::Type::Fixed,
+                            CompileEngine::SymbolList {
+                                { "v", 0, CompileEngine::Type::Int },
+                            });
+    comp->addNative("FixedToInt", uint8_t(Id::FixedToInt), CompileEngine::Type::Int,
+                            CompileEngine::SymbolList {
+                                { "v", 0, CompileEngine::Type::Fixed },
+                            });
+    comp->addNative("FloatToFixed", uint8_t(Id::FloatToFixed), CompileEngine::Type::Fixed,
+                            CompileEngine::SymbolList {
+                                { "v", 0, CompileEngine::Type::Float },
+                            });
+    comp->addNative("FixedToFloat", uint8_t(Id::FixedToFloat), CompileEngine::Type::Float,
+                            CompileEngine::SymbolList {
+                                { "v", 0, CompileEngine::Type::Fixed },
+                            });
+    comp->addNative("AnimateFixed", uint8_t(Id::AnimateFixed), CompileEngine::Type::Int,
+                            CompileEngine::SymbolList {
+                                { "p", 0, CompileEngine::Type::Ptr },
+                            });
+    comp->addNative("RandomFixed", uint8_t(Id::RandomFixed), CompileEngine::Type::Fixed,
+                            CompileEngine::SymbolList {
+                                { "min", 0, CompileEngine::Type::Fixed },
+                                { "max", 0, CompileEngine::Type::Fixed },
+                            });
+    comp->addNative("MinFixed", uint8_t(Id::MinFixed), CompileEngine::Type::Fixed,
+                            CompileEngine::SymbolList {
+                                { "a",   0, CompileEngine::Type::Fixed },
+                                { "b",   0, CompileEngine::Type::Fixed },
+                            });
+    comp->addNative("MaxFixed", uint8_t(Id::MaxFixed), CompileEngine::Type::Fixed,
+                            CompileEngine::SymbolList {
+                                { "a",   0, CompileEngine::Type::Fixed },
+                                { "b",   0, CompileEngine::Type::Fixed },
+                            });
+    comp->addNative("CopyArray", uint8_t(Id::CopyArray), CompileEngine::Type::None,
+                            CompileEngine::SymbolList {
+                                { "dst", 0, CompileEngine::Type::Ptr },
+                                { "src", 0, CompileEngine::Type::Ptr },
+                                { "n",   0, CompileEngine::Type::Int },
+                            });
+    comp->addNative("RotateArray", uint8_t(Id::RotateArray), CompileEngine::Type::None,
+                            CompileEngine::SymbolList {
+                                { "dst", 0, CompileEngine::Type::Ptr },
+                                { "k",   0, CompileEngine::Type::Int },
+                                { "n",   0, CompileEngine::Type::Int },
+                            });
+    comp->addNative("ScaleArrayInt", uint8_t(Id::ScaleArrayInt), CompileEngine::Type::None,
+                            CompileEngine::SymbolList {
+                                { "dst", 0, CompileEngine::Type::Ptr },
+                                { "s",   0, CompileEngine::Type::Int },
+                                { "n",   0, CompileEngine::Type::Int },
+                            });
+    comp->addNative("ScaleArrayFloat", uint8_t(Id::ScaleArrayFloat), CompileEngine::Type::None,
+                            CompileEngine::SymbolList {
+                                { "dst", 0, CompileEngine::Type::Ptr },
+                                { "s",   0, CompileEngine::Type::Float },
+                                { "n",   0, CompileEngine::Type::Int },
+                            });
+    comp->addNative("AddArrayInt", uint8_t(Id::AddArrayInt), CompileEngine::Type::None,
+                            CompileEngine::SymbolList {
+                                { "dst", 0, CompileEngine::Type::Ptr },
+                                { "src", 0, CompileEngine::Type::Ptr },
+                                { "n",   0, CompileEngine::Type::Int },
+                            });
+    comp->addNative("AddArrayFloat", uint8_t(Id::AddArrayFloat), CompileEngine::Type::None,
+                            CompileEngine::SymbolList {
+                                { "dst", 0, CompileEngine::Type::Ptr },
+                                { "src", 0, CompileEngine::Type::Ptr },
+                                { "n",   0, CompileEngine::Type::Int },
+                            });
+    comp->addNative("BlendArrayInt", uint8_t(Id::BlendArrayInt), CompileEngine::Type::None,
+                            CompileEngine::SymbolList {
+                                { "dst", 0, CompileEngine::Type::Ptr },
+                                { "src", 0, CompileEngine::Type::Ptr },
+                                { "t",   0, CompileEngine::Type::Int },
+                                { "n",   0, CompileEngine::Type::Int },
+                            });
+    comp->addNative("BlendArrayFloat", uint8_t(Id::BlendArrayFloat), CompileEngine::Type::None,
+                            CompileEngine::SymbolList {
+                                { "dst", 0, CompileEngine::Type::Ptr },
+                                { "src", 0, CompileEngine::Type::Ptr },
+                                { "t",   0, CompileEngine::Type::Float },
+                                { "n",   0, CompileEngine::Type::Int },
+                            });
 }
 #endif
 
@@ -86,11 +178,28 @@ NativeCore::hasId(uint8_t id) const
         case Id::Int          :
         case Id::RandomInt    :
         case Id::RandomFloat  :
+        case Id::RandomFillArray :
         case Id::InitArray    :
         case Id::MinInt       :
         case Id::MinFloat     :
         case Id::MaxInt       :
         case Id::MaxFloat     :
+        case Id::IntToFixed   :
+        case Id::FixedToInt   :
+        case Id::FloatToFixed :
+        case Id::FixedToFloat :
+        case Id::AnimateFixed :
+        case Id::RandomFixed  :
+        case Id::MinFixed     :
+        case Id::MaxFixed     :
+        case Id::CopyArray       :
+        case Id::RotateArray     :
+        case Id::ScaleArrayInt   :
+        case Id::ScaleArrayFloat :
+        case Id::AddArrayInt     :
+        case Id::AddArrayFloat   :
+        case Id::BlendArrayInt   :
+        case Id::BlendArrayFloat :
             return true;
     }
 }
@@ -106,11 +215,28 @@ NativeCore::numParams(uint8_t id) const
         case Id::Int            : return 1;
         case Id::RandomInt      : return 2;
         case Id::RandomFloat    : return 2;
+        case Id::RandomFillArray: return 4;
         case Id::InitArray      : return 3;
         case Id::MinInt         : return 2;
         case Id::MinFloat       : return 2;
         case Id::MaxInt         : return 2;
         case Id::MaxFloat       : return 2;
+        case Id::IntToFixed     : return 1;
+        case Id::FixedToInt     : return 1;
+        case Id::FloatToFixed   : return 1;
+        case Id::FixedToFloat   : return 1;
+        case Id::AnimateFixed   : return 1;
+        case Id::RandomFixed    : return 2;
+        case Id::MinFixed       : return 2;
+        case Id::MaxFixed       : return 2;
+        case Id::CopyArray      : return 3;
+        case Id::RotateArray    : return 3;
+        case Id::ScaleArrayInt  : return 3;
+        case Id::ScaleArrayFloat: return 3;
+        case Id::AddArrayInt    : return 3;
+        case Id::AddArrayFloat  : return 3;
+        case Id::BlendArrayInt  : return 4;
+        case Id::BlendArrayFloat: return 4;
     }
 }
 
@@ -146,6 +272,14 @@ NativeCore::call(Interpreter* interp, uint8_t id)
             float max = intToFloat(interp->stackLocal(1));
             return floatToInt(interp->random(min, max));
         }
+        case Id::RandomFillArray : {
+            // Fixed values are ints, so this fills fixed arrays too
+            int32_t n = interp->stackLocal(3);
+            if (n > 0) {
+                interp->randomArray(interp->stackLocal(0), interp->stackLocal(1), interp->stackLocal(2), n);
+            }
+            return 0;
+        }
         case Id::InitArray    : {
             uint32_t i = interp->stackLocal(0);
             uint32_t v = interp->stackLocal(1);
@@ -165,5 +299,170 @@ NativeCore::call(Interpreter* interp, uint8_t id)
         case Id::MaxFloat     : {
             return floatToInt(max(intToFloat(interp->stackLocal(0)), intToFloat(interp->stackLocal(1))));
         }
+        case Id::IntToFixed   : {
+            return intToFixed(interp->stackLocal(0));
+        }
+        case Id::FixedToInt   : {
+            return fixedToInt(interp->stackLocal(0));
+        }
+        case Id::FloatToFixed : {
+            return floatToFixed(intToFloat(interp->stackLocal(0)));
+        }
+        case Id::FixedToFloat : {
+            return floatToInt(fixedToFloat(interp->stackLocal(0)));
+        }
+        case Id::AnimateFixed : {
+            uint32_t i = interp->stackLocal(0);
+            return interp->animateFixed(i);
+        }
+        case Id::RandomFixed  : {
+            // Fixed values are ints, so this has the full fixed precision
+            int32_t min = interp->stackLocal(0);
+            int32_t max = interp->stackLocal(1);
+            return uint32_t(interp->random(min, max));
+        }
+        case Id::MinFixed     : {
+            return min(int32_t(interp->stackLocal(0)), int32_t(interp->stackLocal(1)));
+        }
+        case Id::MaxFixed     : {
+            return max(int32_t(interp->stackLocal(0)), int32_t(interp->stackLocal(1)));
+        }
+        case Id::CopyArray       : {
+            int32_t n = interp->stackLocal(2);
+            if (n > 0) {
+                interp->copyArray(interp->stackLocal(0), interp->stackLocal(1), n);
+            }
+            return 0;
+        }
+        case Id::RotateArray     : {
+            int32_t n = interp->stackLocal(2);
+            uint32_t* a = (n > 0) ? interp->arrayAddr(interp->stackLocal(0), n) : nullptr;
+            if (a) {
+                rotateArray(a, interp->stackLocal(1), n);
+            }
+            return 0;
+        }
+        case Id::ScaleArrayInt   :
+        case Id::ScaleArrayFloat : {
+            int32_t n = interp->stackLocal(2);
+            uint32_t* a = (n > 0) ? interp->arrayAddr(interp->stackLocal(0), n) : nullptr;
+            if (a) {
+                if (Id(id) == Id::ScaleArrayInt) {
+                    scaleArrayInt(a, interp->stackLocal(1), n);
+                } else {
+                    scaleArrayFloat(a, intToFloat(interp->stackLocal(1)), n);
+                }
+            }
+            return 0;
+        }
+        case Id::AddArrayInt     :
+        case Id::AddArrayFloat   : {
+            int32_t n = interp->stackLocal(2);
+            uint32_t* dst = (n > 0) ? interp->arrayAddr(interp->stackLocal(0), n) : nullptr;
+            uint32_t* src = dst ? interp->arrayAddr(interp->stackLocal(1), n) : nullptr;
+            if (src) {
+                if (Id(id) == Id::AddArrayInt) {
+                    addArrayInt(dst, src, n);
+                } else {
+                    addArrayFloat(dst, src, n);
+                }
+            }
+            return 0;
+        }
+        case Id::BlendArrayInt   :
+        case Id::BlendArrayFloat : {
+            int32_t n = interp->stackLocal(3);
+            uint32_t* dst = (n > 0) ? interp->arrayAddr(interp->stackLocal(0), n) : nullptr;
+            uint32_t* src = dst ? interp->arrayAddr(interp->stackLocal(1), n) : nullptr;
+            if (src) {
+                if (Id(id) == Id::BlendArrayInt) {
+                    blendArrayInt(dst, src, interp->stackLocal(2), n);
+                } else {
+                    blendArrayFloat(dst, src, intToFloat(interp->stackLocal(2)), n);
+                }
+            }
+            return 0;
+        }
+    }
+}
+
+// Rotate left by k, so a[k] ends up in a[0]. A negative k rotates right.
+// Done with 3 reverses so it needs no temporary array
+void
+NativeCore::rotateArray(uint32_t* a, int32_t k, uint32_t n)
+{
+    k %= int32_t(n);
+    if (k < 0) {
+        k += n;
+    }
+    if (k == 0) {
+        return;
+    }
+    
+    auto reverse = [](uint32_t* first, uint32_t* last)
+    {
+        while (first < --last) {
+            uint32_t t = *first;
+            *first++ = *last;
+            *last = t;
+        }
+    };
+    
+    reverse(a, a + k);
+    reverse(a + k, a + n);
+    reverse(a, a + n);
+}
+
+// s is 8.8 fixed point, so 256 leaves the values unchanged and 128
+// halves them. That's the usual way to fade LED values without floats
+void
+NativeCore::scaleArrayInt(uint32_t* a, int32_t s, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; ++i) {
+        a[i] = uint32_t((int32_t(a[i]) * s) >> 8);
+    }
+}
+
+void
+NativeCore::scaleArrayFloat(uint32_t* a, float s, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; ++i) {
+        a[i] = floatToInt(intToFloat(a[i]) * s);
+    }
+}
+
+void
+NativeCore::addArrayInt(uint32_t* dst, const uint32_t* src, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; ++i) {
+        dst[i] += src[i];
+    }
+}
+
+void
+NativeCore::addArrayFloat(uint32_t* dst, const uint32_t* src, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; ++i) {
+        dst[i] = floatToInt(intToFloat(dst[i]) + intToFloat(src[i]));
+    }
+}
+
+// Move each dst value toward src. t is 8.8 fixed point like scaleArrayInt,
+// so 0 leaves dst unchanged and 256 makes it a copy of src
+void
+NativeCore::blendArrayInt(uint32_t* dst, const uint32_t* src, int32_t t, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; ++i) {
+        int32_t d = int32_t(dst[i]);
+        dst[i] = uint32_t(d + (((int32_t(src[i]) - d) * t) >> 8));
+    }
+}
+
+void
+NativeCore::blendArrayFloat(uint32_t* dst, const uint32_t* src, float t, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; ++i) {
+        float d = intToFloat(dst[i]);
+        dst[i] = floatToInt(d + (intToFloat(src[i]) - d) * t);
     }
 }
@@ -18,7 +18,7 @@
 namespace clvr {
 
 constexpr uint8_t CorePrefix0 = 0x00;
-constexpr uint8_t CorePrefix1 = 0x00;
+constexpr uint8_t CorePrefix1 = 0x10;
 
 class NativeCore : public NativeModule
 {
@@ -28,6 +28,7 @@ public:
         Param        = CorePrefix0 | 0x01,
         Float        = CorePrefix0 | 0x02,
         Int          = CorePrefix0 | 0x03,
+        RandomFillArray = CorePrefix0 | 0x04,
         RandomInt    = CorePrefix0 | 0x07,
         RandomFloat  = CorePrefix0 | 0x08,
         InitArray    = CorePrefix0 | 0x09,
@@ -35,6 +36,26 @@ public:
         MinFloat     = CorePrefix0 | 0x0b,
         MaxInt       = CorePrefix0 | 0x0c,
         MaxFloat     = CorePrefix0 | 0x0d,
+        
+        // Fixed point
+        IntToFixed   = CorePrefix1 | 0x00,
+        FixedToInt   = CorePrefix1 | 0x01,
+        FloatToFixed = CorePrefix1 | 0x02,
+        FixedToFloat = CorePrefix1 | 0x03,
+        AnimateFixed = CorePrefix1 | 0x04,
+        RandomFixed  = CorePrefix1 | 0x05,
+        MinFixed     = CorePrefix1 | 0x06,
+        MaxFixed     = CorePrefix1 | 0x07,
+        
+        // Arrays
+        CopyArray       = CorePrefix1 | 0x08,
+        RotateArray     = CorePrefix1 | 0x09,
+        ScaleArrayInt   = CorePrefix1 | 0x0a,
+        ScaleArrayFloat = CorePrefix1 | 0x0b,
+        AddArrayInt     = CorePrefix1 | 0x0c,
+        AddArrayFloat   = CorePrefix1 | 0x0d,
+        BlendArrayInt   = CorePrefix1 | 0x0e,
+        BlendArrayFloat = CorePrefix1 | 0x0f,
     };
 
     virtual bool hasId(uint8_t id) const override;
@@ -46,6 +67,15 @@ public:
 #endif
 
 private:
+    // Loops over whole arrays. They are kept simple so the host compiler
+    // can vectorize them
+    static void rotateArray(uint32_t* a, int32_t k, uint32_t n);
+    static void scaleArrayInt(uint32_t* a, int32_t s, uint32_t n);
+    static void scaleArrayFloat(uint32_t* a, float s, uint32_t n);
+    static void addArrayInt(uint32_t* dst, const uint32_t* src, uint32_t n);
+    static void addArrayFloat(uint32_t* dst, const uint32_t* src, uint32_t n);
+    static void blendArrayInt(uint32_t* dst, const uint32_t* src, int32_t t, uint32_t n);
+    static void blendArrayFloat(uint32_t* dst, const uint32_t* src, float t, uint32_t n);
 };
 
 }
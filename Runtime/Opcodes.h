@@ -38,6 +38,16 @@ Opcodes:
                       (bits 7:0). 12 bit absolute address (0 to 4095).
         relTarg     - Lower 4 bits of opcode (bits 11:8) | byte after opcode
                       (bits 7:0). 12 bit relative address (-2048 to 2047).
+        sid         - Byte after opcode. Short id of a global (0x00 to 0x7f) or
+                      local (0x80 to 0xff) variable. Lower 7 bits are the
+                      offset of the variable.
+        sconst      - Byte after opcode. Signed int constant (-128 to 127)
+        fwdTarg     - Byte after opcode. 8 bit forward relative address (0 to 255).
+        bwdTarg     - Byte after the other operands. 8 bit backward relative
+                      address (0 to 255), from the end of the instruction.
+        longTarg    - 2 bytes after opcode, little endian. 16 bit relative
+                      address (-32768 to 32767) for LongJump and LongIf, 16
+                      bit absolute address for LongCall.
         nativeId    - Byte after opcode. Id of function in NativeModule.
         p           - Lower 4 bits of opcode. Num params passed to function.
         l           - Byte after opcode. Num locals in function.
@@ -94,6 +104,34 @@ Opcodes:
                               Opcode is followed by len character format
                               string. Output formatted string to console.
 
+Fused opcodes. These are not emitted directly by the code generator. The
+peephole optimizer replaces common sequences with them.
+
+    AddIntConst sconst      - stack[sp-1] += sconst
+    Push2 sid sid           - Push first sid, then second sid
+    StoreIntConst sid const - variable = const
+    AddToVar sid            - variable += stack[--sp] (assumes int32_t)
+    
+    IfLTInt fwdTarg         - b = stack[--sp], a = stack[--sp]. If !(a < b) 
+                              skip fwdTarg bytes. Same for IfLEInt, IfEQInt,
+                              IfNEInt, IfGEInt and IfGTInt
+    
+    IncLoopLTInt sid sid bwdTarg
+                            - First variable += 1 (assumes int32_t). If it is
+                              less than the second variable jump back bwdTarg
+                              bytes
+    IncLoopLTIntConst sid const bwdTarg
+                            - Same but the limit is const (0 to 255)
+
+Long opcodes. These are Jump, If and Call with a 16 bit target, for code too
+big for the 12 bit ones. They are all the Long opcode with the lower 4 bits
+saying which it is (see LongOp). The Optimizer only uses them for targets
+the short ones can't reach, so code that fits in 4096 bytes doesn't change.
+
+    LongJump longTarg       - Same as Jump
+    LongIf longTarg         - Same as If
+    LongCall longTarg       - Same as Call
+
 The following opcodes expect 1 value on stack (a = tos). Value
 is popped, the operation is performed and the result is pushed.
 
@@ -132,6 +170,11 @@ are popped, the operation is performed and the result is pushed.
     MulFloat                - stack[sp++] = a * b (assumes float, result is float)
     DivInt                  - stack[sp++] = a / b (assumes int32_t, result is int32_t)
     DivFloat                - stack[sp++] = a / b (assumes float, result is float)
+    MulFixed                - stack[sp++] = a * b (assumes fixed, result is fixed)
+    DivFixed                - stack[sp++] = a / b (assumes fixed, result is fixed)
+
+Fixed point values are Q16.16 in an int32_t. Add, subtract, negate and
+compare are the same as for ints, so they use the Int opcodes.
 
 Increment and decrement ops expect a ref on TOS which is popped. The "pre" 
 versions will load the value, increment or decrement, store the new value 
@@ -149,6 +192,10 @@ ref which is either incremented or decremented.
     PostIncFloat
     PostDecInt
     PostDecFloat
+    PreIncFixed
+    PreDecFixed
+    PostIncFixed
+    PostDecFixed
     
     
     Executable format
@@ -167,8 +214,28 @@ ref which is either incremented or decremented.
                           entries end when a byte of 0 is seen
                           
     Commands            - List of init and loop instructions for each command
+    
+    An executable can also be uploaded compressed, with the 'arlz' format
+    id. See Compressed.h.
 */
 
+static constexpr uint16_t ConstOffset = 10;     // Start of the constants in the executable
+
+// CLOVER_MAX_CODE_SIZE is the most code an executable can have. Past 4096
+// bytes it needs LongCall. The Verifier and the predecoder keep tables for
+// this much code, so it stays at what Call can reach on Arduino unless it's
+// set. It can't be more than 65535.
+#ifndef CLOVER_MAX_CODE_SIZE
+    #ifdef ARDUINO
+        #define CLOVER_MAX_CODE_SIZE 4096
+    #else
+        #define CLOVER_MAX_CODE_SIZE 16384
+    #endif
+#endif
+
+static constexpr uint16_t MaxCodeSize = CLOVER_MAX_CODE_SIZE;
+static constexpr uint16_t MaxShortCallTarg = 4096;  // Call uses a 12 bit absTarg
+
 static constexpr uint16_t MaxIdSize = 4096;
 static constexpr uint16_t ConstStart = 0x00;
 static constexpr uint16_t ConstSize = 2048; // Max possible size
@@ -176,6 +243,15 @@ static constexpr uint16_t GlobalStart = ConstStart + ConstSize;
 static constexpr uint16_t GlobalSize = 1024;
 static constexpr uint16_t LocalStart = GlobalStart + GlobalSize;
 static constexpr uint16_t LocalSize = MaxIdSize - LocalStart;
+
+// Short ids are a single byte. Globals are 0x00 to 0x7f, locals 0x80 to 0xff
+static constexpr uint8_t SidLocalStart = 0x80;
+static constexpr uint8_t SidSize = 0x80;
+
+static inline uint16_t idFromSid(uint8_t sid)
+{
+    return (sid >= SidLocalStart) ? (LocalStart + sid - SidLocalStart) : (GlobalStart + sid);
+}
 static constexpr uint8_t ExtOpcodeStart = 0x40;
 
 enum class Op: uint8_t {
@@ -190,10 +266,18 @@ enum class Op: uint8_t {
     Drop            = 0x05,
     Swap            = 0x06,
     
+    MulFixed        = 0x07,
+    DivFixed        = 0x08,
+    
+    IncLoopLTIntConst = 0x09,   // Fused, see Compiler/Optimizer.h
+
     CallNative      = 0x0a,
     Return          = 0x0b,
     
-// 0x0c to 0x0f unused
+    PreIncFixed     = 0x0c,
+    PreDecFixed     = 0x0d,
+    PostIncFixed    = 0x0e,
+    PostDecFixed    = 0x0f,
 
     Or              = 0x10,
     Xor             = 0x11,
@@ -237,6 +321,21 @@ enum class Op: uint8_t {
     PostIncFloat    = 0x32,
     PostDecInt      = 0x33,
     PostDecFloat    = 0x34,
+
+    // Fused ops, see Compiler/Optimizer.h
+    AddIntConst     = 0x35,
+    Push2           = 0x36,
+    StoreIntConst   = 0x37,
+    AddToVar        = 0x38,
+    
+    IfLTInt         = 0x39,
+    IfLEInt         = 0x3a,
+    IfEQInt         = 0x3b,
+    IfNEInt         = 0x3c,
+    IfGEInt         = 0x3d,
+    IfGTInt         = 0x3e,
+    
+    IncLoopLTInt    = 0x3f,
     
     // 0x40 - 0xf0 ops use lower 4 bits for data value
 
@@ -253,6 +352,14 @@ enum class Op: uint8_t {
     SetFrame        = ExtOpcodeStart + 0x80,
     Jump            = ExtOpcodeStart + 0x90,
     If              = ExtOpcodeStart + 0xa0,
+    Long            = ExtOpcodeStart + 0xb0,
+};
+
+// Lower 4 bits of the Long opcode
+enum class LongOp : uint8_t {
+    Jump            = 0x00,
+    If              = 0x01,
+    Call            = 0x02,
 };
 
 enum class OpParams : uint8_t {
@@ -267,6 +374,14 @@ enum class OpParams : uint8_t {
                 // (bits 7:0). 12 bit relative address (-2048 to 2047).
     P_L,        // b[3:0] = num params (0-15), b+1 = num locals (0-255)
     Idx_Len_S, // b[3:0] = <int> (0-15), b+1 = <int>, followed by Sz string bytes
+    Sid,        // b+1 = short id
+    Sid_Sid,    // b+1 = short id, b+2 = short id
+    Sid_Const,  // b+1 = short id, b+2 = 0-255
+    SConst,     // b+1 = -128 to 127
+    FwdTarg,    // b+1 = 8 bit forward relative address (0 to 255)
+    Sid_Sid_BwdTarg,    // b+1 = short id, b+2 = short id, b+3 = 8 bit backward relative address (0 to 255)
+    Sid_Const_BwdTarg,  // b+1 = short id, b+2 = 0-255, b+3 = 8 bit backward relative address (0 to 255)
+    LongTarg,   // b[3:0] = LongOp, b+1 and b+2 = 16 bit address, little endian
 };
 
 }
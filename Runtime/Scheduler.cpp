@@ -0,0 +1,92 @@
+/*-------------------------------------------------------------------------
+    This source file is a part of Clover
+    For the latest info, see https://github.com/cmarrin/Clover
+    Copyright (c) 2021-2022, Chris Marrin
+    All rights reserved.
+    Use of this source code is governed by the MIT license that can be
+    found in the LICENSE file.
+-------------------------------------------------------------------------*/
+
+#include "Scheduler.h"
+
+using namespace clvr;
+
+bool
+Scheduler::add(Interpreter* interp, uint32_t now)
+{
+    if (_size >= MaxTasks) {
+        return false;
+    }
+    
+    insert({ interp, now }, now);
+    return true;
+}
+
+bool
+Scheduler::remove(Interpreter* interp)
+{
+    for (uint8_t i = 0; i < _size; ++i) {
+        if (_tasks[i].interp == interp) {
+            for ( ; i < _size - 1; ++i) {
+                _tasks[i] = _tasks[i + 1];
+            }
+            _size--;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t
+Scheduler::run(uint32_t now)
+{
+    // Times can wrap, so compare them as signed offsets from now. A task
+    // that is due is at the front of the queue. Take it off and put it
+    // back with its new deadline. Each task runs at most once per call,
+    // so one that returns 0 doesn't starve the others. A task that ran out
+    // of budget is resumed rather than looped, and is due again right away
+    // behind any other tasks that are due.
+    for (uint8_t count = _size; count > 0 && _size > 0; --count) {
+        Task task = _tasks[0];
+        if (int32_t(task.due - now) > 0) {
+            break;
+        }
+        
+        for (uint8_t i = 0; i < _size - 1; ++i) {
+            _tasks[i] = _tasks[i + 1];
+        }
+        _size--;
+        
+        int32_t delay = task.interp->suspended() ? task.interp->resume() : task.interp->loop();
+        if (delay == Interpreter::Suspended) {
+            delay = 0;
+        } else if (delay < 0) {
+            _failed = task.interp;
+            continue;
+        }
+        
+        task.due = now + uint32_t(delay);
+        insert(task, now);
+    }
+    
+    if (_size == 0) {
+        return Idle;
+    }
+    
+    int32_t wait = int32_t(_tasks[0].due - now);
+    return (wait < 0) ? 0 : uint32_t(wait);
+}
+
+void
+Scheduler::insert(const Task& task, uint32_t now)
+{
+    int32_t due = int32_t(task.due - now);
+    
+    uint8_t i = _size;
+    while (i > 0 && int32_t(_tasks[i - 1].due - now) > due) {
+        _tasks[i] = _tasks[i - 1];
+        --i;
+    }
+    _tasks[i] = task;
+    _size++;
+}
@@ -0,0 +1,83 @@
+/*-------------------------------------------------------------------------
+    This source file is a part of Clover
+    For the latest info, see https://github.com/cmarrin/Clover
+    Copyright (c) 2021-2022, Chris Marrin
+    All rights reserved.
+    Use of this source code is governed by the MIT license that can be
+    found in the LICENSE file.
+-------------------------------------------------------------------------*/
+
+// Scheduler
+//
+// Run the loop() of several commands at once, for instance a base effect
+// with a strobe over it. Each command has its own Interpreter, which has
+// already run init(), so each has its own globals and stack. Interpreters
+// running the same executable can share it with load(const Interpreter&).
+//
+// Tasks are kept in deadline order. run() calls loop() on each task that
+// is due and schedules its next call using the delay it returns. Then it
+// returns how long the caller can wait before anything else is due:
+//
+//      while (true) {
+//          delay(scheduler.run(millis()));
+//      }
+//
+// Tasks due at the same time run in the order they were added, so later
+// ones can draw over earlier ones. A task whose loop() fails is removed.
+// Give each Interpreter a budget with setBudget() to keep one long loop()
+// from holding up the rest. A suspended task is resumed on the next run().
+// Times are in ms and may wrap, like millis().
+//
+
+#pragma once
+
+#include "Interpreter.h"
+
+// CLOVER_SCHEDULER_TASKS is the most commands a Scheduler can hold
+#ifndef CLOVER_SCHEDULER_TASKS
+    #define CLOVER_SCHEDULER_TASKS 4
+#endif
+
+namespace clvr {
+
+class Scheduler
+{
+public:
+    static constexpr uint8_t MaxTasks = CLOVER_SCHEDULER_TASKS;
+    
+    // Returned by run() when there are no tasks
+    static constexpr uint32_t Idle = 0xffffffff;
+
+    // interp is first due at now. Returns false if the Scheduler is full
+    bool add(Interpreter* interp, uint32_t now);
+    
+    // Returns false if interp isn't a task
+    bool remove(Interpreter* interp);
+    
+    void clear() { _size = 0; }
+    
+    // Run every task due at or before now. Returns the ms until the next
+    // one is due or Idle if there are none left
+    uint32_t run(uint32_t now);
+    
+    uint8_t size() const { return _size; }
+    
+    // The last task to fail, or nullptr. Its error() says why
+    Interpreter* failed() const { return _failed; }
+
+private:
+    struct Task
+    {
+        Interpreter* interp;
+        uint32_t due;
+    };
+    
+    // Put task in deadline order, after any that are due at the same time
+    void insert(const Task& task, uint32_t now);
+    
+    Task _tasks[MaxTasks];
+    uint8_t _size = 0;
+    Interpreter* _failed = nullptr;
+};
+
+}
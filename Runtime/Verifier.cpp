@@ -0,0 +1,703 @@
+/*-------------------------------------------------------------------------
+    This source file is a part of Clover
+    For the latest info, see https://github.com/cmarrin/Clover
+    Copyright (c) 2021-2022, Chris Marrin
+    All rights reserved.
+    Use of this source code is governed by the MIT license that can be
+    found in the LICENSE file.
+-------------------------------------------------------------------------*/
+
+#include "Verifier.h"
+
+#include <string.h>
+
+using namespace clvr;
+
+void
+Verifier::setBuffer(uint8_t* buf, uint16_t size)
+{
+    // Keep the labels and calls aligned
+    uint8_t pad = uint8_t((4 - (uintptr_t(buf) & 3)) & 3);
+    size = (size > pad) ? size - pad : 0;
+    _buffer = buf + pad;
+    _bufferEnd = _buffer + (size & ~3);
+    _labels = reinterpret_cast<Label*>(_buffer);
+    _labelsCapacity = 0;
+    _calls = reinterpret_cast<CallSite*>(_bufferEnd);
+    _callsCapacity = 0;
+}
+
+bool
+Verifier::verify()
+{
+    _error = Error::None;
+    _errorAddr = -1;
+    _numLabels = 0;
+    _numCalls = 0;
+    _maxDepth = 0;
+    _stackBounded = false;
+    if (_buffer) {
+        _labelsCapacity = 0;
+        _calls = reinterpret_cast<CallSite*>(_bufferEnd);
+    }
+
+    if (rom(0) != 'a' || rom(1) != 'r' || rom(2) != 'l' || rom(3) != 'y') {
+        return fail(Error::InvalidSignature, 0);
+    }
+
+    _constSize = getUInt16(4);
+    _globalSize = getUInt16(6);
+    _stackSize = getUInt16(8);
+
+    uint16_t commandStart = ConstOffset + _constSize * 4;
+    uint16_t addr = commandStart;
+    while (rom(addr) != 0) {
+        addr += 12;
+    }
+    _codeOffset = addr + 1;
+
+    // The init and loop functions of each command are called from outside
+    for (addr = commandStart; rom(addr) != 0; addr += 12) {
+        uint8_t params;
+        if (!addFunction(getUInt16(addr + 8) + _codeOffset, addr, params) ||
+            !addFunction(getUInt16(addr + 10) + _codeOffset, addr, params)) {
+            return false;
+        }
+    }
+
+    // Walking code adds labels. Keep going until they've all been walked
+    while (true) {
+        int16_t next = NoIndex;
+        for (uint16_t i = 0; i < _numLabels; ++i) {
+            if (!_labels[i].walked) {
+                next = i;
+                break;
+            }
+        }
+        if (next == NoIndex) {
+            break;
+        }
+        if (!walk(_labels[next].addr)) {
+            return false;
+        }
+    }
+
+    // Now that all the labels are known, make sure none of them are in
+    // the middle of an instruction
+    for (uint16_t i = 0; i < _numLabels; ++i) {
+        if (!checkInstructions(_labels[i].addr)) {
+            return false;
+        }
+    }
+
+    for (uint16_t i = 0; i < _numLabels; ++i) {
+        if (_labels[i].function && _labels[i].maxDepth > _maxDepth) {
+            _maxDepth = _labels[i].maxDepth;
+        }
+    }
+
+    // If a command can recurse its stack has no bound and has to be
+    // checked as it runs
+    bool bounded = true;
+    for (addr = commandStart; rom(addr) != 0; addr += 12) {
+        for (uint8_t entry = 8; entry <= 10; entry += 2) {
+            uint16_t size = stackSize(getUInt16(addr + entry) + _codeOffset);
+            if (size == UnboundedStack) {
+                bounded = false;
+            } else if (size > _stackSize) {
+                return fail(Error::StackOverrun, addr);
+            }
+        }
+    }
+    _stackBounded = bounded;
+    return true;
+}
+
+uint8_t
+Verifier::maxDepth(uint16_t addr) const
+{
+    int16_t i = findLabel(addr);
+    return (i == NoIndex) ? _maxDepth : _labels[i].maxDepth;
+}
+
+// Sizes are memoized by label index. 0 is not done yet and 1 is being
+// done, which is how a recursive call is found. A real size is always at
+// least 2, for the pc and bp.
+uint16_t
+Verifier::stackSize(uint16_t addr) const
+{
+    int16_t i = findLabel(addr);
+    if (i == NoIndex || !_labels[i].function) {
+        return UnboundedStack;
+    }
+
+    // With a buffer the sizes go in the space between the labels and calls
+    uint16_t* sizes;
+    if (_buffer) {
+        uint8_t* end = reinterpret_cast<uint8_t*>(_labels + _numLabels);
+        if (reinterpret_cast<uint8_t*>(_calls) - end < int32_t(_numLabels * sizeof(uint16_t))) {
+            return UnboundedStack;
+        }
+        sizes = reinterpret_cast<uint16_t*>(end);
+    } else {
+        sizes = new uint16_t[_numLabels];
+    }
+    
+    memset(sizes, 0, _numLabels * sizeof(uint16_t));
+    uint16_t size = functionStackSize(i, sizes);
+    if (!_buffer) {
+        delete [ ] sizes;
+    }
+    return size;
+}
+
+uint16_t
+Verifier::functionStackSize(int16_t index, uint16_t* sizes) const
+{
+    if (sizes[index] == 1) {
+        return UnboundedStack;
+    }
+    if (sizes[index] != 0) {
+        return sizes[index];
+    }
+    sizes[index] = 1;
+
+    // The deepest point is either in the function itself or in one of
+    // the functions it calls, above the caller's operand stack
+    const Label& label = _labels[index];
+    uint32_t deepest = label.maxDepth;
+    for (uint16_t i = 0; i < _numCalls; ++i) {
+        if (_calls[i].func != label.addr) {
+            continue;
+        }
+        uint16_t callee = functionStackSize(findLabel(_calls[i].callee), sizes);
+        if (callee == UnboundedStack) {
+            sizes[index] = UnboundedStack;
+            return UnboundedStack;
+        }
+        if (uint32_t(_calls[i].base) + callee > deepest) {
+            deepest = uint32_t(_calls[i].base) + callee;
+        }
+    }
+
+    // A frame is the params and locals, the return pc and bp and the
+    // operand stack
+    uint32_t size = uint32_t(label.frameSize) + 2 + deepest;
+    sizes[index] = (size >= UnboundedStack) ? UnboundedStack - 1 : uint16_t(size);
+    return sizes[index];
+}
+
+int16_t
+Verifier::findLabel(uint16_t addr) const
+{
+    int16_t lo = 0;
+    int16_t hi = int16_t(_numLabels) - 1;
+    while (lo <= hi) {
+        int16_t mid = (lo + hi) / 2;
+        if (_labels[mid].addr == addr) {
+            return mid;
+        }
+        if (_labels[mid].addr < addr) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return NoIndex;
+}
+
+// Make room for one more label. Returns false if the buffer is full
+bool
+Verifier::growLabels()
+{
+    if (_buffer) {
+        if (reinterpret_cast<uint8_t*>(_labels + _numLabels + 1) > reinterpret_cast<uint8_t*>(_calls)) {
+            return false;
+        }
+        _labelsCapacity = _numLabels + 1;
+        return true;
+    }
+    
+    uint16_t capacity = _labelsCapacity ? (_labelsCapacity * 2) : 16;
+    Label* labels = new Label[capacity];
+    memcpy(labels, _labels, _numLabels * sizeof(Label));
+    delete [ ] _labels;
+    _labels = labels;
+    _labelsCapacity = capacity;
+    return true;
+}
+
+// Insert an unwalked label at addr (which must not already have one) and
+// return its index, or NoIndex if there's no room
+int16_t
+Verifier::addLabel(uint16_t addr)
+{
+    if (_numLabels == _labelsCapacity && !growLabels()) {
+        return NoIndex;
+    }
+
+    uint16_t i = 0;
+    while (i < _numLabels && _labels[i].addr < addr) {
+        ++i;
+    }
+    memmove(_labels + i + 1, _labels + i, (_numLabels - i) * sizeof(Label));
+    _numLabels++;
+
+    Label& label = _labels[i];
+    label.addr = addr;
+    label.func = addr;
+    label.depth = NoDepth;
+    label.maxDepth = 0;
+    label.frameSize = 0;
+    label.function = false;
+    label.walked = false;
+    return i;
+}
+
+// Add a function starting at addr. from is the addr it is called from,
+// for errors. Returns the number of formal params of the function.
+bool
+Verifier::addFunction(uint16_t addr, uint16_t from, uint8_t& params)
+{
+    if (addr < _codeOffset || addr - _codeOffset >= MaxCodeSize) {
+        return fail(Error::InvalidTarget, from);
+    }
+
+    uint8_t b = rom(addr);
+    if ((b & 0xf0) != uint8_t(Op::SetFrame)) {
+        return fail(Error::ExpectedSetFrame, from);
+    }
+    params = b & 0x0f;
+
+    int16_t i = findLabel(addr);
+    if (i != NoIndex) {
+        // A jump target can't also be a function
+        return _labels[i].function ? true : fail(Error::InvalidTarget, from);
+    }
+
+    i = addLabel(addr);
+    if (i == NoIndex) {
+        return fail(Error::OutOfMemory, from);
+    }
+    _labels[i].function = true;
+    _labels[i].depth = 0;
+    _labels[i].frameSize = params + rom(addr + 1);
+    return true;
+}
+
+// Calls aren't in any order, so with a buffer a new one goes in front of
+// the others. Returns false if the buffer is full
+bool
+Verifier::addCall(uint16_t func, uint16_t callee, uint8_t base)
+{
+    CallSite* call;
+    if (_buffer) {
+        if (reinterpret_cast<uint8_t*>(_calls - 1) < reinterpret_cast<uint8_t*>(_labels + _numLabels)) {
+            return false;
+        }
+        call = --_calls;
+    } else {
+        if (_numCalls == _callsCapacity) {
+            uint16_t capacity = _callsCapacity ? (_callsCapacity * 2) : 16;
+            CallSite* calls = new CallSite[capacity];
+            memcpy(calls, _calls, _numCalls * sizeof(CallSite));
+            delete [ ] _calls;
+            _calls = calls;
+            _callsCapacity = capacity;
+        }
+        call = _calls + _numCalls;
+    }
+    _numCalls++;
+
+    call->func = func;
+    call->callee = callee;
+    call->base = base;
+    return true;
+}
+
+// Add a jump target in func which is reached with depth values on the stack
+bool
+Verifier::addBranch(uint16_t addr, uint16_t from, uint16_t func, int16_t depth)
+{
+    if (addr < _codeOffset || addr - _codeOffset >= MaxCodeSize) {
+        return fail(Error::InvalidTarget, from);
+    }
+
+    int16_t i = findLabel(addr);
+    if (i == NoIndex) {
+        i = addLabel(addr);
+        if (i == NoIndex) {
+            return fail(Error::OutOfMemory, from);
+        }
+        _labels[i].func = func;
+        _labels[i].depth = depth;
+        return true;
+    }
+
+    const Label& label = _labels[i];
+    if (label.function || label.func != func) {
+        return fail(Error::InvalidTarget, from);
+    }
+    if (label.depth != NoDepth && label.depth != depth) {
+        return fail(Error::StackMismatch, from);
+    }
+    _labels[i].depth = depth;
+    return true;
+}
+
+// Walk the code starting at the label at addr until it gets to a label
+// that's already been walked or an instruction that doesn't continue
+bool
+Verifier::walk(uint16_t addr)
+{
+    int16_t i = findLabel(addr);
+    _labels[i].walked = true;
+
+    uint16_t func = _labels[i].func;
+    int16_t depth = _labels[i].depth;
+    int16_t funcIndex = findLabel(func);
+    uint8_t frameSize = _labels[funcIndex].frameSize;
+    uint8_t maxDepth = _labels[funcIndex].maxDepth;
+    uint16_t pc = addr;
+
+    // Skip the SetFrame at the start of a function
+    if (_labels[i].function) {
+        pc += 2;
+    }
+
+    while (true) {
+        if (pc < _codeOffset || pc - _codeOffset >= MaxCodeSize) {
+            return fail(Error::InvalidTarget, pc);
+        }
+
+        // Falling into a label continues its walk
+        if (pc != addr) {
+            i = findLabel(pc);
+            if (i != NoIndex) {
+                Label& label = _labels[i];
+                if (label.function || label.func != func) {
+                    return fail(Error::InvalidTarget, pc);
+                }
+                if (label.depth != NoDepth && label.depth != depth) {
+                    return fail(Error::StackMismatch, pc);
+                }
+                if (label.walked) {
+                    break;
+                }
+                label.depth = depth;
+                label.walked = true;
+            }
+        }
+
+        OpInfo info;
+        uint8_t len = opInfo(pc, info);
+        if (len == 0) {
+            return fail(Error::InvalidOp, pc);
+        }
+
+        for (uint8_t id = 0; id < info.numIds; ++id) {
+            if (!checkId(info.ids[id], frameSize, pc)) {
+                return false;
+            }
+        }
+
+        if (info.op == Op::Call) {
+            // The callee's params are replaced by its return value
+            uint8_t params;
+            if (!addFunction(uint16_t(info.targ), pc, params)) {
+                return false;
+            }
+            info.pops = params;
+            if (depth >= params && !addCall(func, uint16_t(info.targ), uint8_t(depth - params))) {
+                return fail(Error::OutOfMemory, pc);
+            }
+        } else if (info.op == Op::CallNative) {
+            int16_t params = numNativeParams(rom(pc + 1));
+            if (params < 0) {
+                return fail(Error::InvalidNativeFunction, pc);
+            }
+            info.pops = params;
+        }
+
+        if (depth < info.pops) {
+            return fail(Error::StackUnderrun, pc);
+        }
+
+        int16_t d = depth + ((info.extra > info.pushes) ? info.extra : info.pushes);
+        if (d > 255) {
+            return fail(Error::StackOverrun, pc);
+        }
+        if (d > maxDepth) {
+            maxDepth = d;
+        }
+        depth += info.pushes - info.pops;
+
+        if (info.targ >= 0 && info.op != Op::Call) {
+            if (!addBranch(uint16_t(info.targ), pc, func, depth)) {
+                return false;
+            }
+        }
+
+        if (!info.next) {
+            break;
+        }
+        pc += len;
+    }
+
+    // A frame is the return pc and bp, the locals and the operand stack.
+    // The params were counted by the caller.
+    funcIndex = findLabel(func);
+    if (frameSize + 2 + maxDepth > _stackSize) {
+        return fail(Error::StackOverrun, func);
+    }
+    _labels[funcIndex].maxDepth = maxDepth;
+    return true;
+}
+
+// Go through the instructions from the label at addr to the next label and
+// make sure none of the labels are inside an instruction
+bool
+Verifier::checkInstructions(uint16_t addr)
+{
+    uint16_t pc = addr;
+    int16_t i = findLabel(addr);
+    int16_t next = i + 1;
+
+    while (true) {
+        OpInfo info;
+        uint8_t len = opInfo(pc, info);
+        if (pc == addr && _labels[i].function) {
+            // opInfo() doesn't accept SetFrame
+            len = 2;
+        }
+        if (len == 0) {
+            return fail(Error::InvalidOp, pc);
+        }
+
+        if (next < _numLabels && _labels[next].addr < pc + len) {
+            return fail(Error::InvalidTarget, _labels[next].addr);
+        }
+
+        pc += len;
+        if (!info.next || (next < _numLabels && _labels[next].addr == pc)) {
+            return true;
+        }
+    }
+}
+
+bool
+Verifier::checkId(uint16_t id, uint8_t frameSize, uint16_t pc)
+{
+    // Same as the Interpreter's Address::fromId()
+    bool valid;
+    if (id < GlobalStart) {
+        valid = id < _constSize;
+    } else if (id < LocalStart) {
+        valid = (id - GlobalStart) < _globalSize;
+    } else {
+        valid = (id - LocalStart) < frameSize;
+    }
+    return valid ? true : fail(Error::IdOutOfRange, pc);
+}
+
+uint8_t
+Verifier::opInfo(uint16_t pc, OpInfo& info) const
+{
+    uint8_t cmd = rom(pc);
+    uint8_t index = 0;
+    if (cmd >= ExtOpcodeStart) {
+        index = cmd & 0x0f;
+        cmd &= 0xf0;
+    }
+
+    info.op = Op(cmd);
+    info.index = index;
+
+    // Only valid for ops with an id or target
+    uint16_t id = (uint16_t(index) << 8) | rom(pc + 1);
+    int16_t relTarg = (id & 0x800) ? int16_t(id | 0xf000) : int16_t(id);
+
+    switch(info.op) {
+        default:
+            return 0;
+        case Op::Push:
+        case Op::PushRef:
+            info.pushes = 1;
+            info.numIds = 1;
+            info.ids[0] = id;
+            return 2;
+        case Op::Pop:
+            info.pops = 1;
+            info.numIds = 1;
+            info.ids[0] = id;
+            return 2;
+        case Op::PushIntConst:
+            info.pushes = 1;
+            return 2;
+        case Op::PushIntConstS:
+            info.pushes = 1;
+            return 1;
+        case Op::If:
+            info.pops = 1;
+            info.targ = pc + 2 + relTarg;
+            return 2;
+        case Op::Jump:
+            info.targ = pc + 2 + relTarg;
+            info.next = false;
+            return 2;
+        case Op::Call:
+            // pops is filled in from the callee's SetFrame
+            info.pushes = 1;
+            info.extra = 1;
+            info.targ = id + _codeOffset;
+            return 2;
+        case Op::Long: {
+            // Checked the same as the short ops
+            uint16_t longTarg = getUInt16(pc + 1);
+            switch(LongOp(index)) {
+                default:
+                    return 0;
+                case LongOp::Jump:
+                    info.op = Op::Jump;
+                    info.targ = pc + 3 + int16_t(longTarg);
+                    info.next = false;
+                    break;
+                case LongOp::If:
+                    info.op = Op::If;
+                    info.pops = 1;
+                    info.targ = pc + 3 + int16_t(longTarg);
+                    break;
+                case LongOp::Call:
+                    info.op = Op::Call;
+                    info.pushes = 1;
+                    info.extra = 1;
+                    info.targ = longTarg + _codeOffset;
+                    break;
+            }
+            return 3;
+        }
+        case Op::CallNative:
+            // pops is filled in from the native function. callNative
+            // pushes a pc and bp for its frame
+            info.pushes = 1;
+            info.extra = 2;
+            return 2;
+        case Op::Return:
+            info.next = false;
+            return 1;
+        case Op::SetFrame:
+            // Only allowed at the start of a function
+            return 0;
+        case Op::Log:
+            info.pops = index;
+            return 2 + rom(pc + 1);
+        case Op::AddIntConst:
+            info.pops = 1;
+            info.pushes = 1;
+            return 2;
+        case Op::Push2:
+            info.pushes = 2;
+            info.numIds = 2;
+            info.ids[0] = idFromSid(rom(pc + 1));
+            info.ids[1] = idFromSid(rom(pc + 2));
+            return 3;
+        case Op::StoreIntConst:
+            info.numIds = 1;
+            info.ids[0] = idFromSid(rom(pc + 1));
+            return 3;
+        case Op::AddToVar:
+            info.pops = 1;
+            info.numIds = 1;
+            info.ids[0] = idFromSid(rom(pc + 1));
+            return 2;
+        case Op::IfLTInt:
+        case Op::IfLEInt:
+        case Op::IfEQInt:
+        case Op::IfNEInt:
+        case Op::IfGEInt:
+        case Op::IfGTInt:
+            info.pops = 2;
+            info.targ = pc + 2 + rom(pc + 1);
+            return 2;
+        case Op::IncLoopLTInt:
+            info.numIds = 2;
+            info.ids[0] = idFromSid(rom(pc + 1));
+            info.ids[1] = idFromSid(rom(pc + 2));
+            info.targ = pc + 4 - rom(pc + 3);
+            return 4;
+        case Op::IncLoopLTIntConst:
+            info.numIds = 1;
+            info.ids[0] = idFromSid(rom(pc + 1));
+            info.targ = pc + 4 - rom(pc + 3);
+            return 4;
+
+        case Op::Drop:
+            info.pops = 1;
+            return 1;
+        case Op::PopDeref:
+            info.pops = 2;
+            return 1;
+        case Op::Dup:
+            info.pops = 1;
+            info.pushes = 2;
+            return 1;
+        case Op::Swap:
+            info.pops = 2;
+            info.pushes = 2;
+            return 1;
+
+        case Op::Offset:
+        case Op::PushDeref:
+        case Op::Not:
+        case Op::LNot:
+        case Op::NegInt:
+        case Op::NegFloat:
+        case Op::PreIncInt:
+        case Op::PreIncFloat:
+        case Op::PreDecInt:
+        case Op::PreDecFloat:
+        case Op::PostIncInt:
+        case Op::PostIncFloat:
+        case Op::PostDecInt:
+        case Op::PostDecFloat:
+        case Op::PreIncFixed:
+        case Op::PreDecFixed:
+        case Op::PostIncFixed:
+        case Op::PostDecFixed:
+            info.pops = 1;
+            info.pushes = 1;
+            return 1;
+
+        case Op::Index:
+        case Op::Or:
+        case Op::Xor:
+        case Op::And:
+        case Op::LOr:
+        case Op::LAnd:
+        case Op::LTInt:
+        case Op::LTFloat:
+        case Op::LEInt:
+        case Op::LEFloat:
+        case Op::EQInt:
+        case Op::EQFloat:
+        case Op::NEInt:
+        case Op::NEFloat:
+        case Op::GEInt:
+        case Op::GEFloat:
+        case Op::GTInt:
+        case Op::GTFloat:
+        case Op::AddInt:
+        case Op::AddFloat:
+        case Op::SubInt:
+        case Op::SubFloat:
+        case Op::MulInt:
+        case Op::MulFloat:
+        case Op::DivInt:
+        case Op::DivFloat:
+        case Op::MulFixed:
+        case Op::DivFixed:
+            info.pops = 2;
+            info.pushes = 1;
+            return 1;
+    }
+}
@@ -0,0 +1,196 @@
+/*-------------------------------------------------------------------------
+    This source file is a part of Clover
+    For the latest info, see https://github.com/cmarrin/Clover
+    Copyright (c) 2021-2022, Chris Marrin
+    All rights reserved.
+    Use of this source code is governed by the MIT license that can be
+    found in the LICENSE file.
+-------------------------------------------------------------------------*/
+
+// Bytecode verifier
+//
+// Walks all the code reachable from the commands once, without running
+// it. An executable that passes can be run without checking the stack or
+// variable addresses on every instruction. It checks that:
+//
+//      - the header is valid and every opcode is known
+//      - every jump and if target lands on the start of an instruction
+//        in the same function
+//      - every Call target and command entry starts with SetFrame
+//      - the stack is the same depth every time an instruction is
+//        reached, never goes below the frame and a frame with its
+//        deepest stack fits in the header's stack size
+//      - the init and loop of every command, with everything they call,
+//        fit in the header's stack size unless they can recurse
+//      - Push, Pop and PushRef ids are in the const, global or local
+//        (params and locals of the function) range
+//      - every CallNative id has a native function
+//
+// It also records the calls each function makes, so stackSize() can give
+// the exact stack an entry point needs with everything it calls. When
+// stackBounded() is true the stack can't overrun, so it doesn't need to
+// be checked as the code runs.
+//
+// A subclass supplies the ROM and native function param counts, so it
+// can be used on the device (see Interpreter::load()) or over a buffer.
+//
+
+#pragma once
+
+#include "Opcodes.h"
+
+namespace clvr {
+
+class Verifier
+{
+public:
+    enum class Error {
+        None,
+        InvalidSignature,
+        InvalidOp,
+        InvalidTarget,
+        ExpectedSetFrame,
+        IdOutOfRange,
+        InvalidNativeFunction,
+        StackMismatch,
+        StackUnderrun,
+        StackOverrun,
+        OutOfMemory,
+    };
+
+    virtual ~Verifier()
+    {
+        if (!_buffer) {
+            delete [ ] _labels;
+            delete [ ] _calls;
+        }
+    }
+
+    // Keep the labels and calls in the size bytes at buf rather than on
+    // the heap. If they don't fit verify() fails with OutOfMemory. Call
+    // before verify()
+    void setBuffer(uint8_t* buf, uint16_t size);
+
+    bool verify();
+
+    Error error() const { return _error; }
+
+    // ROM address of the instruction with the error or -1
+    int16_t errorAddr() const { return _errorAddr; }
+
+    // The deepest the operand stack (above the frame) gets in the function
+    // starting at the passed ROM addr or in any function.
+    uint8_t maxDepth(uint16_t addr) const;
+    uint8_t maxDepth() const { return _maxDepth; }
+
+    // Words of stack the function starting at the passed ROM addr needs,
+    // counting its params, frame, operand stack and everything it calls.
+    // Returns UnboundedStack if it can call itself. Only valid after
+    // verify() succeeds.
+    static constexpr uint16_t UnboundedStack = 0xffff;
+    uint16_t stackSize(uint16_t addr) const;
+    bool stackBounded() const { return _stackBounded; }
+
+protected:
+    virtual uint8_t rom(uint16_t addr) const = 0;
+
+    // Return -1 if id is not a native function
+    virtual int16_t numNativeParams(uint8_t id) const = 0;
+
+private:
+    static constexpr int16_t NoIndex = -1;
+    static constexpr int16_t NoDepth = -1;
+
+    // A Label is the start of a function or the target of a jump. Code
+    // is walked from each label until it reaches a label already walked,
+    // a Return or a Jump
+    struct Label
+    {
+        uint16_t addr;
+        uint16_t func;          // Addr of the function's SetFrame
+        int16_t depth;          // Stack depth on entry
+        uint8_t maxDepth;       // Only used by function labels
+        uint8_t frameSize;      // Params + locals, only used by function labels
+        bool function;
+        bool walked;
+    };
+
+    // A Call from the function at func. base is the depth of the caller's
+    // operand stack below the callee's params
+    struct CallSite
+    {
+        uint16_t func;
+        uint16_t callee;
+        uint8_t base;
+    };
+
+    uint16_t getUInt16(uint16_t addr) const
+    {
+        return uint16_t(rom(addr)) | (uint16_t(rom(addr + 1)) << 8);
+    }
+
+    bool fail(Error error, uint16_t addr)
+    {
+        _error = error;
+        _errorAddr = addr;
+        return false;
+    }
+
+    int16_t findLabel(uint16_t addr) const;
+    int16_t addLabel(uint16_t addr);
+    bool growLabels();
+
+    bool addFunction(uint16_t addr, uint16_t from, uint8_t& params);
+    bool addCall(uint16_t func, uint16_t callee, uint8_t base);
+    uint16_t functionStackSize(int16_t index, uint16_t* sizes) const;
+    bool addBranch(uint16_t addr, uint16_t from, uint16_t func, int16_t depth);
+    bool walk(uint16_t addr);
+    bool checkInstructions(uint16_t addr);
+    bool checkId(uint16_t id, uint8_t frameSize, uint16_t pc);
+
+    // Stack effect of an instruction. extra is how far the stack gets
+    // above its starting depth in the middle of the op. An op has up to
+    // 2 ids. targ is the ROM addr of a jump or call target or -1. next is
+    // false if execution doesn't continue with the next instruction.
+    struct OpInfo
+    {
+        Op op = Op::None;
+        uint8_t index = 0;
+        uint8_t pops = 0;
+        uint8_t pushes = 0;
+        uint8_t extra = 0;
+        int32_t targ = -1;
+        uint8_t numIds = 0;
+        uint16_t ids[2];
+        bool next = true;
+    };
+
+    // Return the length of the instruction at pc or 0 if it's invalid
+    uint8_t opInfo(uint16_t pc, OpInfo&) const;
+
+    Error _error = Error::None;
+    int16_t _errorAddr = -1;
+
+    uint16_t _constSize = 0;
+    uint16_t _globalSize = 0;
+    uint16_t _stackSize = 0;
+    uint16_t _codeOffset = 0;
+    uint8_t _maxDepth = 0;
+    bool _stackBounded = false;
+
+    // With a buffer the labels grow up from its start and the calls grow
+    // down from its end
+    uint8_t* _buffer = nullptr;
+    uint8_t* _bufferEnd = nullptr;
+
+    // Sorted by addr
+    Label* _labels = nullptr;
+    uint16_t _numLabels = 0;
+    uint16_t _labelsCapacity = 0;
+
+    CallSite* _calls = nullptr;
+    uint16_t _numCalls = 0;
+    uint16_t _callsCapacity = 0;
+};
+
+}
@@ -16,6 +16,8 @@
 #include "TestFunction.h"
 #include "TestPtrStruct.h"
 #include "TestCore.h"
+#include "TestFixed.h"
+#include "TestArray.h"
 
 /*
 
@@ -39,6 +41,11 @@ public:
         return EEPROM[i];
     }
     
+    virtual void romRead(uint16_t addr, uint8_t* buf, uint16_t len) const override
+    {
+        eeprom_read_block(buf, reinterpret_cast<const void*>(addr), len);
+    }
+    
     virtual void log(const char* s) const override
     {
         Serial.print(s);
@@ -99,6 +106,15 @@ public:
             case Device::Error::WrongNumberOfArgs:
             errorMsg = F("wrong arg cnt");
             break;
+            case Device::Error::NativeIdConflict:
+            errorMsg = F("native id conflict");
+            break;
+            case Device::Error::OutOfMemory:
+            errorMsg = F("arena too small");
+            break;
+            case Device::Error::DivideByZero:
+            errorMsg = F("divide by zero");
+            break;
         }
 
         Serial.print(F("Interp err: "));
@@ -133,6 +149,9 @@ public:
             }
         }
         
+        // Parse the (possibly new) executable
+        _device.load();
+
         // Run the test
         uint8_t buf[3] = { 4, 7, 11 };
         if (!_device.init("test", buf, 3)) {
@@ -145,7 +164,11 @@ public:
 	{
 	    Serial.begin(115200);
 		delay(500);
-        randomSeed(millis());
+        
+        // Random numbers come from the Interpreter, not Arduino's random().
+        // millis() is the same here on every boot, so mix in the noise of
+        // an unconnected analog pin to get a different sequence each time
+        _device.seedRandom((uint32_t(analogRead(A0)) << 16) ^ micros());
         
 		Serial.println(F("Test v0.1"));
   
@@ -156,6 +179,8 @@ public:
         RunTest(TestFunction);
         RunTest(TestPtrStruct);
         RunTest(TestCore);
+        RunTest(TestFixed);
+        RunTest(TestArray);
     }
 
 	void loop()
@@ -0,0 +1,118 @@
+static const uint8_t PROGMEM EEPROM_Upload_TestArray[ ] = {
+0x61, 0x72, 0x6c, 0x79, 0x2b, 0x00, 0x50, 0x00, 
+0x15, 0x00, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 
+0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x04, 0x00, 
+0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 
+0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 
+0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x09, 0x00, 
+0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x19, 0x00, 
+0x00, 0x00, 0x24, 0x00, 0x00, 0x00, 0x31, 0x00, 
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 
+0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 
+0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x05, 0x00, 
+0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x0d, 0x00, 
+0x00, 0x00, 0x15, 0x00, 0x00, 0x00, 0x22, 0x00, 
+0x00, 0x00, 0x37, 0x00, 0x00, 0x00, 0x00, 0x00, 
+0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 
+0x01, 0x00, 0x00, 0x80, 0x01, 0x00, 0x00, 0x00, 
+0x00, 0x00, 0x78, 0x00, 0x00, 0x00, 0x3c, 0x00, 
+0x00, 0x00, 0x28, 0x00, 0x00, 0x00, 0x1e, 0x00, 
+0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0xfe, 0xff, 
+0xff, 0xff, 0x00, 0x00, 0xc0, 0x3f, 0x00, 0x00, 
+0x20, 0x40, 0x00, 0x00, 0x80, 0x40, 0x00, 0x00, 
+0x00, 0x3f, 0x00, 0x00, 0x80, 0x3e, 0x00, 0x00, 
+0x08, 0x40, 0x00, 0x00, 0x02, 0x00, 0x74, 0x65, 
+0x73, 0x74, 0x00, 0x00, 0x00, 0x03, 0xbf, 0x00, 
+0xbf, 0x00, 0x00, 0xc1, 0x00, 0x4c, 0x00, 0x33, 
+0xe0, 0x05, 0xb0, 0x01, 0x20, 0xdf, 0xf6, 0xa0, 
+0x0b, 0xc3, 0x02, 0x5c, 0x00, 0xa9, 0x3e, 0x05, 
+0x37, 0x83, 0x13, 0xd0, 0x03, 0x37, 0x83, 0x14, 
+0x5c, 0x00, 0xb1, 0x0d, 0x20, 0x20, 0x20, 0x20, 
+0x54, 0x65, 0x73, 0x74, 0x20, 0x25, 0x69, 0x3a, 
+0x20, 0x5c, 0x03, 0x6c, 0x04, 0x4c, 0x04, 0x33, 
+0xe0, 0x05, 0xb0, 0x01, 0x20, 0xdf, 0xf6, 0x36, 
+0x81, 0x82, 0x3c, 0x1c, 0x36, 0x81, 0x82, 0xb2, 
+0x15, 0x46, 0x41, 0x49, 0x4c, 0x3a, 0x20, 0x65, 
+0x78, 0x70, 0x20, 0x25, 0x69, 0x2c, 0x20, 0x67, 
+0x6f, 0x74, 0x20, 0x25, 0x69, 0x0a, 0xd0, 0x07, 
+0xb0, 0x05, 0x50, 0x61, 0x73, 0x73, 0x0a, 0xa0, 
+0x0b, 0xc3, 0x02, 0x5c, 0x00, 0xa9, 0x3e, 0x05, 
+0x37, 0x83, 0x13, 0xd0, 0x03, 0x37, 0x83, 0x14, 
+0x5c, 0x00, 0xb1, 0x0d, 0x20, 0x20, 0x20, 0x20, 
+0x54, 0x65, 0x73, 0x74, 0x20, 0x25, 0x69, 0x3a, 
+0x20, 0x5c, 0x03, 0x6c, 0x04, 0x4c, 0x04, 0x33, 
+0xe0, 0x05, 0xb0, 0x01, 0x20, 0xdf, 0xf6, 0x36, 
+0x81, 0x82, 0x1e, 0xe0, 0x1c, 0x36, 0x81, 0x82, 
+0xb2, 0x15, 0x46, 0x41, 0x49, 0x4c, 0x3a, 0x20, 
+0x65, 0x78, 0x70, 0x20, 0x25, 0x66, 0x2c, 0x20, 
+0x67, 0x6f, 0x74, 0x20, 0x25, 0x66, 0x0a, 0xd0, 
+0x07, 0xb0, 0x05, 0x50, 0x61, 0x73, 0x73, 0x0a, 
+0xa0, 0x0b, 0xc0, 0x09, 0xb0, 0x16, 0x0a, 0x54, 
+0x65, 0x73, 0x74, 0x20, 0x41, 0x72, 0x72, 0x61, 
+0x79, 0x20, 0x46, 0x75, 0x6e, 0x63, 0x74, 0x69, 
+0x6f, 0x6e, 0x73, 0x0a, 0xb0, 0x12, 0x0a, 0x54, 
+0x65, 0x73, 0x74, 0x20, 0x43, 0x6f, 0x70, 0x79, 
+0x2f, 0x52, 0x6f, 0x74, 0x61, 0x74, 0x65, 0x0a, 
+0x4c, 0x00, 0x40, 0x00, 0xa5, 0x0a, 0x18, 0x05, 
+0xa1, 0xa3, 0x4c, 0x00, 0xa2, 0x91, 0x02, 0x70, 
+0x0e, 0x05, 0x48, 0x00, 0x4c, 0x00, 0xa5, 0x0a, 
+0x18, 0x05, 0xa2, 0xa5, 0x48, 0x00, 0xa4, 0x91, 
+0x02, 0x70, 0x0e, 0x05, 0x4c, 0x00, 0xa1, 0x91, 
+0x4c, 0x00, 0xa4, 0x0a, 0x18, 0x05, 0xa3, 0xa1, 
+0x4c, 0x00, 0xa1, 0x91, 0x02, 0x70, 0x0e, 0x05, 
+0xa4, 0xa4, 0x4c, 0x00, 0xa4, 0x91, 0x02, 0x70, 
+0x0e, 0x05, 0x4c, 0x00, 0x40, 0x00, 0xa5, 0x0a, 
+0x18, 0x05, 0x4c, 0x00, 0xa2, 0xa5, 0x0a, 0x19, 
+0x05, 0xa5, 0xa3, 0x4c, 0x00, 0xa0, 0x91, 0x02, 
+0x70, 0x0e, 0x05, 0xa6, 0xa2, 0x4c, 0x00, 0xa4, 
+0x91, 0x02, 0x70, 0x0e, 0x05, 0x4c, 0x00, 0x50, 
+0x23, 0xa5, 0x0a, 0x19, 0x05, 0xa7, 0xa1, 0x4c, 
+0x00, 0xa0, 0x91, 0x02, 0x70, 0x0e, 0x05, 0xa8, 
+0xa5, 0x4c, 0x00, 0xa4, 0x91, 0x02, 0x70, 0x0e, 
+0x05, 0xb0, 0x0a, 0x0a, 0x54, 0x65, 0x73, 0x74, 
+0x20, 0x49, 0x6e, 0x74, 0x0a, 0x4c, 0x00, 0x48, 
+0x00, 0xa5, 0x0a, 0x1c, 0x05, 0xa9, 0xa8, 0x4c, 
+0x00, 0xa3, 0x91, 0x02, 0x70, 0x0e, 0x05, 0x4c, 
+0x00, 0x01, 0xc8, 0xa5, 0x0a, 0x09, 0x05, 0x4c, 
+0x00, 0x01, 0x80, 0xa5, 0x0a, 0x1a, 0x05, 0xaa, 
+0x01, 0x64, 0x4c, 0x00, 0xa1, 0x91, 0x02, 0x70, 
+0x0e, 0x05, 0x48, 0x00, 0xa0, 0xa5, 0x0a, 0x09, 
+0x05, 0x4c, 0x00, 0x48, 0x00, 0x01, 0x40, 0xa5, 
+0x0a, 0x1e, 0x05, 0xab, 0x01, 0x4b, 0x4c, 0x00, 
+0xa4, 0x91, 0x02, 0x70, 0x0e, 0x05, 0xb0, 0x0c, 
+0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 0x46, 0x6c, 
+0x6f, 0x61, 0x74, 0x0a, 0x4c, 0x05, 0xa0, 0xa4, 
+0x0a, 0x09, 0x05, 0x4c, 0x05, 0xa1, 0x91, 0x50, 
+0x24, 0x03, 0x48, 0x05, 0xa1, 0x91, 0x50, 0x25, 
+0x03, 0x4c, 0x05, 0x48, 0x05, 0xa4, 0x0a, 0x1d, 
+0x05, 0xac, 0x50, 0x26, 0x4c, 0x05, 0xa1, 0x91, 
+0x02, 0x70, 0x66, 0x05, 0x4c, 0x05, 0x50, 0x27, 
+0xa4, 0x0a, 0x1b, 0x05, 0xad, 0x50, 0x05, 0x4c, 
+0x05, 0xa1, 0x91, 0x02, 0x70, 0x66, 0x05, 0x4c, 
+0x05, 0x48, 0x05, 0x50, 0x28, 0xa4, 0x0a, 0x1f, 
+0x05, 0xae, 0x50, 0x29, 0x4c, 0x05, 0xa1, 0x91, 
+0x02, 0x70, 0x66, 0x05, 0xaf, 0x50, 0x06, 0x4c, 
+0x05, 0xa0, 0x91, 0x02, 0x70, 0x66, 0x05, 0xb0, 
+0x15, 0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 0x57, 
+0x69, 0x64, 0x65, 0x20, 0x41, 0x64, 0x64, 0x72, 
+0x65, 0x73, 0x73, 0x65, 0x73, 0x0a, 0x48, 0x09, 
+0x01, 0x45, 0x91, 0x01, 0x2a, 0x03, 0x37, 0x4f, 
+0x07, 0x01, 0x10, 0x01, 0x2a, 0x48, 0x09, 0x01, 
+0x45, 0x91, 0x02, 0x70, 0x0e, 0x05, 0x01, 0x11, 
+0xa7, 0x58, 0x4f, 0x70, 0x0e, 0x05, 0x48, 0x09, 
+0xa3, 0x01, 0x46, 0x0a, 0x09, 0x05, 0x01, 0x12, 
+0xa3, 0x48, 0x09, 0x01, 0x45, 0x91, 0x02, 0x70, 
+0x0e, 0x05, 0x01, 0x13, 0xa7, 0x58, 0x4f, 0x70, 
+0x0e, 0x05, 0xb0, 0x22, 0x0a, 0x54, 0x65, 0x73, 
+0x74, 0x20, 0x74, 0x61, 0x62, 0x6c, 0x65, 0x73, 
+0x20, 0x6d, 0x61, 0x64, 0x65, 0x20, 0x61, 0x74, 
+0x20, 0x63, 0x6f, 0x6d, 0x70, 0x69, 0x6c, 0x65, 
+0x20, 0x74, 0x69, 0x6d, 0x65, 0x0a, 0x01, 0x14, 
+0x01, 0x31, 0x40, 0x06, 0xa7, 0x91, 0x02, 0x70, 
+0x0e, 0x05, 0x01, 0x15, 0x01, 0x37, 0x40, 0x0e, 
+0xaa, 0x91, 0x02, 0x70, 0x0e, 0x05, 0x01, 0x16, 
+0xa3, 0x40, 0x19, 0xa3, 0x91, 0x02, 0x50, 0x2a, 
+0x07, 0x0a, 0x11, 0x70, 0x0e, 0x05, 0x01, 0x17, 
+0x01, 0x18, 0x40, 0x1d, 0xa5, 0x91, 0x02, 0x70, 
+0x0e, 0x05, 0xb0, 0x07, 0x0a, 0x44, 0x6f, 0x6e, 
+0x65, 0x0a, 0x0a, 0xa0, 0x0b, };
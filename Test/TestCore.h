@@ -1,6 +1,6 @@
 static const uint8_t PROGMEM EEPROM_Upload_TestCore[ ] = {
-0x61, 0x72, 0x6c, 0x79, 0x10, 0x00, 0x14, 0x00, 
-0x54, 0x00, 0x00, 0x00, 0xc0, 0x3f, 0x00, 0x00, 
+0x61, 0x72, 0x6c, 0x79, 0x12, 0x00, 0x14, 0x00, 
+0x24, 0x00, 0x00, 0x00, 0xc0, 0x3f, 0x00, 0x00, 
 0x00, 0x3f, 0x00, 0x00, 0x80, 0x3f, 0x00, 0x00, 
 0x40, 0x40, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 
 0x20, 0x40, 0xff, 0xff, 0xff, 0xff, 0x9a, 0x99, 
@@ -8,98 +8,120 @@ static const uint8_t PROGMEM EEPROM_Upload_TestCore[ ] = {
 0x60, 0x40, 0x00, 0x00, 0xb0, 0x40, 0x56, 0x08, 
 0x00, 0x00, 0x00, 0x00, 0xa4, 0x41, 0x00, 0x00, 
 0xac, 0x41, 0x00, 0x00, 0x28, 0x41, 0x00, 0x00, 
-0x38, 0x41, 0x74, 0x65, 0x73, 0x74, 0x00, 0x00, 
-0x00, 0x03, 0xbc, 0x00, 0xbc, 0x00, 0x00, 0xc1, 
+0x38, 0x41, 0x60, 0x79, 0xfe, 0xff, 0xa0, 0x86, 
+0x01, 0x00, 0x74, 0x65, 0x73, 0x74, 0x00, 0x00, 
+0x00, 0x03, 0xbf, 0x00, 0xbf, 0x00, 0x00, 0xc1, 
 0x00, 0x4c, 0x00, 0x33, 0xe0, 0x05, 0xb0, 0x01, 
-0x20, 0xdf, 0xf6, 0xa0, 0x0b, 0xc3, 0x01, 0x5c, 
-0x00, 0xa9, 0x21, 0xe0, 0x07, 0x4c, 0x03, 0x01, 
-0x13, 0x03, 0xd0, 0x05, 0x4c, 0x03, 0x01, 0x14, 
-0x03, 0x5c, 0x00, 0xb1, 0x0d, 0x20, 0x20, 0x20, 
-0x20, 0x54, 0x65, 0x73, 0x74, 0x20, 0x25, 0x69, 
-0x3a, 0x20, 0x5c, 0x03, 0x70, 0x00, 0x05, 0x5c, 
-0x01, 0x5c, 0x02, 0x1d, 0xe0, 0x1d, 0x5c, 0x01, 
-0x5c, 0x02, 0xb2, 0x15, 0x46, 0x41, 0x49, 0x4c, 
-0x3a, 0x20, 0x65, 0x78, 0x70, 0x20, 0x25, 0x69, 
-0x2c, 0x20, 0x67, 0x6f, 0x74, 0x20, 0x25, 0x69, 
-0x0a, 0xd0, 0x07, 0xb0, 0x05, 0x50, 0x61, 0x73, 
-0x73, 0x0a, 0xa0, 0x0b, 0xc3, 0x01, 0x5c, 0x00, 
-0xa9, 0x21, 0xe0, 0x07, 0x4c, 0x03, 0x01, 0x13, 
-0x03, 0xd0, 0x05, 0x4c, 0x03, 0x01, 0x14, 0x03, 
-0x5c, 0x00, 0xb1, 0x0d, 0x20, 0x20, 0x20, 0x20, 
-0x54, 0x65, 0x73, 0x74, 0x20, 0x25, 0x69, 0x3a, 
-0x20, 0x5c, 0x03, 0x70, 0x00, 0x05, 0x5c, 0x01, 
-0x5c, 0x02, 0x1e, 0xe0, 0x1d, 0x5c, 0x01, 0x5c, 
-0x02, 0xb2, 0x15, 0x46, 0x41, 0x49, 0x4c, 0x3a, 
-0x20, 0x65, 0x78, 0x70, 0x20, 0x25, 0x66, 0x2c, 
-0x20, 0x67, 0x6f, 0x74, 0x20, 0x25, 0x66, 0x0a, 
-0xd0, 0x07, 0xb0, 0x05, 0x50, 0x61, 0x73, 0x73, 
-0x0a, 0xa0, 0x0b, 0xc0, 0x14, 0xb0, 0x12, 0x0a, 
-0x54, 0x65, 0x73, 0x74, 0x20, 0x43, 0x6f, 0x72, 
-0x65, 0x20, 0x4d, 0x6f, 0x64, 0x75, 0x6c, 0x65, 
-0x0a, 0xb0, 0x0e, 0x0a, 0x54, 0x65, 0x73, 0x74, 
-0x20, 0x41, 0x6e, 0x69, 0x6d, 0x61, 0x74, 0x65, 
-0x0a, 0x4c, 0x04, 0x4c, 0x00, 0x03, 0x4c, 0x00, 
-0x80, 0x50, 0x00, 0x03, 0x4c, 0x00, 0x81, 0x50, 
-0x01, 0x03, 0x4c, 0x00, 0x82, 0x50, 0x02, 0x03, 
-0x4c, 0x00, 0x83, 0x50, 0x03, 0x03, 0xa1, 0xa0, 
-0x5c, 0x04, 0x0a, 0x00, 0x70, 0x0e, 0x05, 0xa2, 
-0x50, 0x04, 0x4c, 0x00, 0x80, 0x02, 0x70, 0x65, 
-0x05, 0xa3, 0xa0, 0x4c, 0x00, 0x0a, 0x00, 0x70, 
-0x0e, 0x05, 0xa4, 0x50, 0x05, 0x4c, 0x00, 0x80, 
-0x02, 0x70, 0x65, 0x05, 0xa5, 0xa1, 0x4c, 0x00, 
-0x0a, 0x00, 0x70, 0x0e, 0x05, 0xa6, 0x50, 0x03, 
-0x4c, 0x00, 0x80, 0x02, 0x70, 0x65, 0x05, 0xa7, 
+0x20, 0xdf, 0xf6, 0xa0, 0x0b, 0xc3, 0x02, 0x5c, 
+0x00, 0xa9, 0x3e, 0x05, 0x37, 0x83, 0x13, 0xd0, 
+0x03, 0x37, 0x83, 0x14, 0x5c, 0x00, 0xb1, 0x0d, 
+0x20, 0x20, 0x20, 0x20, 0x54, 0x65, 0x73, 0x74, 
+0x20, 0x25, 0x69, 0x3a, 0x20, 0x5c, 0x03, 0x6c, 
+0x04, 0x4c, 0x04, 0x33, 0xe0, 0x05, 0xb0, 0x01, 
+0x20, 0xdf, 0xf6, 0x36, 0x81, 0x82, 0x3c, 0x1c, 
+0x36, 0x81, 0x82, 0xb2, 0x15, 0x46, 0x41, 0x49, 
+0x4c, 0x3a, 0x20, 0x65, 0x78, 0x70, 0x20, 0x25, 
+0x69, 0x2c, 0x20, 0x67, 0x6f, 0x74, 0x20, 0x25, 
+0x69, 0x0a, 0xd0, 0x07, 0xb0, 0x05, 0x50, 0x61, 
+0x73, 0x73, 0x0a, 0xa0, 0x0b, 0xc3, 0x02, 0x5c, 
+0x00, 0xa9, 0x3e, 0x05, 0x37, 0x83, 0x13, 0xd0, 
+0x03, 0x37, 0x83, 0x14, 0x5c, 0x00, 0xb1, 0x0d, 
+0x20, 0x20, 0x20, 0x20, 0x54, 0x65, 0x73, 0x74, 
+0x20, 0x25, 0x69, 0x3a, 0x20, 0x5c, 0x03, 0x6c, 
+0x04, 0x4c, 0x04, 0x33, 0xe0, 0x05, 0xb0, 0x01, 
+0x20, 0xdf, 0xf6, 0x36, 0x81, 0x82, 0x1e, 0xe0, 
+0x1c, 0x36, 0x81, 0x82, 0xb2, 0x15, 0x46, 0x41, 
+0x49, 0x4c, 0x3a, 0x20, 0x65, 0x78, 0x70, 0x20, 
+0x25, 0x66, 0x2c, 0x20, 0x67, 0x6f, 0x74, 0x20, 
+0x25, 0x66, 0x0a, 0xd0, 0x07, 0xb0, 0x05, 0x50, 
+0x61, 0x73, 0x73, 0x0a, 0xa0, 0x0b, 0xc0, 0x18, 
+0xb0, 0x12, 0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 
+0x43, 0x6f, 0x72, 0x65, 0x20, 0x4d, 0x6f, 0x64, 
+0x75, 0x6c, 0x65, 0x0a, 0xb0, 0x0e, 0x0a, 0x54, 
+0x65, 0x73, 0x74, 0x20, 0x41, 0x6e, 0x69, 0x6d, 
+0x61, 0x74, 0x65, 0x0a, 0x4c, 0x00, 0x6c, 0x04, 
+0x4c, 0x00, 0x80, 0x50, 0x00, 0x03, 0x4c, 0x00, 
+0x81, 0x50, 0x01, 0x03, 0x4c, 0x00, 0x82, 0x50, 
+0x02, 0x03, 0x4c, 0x00, 0x83, 0x50, 0x03, 0x03, 
+0xa1, 0xa0, 0x5c, 0x04, 0x0a, 0x00, 0x70, 0x0e, 
+0x05, 0xa2, 0x50, 0x04, 0x4c, 0x00, 0x80, 0x02, 
+0x70, 0x66, 0x05, 0xa3, 0xa0, 0x4c, 0x00, 0x0a, 
+0x00, 0x70, 0x0e, 0x05, 0xa4, 0x50, 0x05, 0x4c, 
+0x00, 0x80, 0x02, 0x70, 0x66, 0x05, 0xa5, 0xa1, 
+0x4c, 0x00, 0x0a, 0x00, 0x70, 0x0e, 0x05, 0xa6, 
+0x50, 0x03, 0x4c, 0x00, 0x80, 0x02, 0x70, 0x66, 
+0x05, 0xa7, 0xa0, 0x4c, 0x00, 0x0a, 0x00, 0x70, 
+0x0e, 0x05, 0xa8, 0x50, 0x05, 0x4c, 0x00, 0x80, 
+0x02, 0x70, 0x66, 0x05, 0xa9, 0xa0, 0x4c, 0x00, 
+0x0a, 0x00, 0x70, 0x0e, 0x05, 0xaa, 0x50, 0x04, 
+0x4c, 0x00, 0x80, 0x02, 0x70, 0x66, 0x05, 0xab, 
 0xa0, 0x4c, 0x00, 0x0a, 0x00, 0x70, 0x0e, 0x05, 
-0xa8, 0x50, 0x05, 0x4c, 0x00, 0x80, 0x02, 0x70, 
-0x65, 0x05, 0xa9, 0xa0, 0x4c, 0x00, 0x0a, 0x00, 
-0x70, 0x0e, 0x05, 0xaa, 0x50, 0x04, 0x4c, 0x00, 
-0x80, 0x02, 0x70, 0x65, 0x05, 0xab, 0xa0, 0x4c, 
-0x00, 0x0a, 0x00, 0x70, 0x0e, 0x05, 0xac, 0x50, 
-0x00, 0x4c, 0x00, 0x80, 0x02, 0x70, 0x65, 0x05, 
-0xad, 0x50, 0x06, 0x4c, 0x00, 0x0a, 0x00, 0x70, 
-0x0e, 0x05, 0xae, 0x50, 0x02, 0x4c, 0x00, 0x80, 
-0x02, 0x70, 0x65, 0x05, 0xaf, 0xa0, 0x4c, 0x00, 
-0x0a, 0x00, 0x70, 0x0e, 0x05, 0x01, 0x10, 0x50, 
-0x00, 0x4c, 0x00, 0x80, 0x02, 0x70, 0x65, 0x05, 
-0xb0, 0x0c, 0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 
-0x50, 0x61, 0x72, 0x61, 0x6d, 0x0a, 0x01, 0x11, 
-0xa4, 0xa0, 0x0a, 0x01, 0x70, 0x0e, 0x05, 0x01, 
-0x12, 0xa7, 0xa1, 0x0a, 0x01, 0x70, 0x0e, 0x05, 
-0x01, 0x13, 0xab, 0xa2, 0x0a, 0x01, 0x70, 0x0e, 
-0x05, 0xb0, 0x16, 0x0a, 0x54, 0x65, 0x73, 0x74, 
-0x20, 0x54, 0x79, 0x70, 0x65, 0x20, 0x43, 0x6f, 
-0x6e, 0x76, 0x65, 0x72, 0x73, 0x69, 0x6f, 0x6e, 
-0x0a, 0x01, 0x14, 0xa5, 0x50, 0x07, 0x0a, 0x03, 
-0x70, 0x0e, 0x05, 0x01, 0x15, 0x50, 0x08, 0xa7, 
-0x0a, 0x02, 0x50, 0x01, 0x24, 0x70, 0x65, 0x05, 
-0xb0, 0x0d, 0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 
-0x52, 0x61, 0x6e, 0x64, 0x6f, 0x6d, 0x0a, 0x4c, 
-0x08, 0xa3, 0xa5, 0x0a, 0x07, 0x03, 0x01, 0x16, 
-0xa1, 0x5c, 0x08, 0xa3, 0x1f, 0x5c, 0x08, 0xa5, 
-0x19, 0x15, 0x70, 0x0e, 0x05, 0x4c, 0x09, 0x50, 
-0x09, 0x50, 0x0a, 0x0a, 0x08, 0x03, 0x01, 0x17, 
-0xa1, 0x5c, 0x09, 0x50, 0x09, 0x20, 0x5c, 0x09, 
-0x50, 0x0a, 0x1a, 0x15, 0x70, 0x0e, 0x05, 0xb0, 
-0x10, 0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 0x49, 
-0x6e, 0x69, 0x74, 0x41, 0x72, 0x72, 0x61, 0x79, 
-0x0a, 0x4c, 0x0a, 0x01, 0xc8, 0xaa, 0x0a, 0x09, 
-0x05, 0x01, 0x18, 0x01, 0xc8, 0x4c, 0x0a, 0xa5, 
-0x91, 0x02, 0x70, 0x0e, 0x05, 0x48, 0x00, 0x50, 
-0x0b, 0x01, 0x14, 0x0a, 0x09, 0x05, 0x01, 0x19, 
-0x50, 0x0b, 0x48, 0x00, 0xa9, 0x91, 0x02, 0x70, 
-0x0e, 0x05, 0xb0, 0x0e, 0x0a, 0x54, 0x65, 0x73, 
-0x74, 0x20, 0x4d, 0x69, 0x6e, 0x2f, 0x4d, 0x61, 
-0x78, 0x0a, 0x01, 0x1a, 0x01, 0x14, 0x01, 0x14, 
-0x01, 0x15, 0x0a, 0x0a, 0x70, 0x0e, 0x05, 0x01, 
-0x1b, 0xaa, 0xab, 0xaa, 0x0a, 0x0a, 0x70, 0x0e, 
-0x05, 0x01, 0x1c, 0x01, 0x15, 0x01, 0x14, 0x01, 
-0x15, 0x0a, 0x0c, 0x70, 0x0e, 0x05, 0x01, 0x1d, 
-0xab, 0xab, 0xaa, 0x0a, 0x0c, 0x70, 0x0e, 0x05, 
-0x01, 0x1e, 0x50, 0x0c, 0x50, 0x0c, 0x50, 0x0d, 
-0x0a, 0x0b, 0x70, 0x65, 0x05, 0x01, 0x1f, 0x50, 
-0x0e, 0x50, 0x0f, 0x50, 0x0e, 0x0a, 0x0b, 0x70, 
-0x65, 0x05, 0x01, 0x20, 0x50, 0x0d, 0x50, 0x0c, 
-0x50, 0x0d, 0x0a, 0x0d, 0x70, 0x65, 0x05, 0x01, 
-0x21, 0x50, 0x0f, 0x50, 0x0f, 0x50, 0x0e, 0x0a, 
-0x0d, 0x70, 0x65, 0x05, 0xb0, 0x07, 0x0a, 0x44, 
-0x6f, 0x6e, 0x65, 0x0a, 0x0a, 0xa0, 0x0b, };
+0xac, 0x50, 0x00, 0x4c, 0x00, 0x80, 0x02, 0x70, 
+0x66, 0x05, 0xad, 0x50, 0x06, 0x4c, 0x00, 0x0a, 
+0x00, 0x70, 0x0e, 0x05, 0xae, 0x50, 0x02, 0x4c, 
+0x00, 0x80, 0x02, 0x70, 0x66, 0x05, 0xaf, 0xa0, 
+0x4c, 0x00, 0x0a, 0x00, 0x70, 0x0e, 0x05, 0x01, 
+0x10, 0x50, 0x00, 0x4c, 0x00, 0x80, 0x02, 0x70, 
+0x66, 0x05, 0xb0, 0x0c, 0x0a, 0x54, 0x65, 0x73, 
+0x74, 0x20, 0x50, 0x61, 0x72, 0x61, 0x6d, 0x0a, 
+0x01, 0x11, 0xa4, 0xa0, 0x0a, 0x01, 0x70, 0x0e, 
+0x05, 0x01, 0x12, 0xa7, 0xa1, 0x0a, 0x01, 0x70, 
+0x0e, 0x05, 0x01, 0x13, 0xab, 0xa2, 0x0a, 0x01, 
+0x70, 0x0e, 0x05, 0xb0, 0x16, 0x0a, 0x54, 0x65, 
+0x73, 0x74, 0x20, 0x54, 0x79, 0x70, 0x65, 0x20, 
+0x43, 0x6f, 0x6e, 0x76, 0x65, 0x72, 0x73, 0x69, 
+0x6f, 0x6e, 0x0a, 0x01, 0x14, 0xa5, 0x50, 0x07, 
+0x0a, 0x03, 0x70, 0x0e, 0x05, 0x01, 0x15, 0x50, 
+0x08, 0xa7, 0x0a, 0x02, 0x50, 0x01, 0x24, 0x70, 
+0x66, 0x05, 0xb0, 0x0d, 0x0a, 0x54, 0x65, 0x73, 
+0x74, 0x20, 0x52, 0x61, 0x6e, 0x64, 0x6f, 0x6d, 
+0x0a, 0x4c, 0x08, 0xa3, 0xa5, 0x0a, 0x07, 0x03, 
+0x01, 0x16, 0xa1, 0x5c, 0x08, 0xa3, 0x1f, 0x5c, 
+0x08, 0xa5, 0x19, 0x15, 0x70, 0x0e, 0x05, 0x4c, 
+0x09, 0x50, 0x09, 0x50, 0x0a, 0x0a, 0x08, 0x03, 
+0x01, 0x17, 0xa1, 0x5c, 0x09, 0x50, 0x09, 0x20, 
+0x5c, 0x09, 0x50, 0x0a, 0x1a, 0x15, 0x70, 0x0e, 
+0x05, 0xb0, 0x10, 0x0a, 0x54, 0x65, 0x73, 0x74, 
+0x20, 0x49, 0x6e, 0x69, 0x74, 0x41, 0x72, 0x72, 
+0x61, 0x79, 0x0a, 0x4c, 0x0a, 0x01, 0xc8, 0xaa, 
+0x0a, 0x09, 0x05, 0x01, 0x18, 0x01, 0xc8, 0x4c, 
+0x0a, 0xa5, 0x91, 0x02, 0x70, 0x0e, 0x05, 0x48, 
+0x00, 0x50, 0x0b, 0x01, 0x14, 0x0a, 0x09, 0x05, 
+0x01, 0x19, 0x50, 0x0b, 0x48, 0x00, 0xa9, 0x91, 
+0x02, 0x70, 0x0e, 0x05, 0xb0, 0x0e, 0x0a, 0x54, 
+0x65, 0x73, 0x74, 0x20, 0x4d, 0x69, 0x6e, 0x2f, 
+0x4d, 0x61, 0x78, 0x0a, 0x01, 0x1a, 0x01, 0x14, 
+0x01, 0x14, 0x01, 0x15, 0x0a, 0x0a, 0x70, 0x0e, 
+0x05, 0x01, 0x1b, 0xaa, 0xab, 0xaa, 0x0a, 0x0a, 
+0x70, 0x0e, 0x05, 0x01, 0x1c, 0x01, 0x15, 0x01, 
+0x14, 0x01, 0x15, 0x0a, 0x0c, 0x70, 0x0e, 0x05, 
+0x01, 0x1d, 0xab, 0xab, 0xaa, 0x0a, 0x0c, 0x70, 
+0x0e, 0x05, 0x01, 0x1e, 0x50, 0x0c, 0x50, 0x0c, 
+0x50, 0x0d, 0x0a, 0x0b, 0x70, 0x66, 0x05, 0x01, 
+0x1f, 0x50, 0x0e, 0x50, 0x0f, 0x50, 0x0e, 0x0a, 
+0x0b, 0x70, 0x66, 0x05, 0x01, 0x20, 0x50, 0x0d, 
+0x50, 0x0c, 0x50, 0x0d, 0x0a, 0x0d, 0x70, 0x66, 
+0x05, 0x01, 0x21, 0x50, 0x0f, 0x50, 0x0f, 0x50, 
+0x0e, 0x0a, 0x0d, 0x70, 0x66, 0x05, 0xb0, 0x16, 
+0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 0x52, 0x61, 
+0x6e, 0x64, 0x6f, 0x6d, 0x46, 0x69, 0x6c, 0x6c, 
+0x41, 0x72, 0x72, 0x61, 0x79, 0x0a, 0x4c, 0x0a, 
+0xa3, 0xa6, 0xaa, 0x0a, 0x04, 0x05, 0x37, 0x94, 
+0x01, 0x37, 0x95, 0x00, 0x5c, 0x15, 0xaa, 0x39, 
+0x1e, 0x4c, 0x0a, 0x5c, 0x15, 0x91, 0x6c, 0x16, 
+0x5c, 0x16, 0x02, 0xa3, 0x17, 0x5c, 0x16, 0x02, 
+0xa6, 0x1f, 0x14, 0xe0, 0x03, 0x37, 0x94, 0x00, 
+0xa1, 0x38, 0x96, 0x09, 0x95, 0x0a, 0x17, 0x01, 
+0x22, 0xa1, 0x5c, 0x14, 0x70, 0x0e, 0x05, 0x48, 
+0x00, 0x50, 0x10, 0x50, 0x11, 0x01, 0x14, 0x0a, 
+0x04, 0x05, 0x37, 0x94, 0x01, 0x37, 0x95, 0x00, 
+0x5c, 0x15, 0x01, 0x14, 0x39, 0x20, 0x48, 0x00, 
+0x5c, 0x15, 0x91, 0x6c, 0x17, 0x5c, 0x17, 0x02, 
+0x50, 0x10, 0x17, 0x5c, 0x17, 0x02, 0x50, 0x11, 
+0x1f, 0x14, 0xe0, 0x03, 0x37, 0x94, 0x00, 0xa1, 
+0x38, 0x97, 0x09, 0x95, 0x14, 0x19, 0x01, 0x23, 
+0xa1, 0x5c, 0x14, 0x70, 0x0e, 0x05, 0x4c, 0x0a, 
+0xa7, 0xa7, 0xaa, 0x0a, 0x04, 0x05, 0x01, 0x24, 
+0xa7, 0x4c, 0x0a, 0xa9, 0x91, 0x02, 0x70, 0x0e, 
+0x05, 0xb0, 0x07, 0x0a, 0x44, 0x6f, 0x6e, 0x65, 
+0x0a, 0x0a, 0xa0, 0x0b, };
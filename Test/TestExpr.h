@@ -1,7 +1,6 @@
 static const uint8_t PROGMEM EEPROM_Upload_TestExpr[ ] = {
-0x61, 0x72, 0x6c, 0x79, 0x1c, 0x00, 0x02, 0x00, 
-0x42, 0x00, 0xfc, 0x00, 0x00, 0x00, 0x00, 0x00, 
-0x60, 0x40, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 
+0x61, 0x72, 0x6c, 0x79, 0x1b, 0x00, 0x02, 0x00, 
+0x0e, 0x00, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 
 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x07, 0x00, 
 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x09, 0x00, 
 0x00, 0x00, 0x00, 0x00, 0xc0, 0x3f, 0x00, 0x00, 
@@ -10,119 +9,119 @@ static const uint8_t PROGMEM EEPROM_Upload_TestExpr[ ] = {
 0x18, 0x41, 0x00, 0x00, 0xd0, 0x40, 0x26, 0x01, 
 0x00, 0x00, 0x58, 0x29, 0x00, 0x00, 0xd6, 0xff, 
 0xff, 0xff, 0x03, 0xff, 0xff, 0xff, 0xa8, 0x0b, 
-0x00, 0x00, 0x7c, 0x0b, 0x00, 0x00, 0x00, 0x00, 
-0x20, 0x41, 0x00, 0x00, 0x40, 0xc0, 0x00, 0x00, 
-0xb6, 0x41, 0x00, 0x00, 0x82, 0x41, 0x00, 0x00, 
-0xd0, 0xc0, 0x00, 0x00, 0x18, 0x42, 0x00, 0x00, 
-0x2e, 0xc2, 0x74, 0x65, 0x73, 0x74, 0x00, 0x00, 
-0x00, 0x03, 0xbc, 0x00, 0xbc, 0x00, 0x00, 0xc1, 
-0x00, 0x4c, 0x00, 0x33, 0xe0, 0x05, 0xb0, 0x01, 
-0x20, 0xdf, 0xf6, 0xa0, 0x0b, 0xc3, 0x01, 0x5c, 
-0x00, 0xa9, 0x21, 0xe0, 0x07, 0x4c, 0x03, 0x01, 
-0x13, 0x03, 0xd0, 0x05, 0x4c, 0x03, 0x01, 0x14, 
-0x03, 0x5c, 0x00, 0xb1, 0x0d, 0x20, 0x20, 0x20, 
-0x20, 0x54, 0x65, 0x73, 0x74, 0x20, 0x25, 0x69, 
-0x3a, 0x20, 0x5c, 0x03, 0x70, 0x00, 0x05, 0x5c, 
-0x01, 0x5c, 0x02, 0x1d, 0xe0, 0x1d, 0x5c, 0x01, 
-0x5c, 0x02, 0xb2, 0x15, 0x46, 0x41, 0x49, 0x4c, 
-0x3a, 0x20, 0x65, 0x78, 0x70, 0x20, 0x25, 0x69, 
-0x2c, 0x20, 0x67, 0x6f, 0x74, 0x20, 0x25, 0x69, 
-0x0a, 0xd0, 0x07, 0xb0, 0x05, 0x50, 0x61, 0x73, 
-0x73, 0x0a, 0xa0, 0x0b, 0xc3, 0x01, 0x5c, 0x00, 
-0xa9, 0x21, 0xe0, 0x07, 0x4c, 0x03, 0x01, 0x13, 
-0x03, 0xd0, 0x05, 0x4c, 0x03, 0x01, 0x14, 0x03, 
+0x00, 0x00, 0xd0, 0x0b, 0x00, 0x00, 0x7c, 0x0b, 
+0x00, 0x00, 0x00, 0x00, 0x20, 0x41, 0x00, 0x00, 
+0x40, 0xc0, 0x00, 0x00, 0xb6, 0x41, 0x00, 0x00, 
+0x82, 0x41, 0x00, 0x00, 0xd0, 0xc0, 0x00, 0x00, 
+0x18, 0x42, 0x00, 0x00, 0x2e, 0xc2, 0x74, 0x65, 
+0x73, 0x74, 0x00, 0x00, 0x00, 0x03, 0xbf, 0x00, 
+0xbf, 0x00, 0x00, 0xc1, 0x00, 0x4c, 0x00, 0x33, 
+0xe0, 0x05, 0xb0, 0x01, 0x20, 0xdf, 0xf6, 0xa0, 
+0x0b, 0xc3, 0x02, 0x5c, 0x00, 0xa9, 0x3e, 0x05, 
+0x37, 0x83, 0x13, 0xd0, 0x03, 0x37, 0x83, 0x14, 
 0x5c, 0x00, 0xb1, 0x0d, 0x20, 0x20, 0x20, 0x20, 
 0x54, 0x65, 0x73, 0x74, 0x20, 0x25, 0x69, 0x3a, 
-0x20, 0x5c, 0x03, 0x70, 0x00, 0x05, 0x5c, 0x01, 
-0x5c, 0x02, 0x1e, 0xe0, 0x1d, 0x5c, 0x01, 0x5c, 
-0x02, 0xb2, 0x15, 0x46, 0x41, 0x49, 0x4c, 0x3a, 
-0x20, 0x65, 0x78, 0x70, 0x20, 0x25, 0x66, 0x2c, 
-0x20, 0x67, 0x6f, 0x74, 0x20, 0x25, 0x66, 0x0a, 
-0xd0, 0x07, 0xb0, 0x05, 0x50, 0x61, 0x73, 0x73, 
-0x0a, 0xa0, 0x0b, 0xc0, 0x02, 0x48, 0x00, 0x01, 
-0x2a, 0x03, 0x48, 0x01, 0x50, 0x0e, 0x03, 0xb0, 
-0x22, 0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 0x63, 
-0x6f, 0x6e, 0x73, 0x74, 0x73, 0x2c, 0x20, 0x76, 
-0x61, 0x72, 0x73, 0x2c, 0x20, 0x6f, 0x70, 0x73, 
-0x20, 0x61, 0x6e, 0x64, 0x20, 0x65, 0x78, 0x70, 
-0x72, 0x73, 0x0a, 0xb0, 0x0f, 0x0a, 0x54, 0x65, 
-0x73, 0x74, 0x20, 0x49, 0x6e, 0x74, 0x20, 0x76, 
-0x61, 0x6c, 0x73, 0x0a, 0xa1, 0xac, 0xac, 0x70, 
-0x0e, 0x05, 0xa2, 0x01, 0xfc, 0x50, 0x00, 0x70, 
-0x0e, 0x05, 0xa3, 0xa2, 0x40, 0x02, 0xa1, 0x91, 
-0x02, 0x70, 0x0e, 0x05, 0xa4, 0xa7, 0x40, 0x02, 
-0xa3, 0x91, 0x02, 0x70, 0x0e, 0x05, 0xa5, 0x01, 
-0x2a, 0x58, 0x00, 0x70, 0x0e, 0x05, 0xb0, 0x0e, 
-0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 0x49, 0x6e, 
-0x74, 0x20, 0x6f, 0x70, 0x73, 0x0a, 0xa6, 0x50, 
-0x0f, 0x50, 0x00, 0x58, 0x00, 0x23, 0x70, 0x0e, 
-0x05, 0xa7, 0x01, 0xd2, 0x50, 0x00, 0x58, 0x00, 
-0x25, 0x70, 0x0e, 0x05, 0xa8, 0x50, 0x10, 0x50, 
-0x00, 0x58, 0x00, 0x27, 0x70, 0x0e, 0x05, 0xa9, 
-0xa6, 0x50, 0x00, 0x58, 0x00, 0x29, 0x70, 0x0e, 
-0x05, 0xaa, 0x50, 0x11, 0x58, 0x00, 0x2b, 0x70, 
-0x0e, 0x05, 0xab, 0xa0, 0x50, 0x00, 0x16, 0x70, 
-0x0e, 0x05, 0xac, 0x50, 0x12, 0x50, 0x00, 0x13, 
-0x70, 0x0e, 0x05, 0xad, 0xa0, 0x50, 0x00, 0x58, 
-0x00, 0x17, 0x70, 0x0e, 0x05, 0xae, 0xa0, 0x50, 
-0x00, 0x58, 0x00, 0x19, 0x70, 0x0e, 0x05, 0xaf, 
-0xa0, 0x50, 0x00, 0x58, 0x00, 0x1b, 0x70, 0x0e, 
-0x05, 0x01, 0x10, 0xa1, 0x50, 0x00, 0x58, 0x00, 
-0x1d, 0x70, 0x0e, 0x05, 0x01, 0x11, 0xa1, 0x50, 
-0x00, 0x58, 0x00, 0x1f, 0x70, 0x0e, 0x05, 0x01, 
-0x12, 0xa1, 0x50, 0x00, 0x58, 0x00, 0x21, 0x70, 
-0x0e, 0x05, 0x4c, 0x00, 0x01, 0x14, 0x03, 0x4c, 
-0x01, 0x4c, 0x00, 0x31, 0x03, 0x01, 0x13, 0x01, 
-0x15, 0x5c, 0x00, 0x70, 0x0e, 0x05, 0x01, 0x14, 
-0x01, 0x14, 0x5c, 0x01, 0x70, 0x0e, 0x05, 0x4c, 
-0x01, 0x4c, 0x00, 0x33, 0x03, 0x01, 0x15, 0x01, 
-0x14, 0x5c, 0x00, 0x70, 0x0e, 0x05, 0x01, 0x16, 
-0x01, 0x15, 0x5c, 0x01, 0x70, 0x0e, 0x05, 0x4c, 
-0x01, 0x4c, 0x00, 0x2d, 0x03, 0x01, 0x17, 0x01, 
-0x15, 0x5c, 0x00, 0x70, 0x0e, 0x05, 0x01, 0x18, 
-0x01, 0x15, 0x5c, 0x01, 0x70, 0x0e, 0x05, 0x4c, 
-0x01, 0x4c, 0x00, 0x2f, 0x03, 0x01, 0x19, 0x01, 
-0x14, 0x5c, 0x00, 0x70, 0x0e, 0x05, 0x01, 0x1a, 
-0x01, 0x14, 0x5c, 0x01, 0x70, 0x0e, 0x05, 0xb0, 
-0x10, 0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 0x49, 
-0x6e, 0x74, 0x20, 0x65, 0x78, 0x70, 0x72, 0x73, 
-0x0a, 0x01, 0x1b, 0x50, 0x13, 0x40, 0x02, 0xa1, 
-0x91, 0x02, 0xac, 0x50, 0x00, 0x27, 0x23, 0x58, 
-0x00, 0x25, 0x70, 0x0e, 0x05, 0x01, 0x1c, 0x50, 
-0x14, 0x40, 0x02, 0xa1, 0x91, 0x02, 0xac, 0x23, 
-0x50, 0x00, 0x58, 0x00, 0x25, 0x27, 0x70, 0x0e, 
-0x05, 0xb0, 0x11, 0x0a, 0x54, 0x65, 0x73, 0x74, 
-0x20, 0x46, 0x6c, 0x6f, 0x61, 0x74, 0x20, 0x76, 
-0x61, 0x6c, 0x73, 0x0a, 0x01, 0x1d, 0x50, 0x01, 
-0x50, 0x01, 0x70, 0x65, 0x05, 0x01, 0x1e, 0x50, 
-0x09, 0x40, 0x08, 0xa1, 0x91, 0x02, 0x70, 0x65, 
-0x05, 0x01, 0x1f, 0x50, 0x0b, 0x40, 0x08, 0xa3, 
-0x91, 0x02, 0x70, 0x65, 0x05, 0x01, 0x20, 0x50, 
-0x0e, 0x58, 0x01, 0x70, 0x65, 0x05, 0xb0, 0x10, 
-0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 0x46, 0x6c, 
-0x6f, 0x61, 0x74, 0x20, 0x6f, 0x70, 0x73, 0x0a, 
-0x01, 0x21, 0x50, 0x15, 0x50, 0x01, 0x58, 0x01, 
-0x24, 0x70, 0x65, 0x05, 0x01, 0x22, 0x50, 0x16, 
-0x50, 0x01, 0x58, 0x01, 0x26, 0x70, 0x65, 0x05, 
-0x01, 0x23, 0x50, 0x17, 0x50, 0x01, 0x58, 0x01, 
-0x28, 0x70, 0x65, 0x05, 0x01, 0x24, 0x50, 0x09, 
-0x50, 0x18, 0x58, 0x01, 0x2a, 0x70, 0x65, 0x05, 
-0x01, 0x25, 0x50, 0x19, 0x58, 0x01, 0x2c, 0x70, 
-0x65, 0x05, 0x01, 0x26, 0xa1, 0x50, 0x01, 0x58, 
-0x01, 0x18, 0x70, 0x0e, 0x05, 0x01, 0x27, 0xa1, 
-0x50, 0x01, 0x58, 0x01, 0x1a, 0x70, 0x0e, 0x05, 
-0x01, 0x28, 0xa0, 0x50, 0x01, 0x58, 0x01, 0x1c, 
-0x70, 0x0e, 0x05, 0x01, 0x29, 0xa1, 0x50, 0x01, 
-0x58, 0x01, 0x1e, 0x70, 0x0e, 0x05, 0x01, 0x2a, 
-0xa0, 0x50, 0x01, 0x58, 0x01, 0x20, 0x70, 0x0e, 
-0x05, 0x01, 0x2b, 0xa0, 0x50, 0x01, 0x58, 0x01, 
-0x22, 0x70, 0x0e, 0x05, 0xb0, 0x12, 0x0a, 0x54, 
-0x65, 0x73, 0x74, 0x20, 0x46, 0x6c, 0x6f, 0x61, 
-0x74, 0x20, 0x65, 0x78, 0x70, 0x72, 0x73, 0x0a, 
-0x01, 0x2c, 0x50, 0x1a, 0x40, 0x08, 0xa1, 0x91, 
-0x02, 0xac, 0x0a, 0x02, 0x50, 0x01, 0x28, 0x24, 
-0x58, 0x01, 0x26, 0x70, 0x65, 0x05, 0x01, 0x2d, 
-0x50, 0x1b, 0x40, 0x08, 0xa1, 0x91, 0x02, 0xac, 
-0x0a, 0x02, 0x24, 0x50, 0x01, 0x58, 0x01, 0x26, 
-0x28, 0x70, 0x65, 0x05, 0xb0, 0x07, 0x0a, 0x44, 
-0x6f, 0x6e, 0x65, 0x0a, 0x0a, 0xa0, 0x0b, };
+0x20, 0x5c, 0x03, 0x6c, 0x04, 0x4c, 0x04, 0x33, 
+0xe0, 0x05, 0xb0, 0x01, 0x20, 0xdf, 0xf6, 0x36, 
+0x81, 0x82, 0x3c, 0x1c, 0x36, 0x81, 0x82, 0xb2, 
+0x15, 0x46, 0x41, 0x49, 0x4c, 0x3a, 0x20, 0x65, 
+0x78, 0x70, 0x20, 0x25, 0x69, 0x2c, 0x20, 0x67, 
+0x6f, 0x74, 0x20, 0x25, 0x69, 0x0a, 0xd0, 0x07, 
+0xb0, 0x05, 0x50, 0x61, 0x73, 0x73, 0x0a, 0xa0, 
+0x0b, 0xc3, 0x02, 0x5c, 0x00, 0xa9, 0x3e, 0x05, 
+0x37, 0x83, 0x13, 0xd0, 0x03, 0x37, 0x83, 0x14, 
+0x5c, 0x00, 0xb1, 0x0d, 0x20, 0x20, 0x20, 0x20, 
+0x54, 0x65, 0x73, 0x74, 0x20, 0x25, 0x69, 0x3a, 
+0x20, 0x5c, 0x03, 0x6c, 0x04, 0x4c, 0x04, 0x33, 
+0xe0, 0x05, 0xb0, 0x01, 0x20, 0xdf, 0xf6, 0x36, 
+0x81, 0x82, 0x1e, 0xe0, 0x1c, 0x36, 0x81, 0x82, 
+0xb2, 0x15, 0x46, 0x41, 0x49, 0x4c, 0x3a, 0x20, 
+0x65, 0x78, 0x70, 0x20, 0x25, 0x66, 0x2c, 0x20, 
+0x67, 0x6f, 0x74, 0x20, 0x25, 0x66, 0x0a, 0xd0, 
+0x07, 0xb0, 0x05, 0x50, 0x61, 0x73, 0x73, 0x0a, 
+0xa0, 0x0b, 0xc0, 0x02, 0x37, 0x00, 0x2a, 0x50, 
+0x0c, 0x68, 0x01, 0xb0, 0x22, 0x0a, 0x54, 0x65, 
+0x73, 0x74, 0x20, 0x63, 0x6f, 0x6e, 0x73, 0x74, 
+0x73, 0x2c, 0x20, 0x76, 0x61, 0x72, 0x73, 0x2c, 
+0x20, 0x6f, 0x70, 0x73, 0x20, 0x61, 0x6e, 0x64, 
+0x20, 0x65, 0x78, 0x70, 0x72, 0x73, 0x0a, 0xb0, 
+0x0f, 0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 0x49, 
+0x6e, 0x74, 0x20, 0x76, 0x61, 0x6c, 0x73, 0x0a, 
+0xa1, 0xac, 0xac, 0x70, 0x0e, 0x05, 0xa2, 0x01, 
+0xfc, 0x01, 0xfc, 0x70, 0x0e, 0x05, 0xa3, 0xa2, 
+0x40, 0x00, 0xa1, 0x91, 0x02, 0x70, 0x0e, 0x05, 
+0xa4, 0xa7, 0x40, 0x00, 0xa3, 0x91, 0x02, 0x70, 
+0x0e, 0x05, 0xa5, 0x01, 0x2a, 0x58, 0x00, 0x70, 
+0x0e, 0x05, 0xb0, 0x0e, 0x0a, 0x54, 0x65, 0x73, 
+0x74, 0x20, 0x49, 0x6e, 0x74, 0x20, 0x6f, 0x70, 
+0x73, 0x0a, 0xa6, 0x50, 0x0d, 0x01, 0xfc, 0x58, 
+0x00, 0x23, 0x70, 0x0e, 0x05, 0xa7, 0x01, 0xd2, 
+0x01, 0xfc, 0x58, 0x00, 0x25, 0x70, 0x0e, 0x05, 
+0xa8, 0x50, 0x0e, 0x01, 0xfc, 0x58, 0x00, 0x27, 
+0x70, 0x0e, 0x05, 0xa9, 0xa6, 0x01, 0xfc, 0x58, 
+0x00, 0x29, 0x70, 0x0e, 0x05, 0xaa, 0x50, 0x0f, 
+0x58, 0x00, 0x2b, 0x70, 0x0e, 0x05, 0xab, 0xa0, 
+0xa0, 0x70, 0x0e, 0x05, 0xac, 0x50, 0x10, 0x50, 
+0x10, 0x70, 0x0e, 0x05, 0xad, 0xa0, 0x01, 0xfc, 
+0x58, 0x00, 0x17, 0x70, 0x0e, 0x05, 0xae, 0xa0, 
+0x01, 0xfc, 0x58, 0x00, 0x19, 0x70, 0x0e, 0x05, 
+0xaf, 0xa0, 0x01, 0xfc, 0x58, 0x00, 0x1b, 0x70, 
+0x0e, 0x05, 0x01, 0x10, 0xa1, 0x01, 0xfc, 0x58, 
+0x00, 0x1d, 0x70, 0x0e, 0x05, 0x01, 0x11, 0xa1, 
+0x01, 0xfc, 0x58, 0x00, 0x1f, 0x70, 0x0e, 0x05, 
+0x01, 0x12, 0xa1, 0x01, 0xfc, 0x58, 0x00, 0x21, 
+0x70, 0x0e, 0x05, 0x37, 0x80, 0x14, 0x4c, 0x00, 
+0x31, 0x6c, 0x01, 0x01, 0x13, 0x01, 0x15, 0x5c, 
+0x00, 0x70, 0x0e, 0x05, 0x01, 0x14, 0x01, 0x14, 
+0x5c, 0x01, 0x70, 0x0e, 0x05, 0x4c, 0x00, 0x33, 
+0x6c, 0x01, 0x01, 0x15, 0x01, 0x14, 0x5c, 0x00, 
+0x70, 0x0e, 0x05, 0x01, 0x16, 0x01, 0x15, 0x5c, 
+0x01, 0x70, 0x0e, 0x05, 0x4c, 0x00, 0x2d, 0x6c, 
+0x01, 0x01, 0x17, 0x01, 0x15, 0x5c, 0x00, 0x70, 
+0x0e, 0x05, 0x01, 0x18, 0x01, 0x15, 0x5c, 0x01, 
+0x70, 0x0e, 0x05, 0x4c, 0x00, 0x2f, 0x6c, 0x01, 
+0x01, 0x19, 0x01, 0x14, 0x5c, 0x00, 0x70, 0x0e, 
+0x05, 0x01, 0x1a, 0x01, 0x14, 0x5c, 0x01, 0x70, 
+0x0e, 0x05, 0xb0, 0x10, 0x0a, 0x54, 0x65, 0x73, 
+0x74, 0x20, 0x49, 0x6e, 0x74, 0x20, 0x65, 0x78, 
+0x70, 0x72, 0x73, 0x0a, 0x01, 0x1b, 0x50, 0x11, 
+0x40, 0x00, 0xa1, 0x91, 0x02, 0x50, 0x12, 0x23, 
+0x58, 0x00, 0x25, 0x70, 0x0e, 0x05, 0x01, 0x1c, 
+0x50, 0x13, 0x40, 0x00, 0xa1, 0x91, 0x02, 0x35, 
+0x0c, 0x01, 0xfc, 0x58, 0x00, 0x25, 0x27, 0x70, 
+0x0e, 0x05, 0xb0, 0x11, 0x0a, 0x54, 0x65, 0x73, 
+0x74, 0x20, 0x46, 0x6c, 0x6f, 0x61, 0x74, 0x20, 
+0x76, 0x61, 0x6c, 0x73, 0x0a, 0x01, 0x1d, 0x50, 
+0x08, 0x50, 0x08, 0x70, 0x66, 0x05, 0x01, 0x1e, 
+0x50, 0x07, 0x40, 0x06, 0xa1, 0x91, 0x02, 0x70, 
+0x66, 0x05, 0x01, 0x1f, 0x50, 0x09, 0x40, 0x06, 
+0xa3, 0x91, 0x02, 0x70, 0x66, 0x05, 0x01, 0x20, 
+0x50, 0x0c, 0x58, 0x01, 0x70, 0x66, 0x05, 0xb0, 
+0x10, 0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 0x46, 
+0x6c, 0x6f, 0x61, 0x74, 0x20, 0x6f, 0x70, 0x73, 
+0x0a, 0x01, 0x21, 0x50, 0x14, 0x50, 0x08, 0x58, 
+0x01, 0x24, 0x70, 0x66, 0x05, 0x01, 0x22, 0x50, 
+0x15, 0x50, 0x08, 0x58, 0x01, 0x26, 0x70, 0x66, 
+0x05, 0x01, 0x23, 0x50, 0x16, 0x50, 0x08, 0x58, 
+0x01, 0x28, 0x70, 0x66, 0x05, 0x01, 0x24, 0x50, 
+0x07, 0x50, 0x17, 0x58, 0x01, 0x2a, 0x70, 0x66, 
+0x05, 0x01, 0x25, 0x50, 0x18, 0x58, 0x01, 0x2c, 
+0x70, 0x66, 0x05, 0x01, 0x26, 0xa1, 0x50, 0x08, 
+0x58, 0x01, 0x18, 0x70, 0x0e, 0x05, 0x01, 0x27, 
+0xa1, 0x50, 0x08, 0x58, 0x01, 0x1a, 0x70, 0x0e, 
+0x05, 0x01, 0x28, 0xa0, 0x50, 0x08, 0x58, 0x01, 
+0x1c, 0x70, 0x0e, 0x05, 0x01, 0x29, 0xa1, 0x50, 
+0x08, 0x58, 0x01, 0x1e, 0x70, 0x0e, 0x05, 0x01, 
+0x2a, 0xa0, 0x50, 0x08, 0x58, 0x01, 0x20, 0x70, 
+0x0e, 0x05, 0x01, 0x2b, 0xa0, 0x50, 0x08, 0x58, 
+0x01, 0x22, 0x70, 0x0e, 0x05, 0xb0, 0x12, 0x0a, 
+0x54, 0x65, 0x73, 0x74, 0x20, 0x46, 0x6c, 0x6f, 
+0x61, 0x74, 0x20, 0x65, 0x78, 0x70, 0x72, 0x73, 
+0x0a, 0x01, 0x2c, 0x50, 0x19, 0x40, 0x06, 0xa1, 
+0x91, 0x02, 0xac, 0x0a, 0x02, 0x50, 0x08, 0x28, 
+0x24, 0x58, 0x01, 0x26, 0x70, 0x66, 0x05, 0x01, 
+0x2d, 0x50, 0x1a, 0x40, 0x06, 0xa1, 0x91, 0x02, 
+0xac, 0x0a, 0x02, 0x24, 0x50, 0x08, 0x58, 0x01, 
+0x26, 0x28, 0x70, 0x66, 0x05, 0xb0, 0x07, 0x0a, 
+0x44, 0x6f, 0x6e, 0x65, 0x0a, 0x0a, 0xa0, 0x0b, 
+};
@@ -1,50 +1,106 @@
 static const uint8_t PROGMEM EEPROM_Upload_TestFunction[ ] = {
-0x61, 0x72, 0x6c, 0x79, 0x08, 0x00, 0x02, 0x00, 
-0x41, 0x00, 0x00, 0x00, 0x60, 0x40, 0x00, 0x00, 
-0xf6, 0x42, 0x00, 0x00, 0x40, 0x41, 0x00, 0x00, 
+0x61, 0x72, 0x6c, 0x79, 0x0a, 0x00, 0x07, 0x00, 
+0x15, 0x00, 0x00, 0x00, 0xf6, 0x42, 0x00, 0x00, 
+0x40, 0x41, 0x00, 0x00, 0x60, 0x40, 0x00, 0x00, 
 0xd0, 0x40, 0x00, 0x80, 0x43, 0x43, 0x00, 0x00, 
 0xa0, 0x41, 0x00, 0x00, 0xf4, 0x41, 0x00, 0x00, 
-0x72, 0x42, 0x74, 0x65, 0x73, 0x74, 0x00, 0x00, 
-0x00, 0x03, 0xff, 0x00, 0xff, 0x00, 0x00, 0xc1, 
+0x72, 0x42, 0xfd, 0xff, 0xff, 0xff, 0x00, 0x00, 
+0xe0, 0x3f, 0x74, 0x65, 0x73, 0x74, 0x00, 0x00, 
+0x00, 0x03, 0x6c, 0x01, 0x6c, 0x01, 0x00, 0xc1, 
 0x00, 0x4c, 0x00, 0x33, 0xe0, 0x05, 0xb0, 0x01, 
-0x20, 0xdf, 0xf6, 0xa0, 0x0b, 0xc3, 0x01, 0x5c, 
-0x00, 0xa9, 0x21, 0xe0, 0x07, 0x4c, 0x03, 0x01, 
-0x13, 0x03, 0xd0, 0x05, 0x4c, 0x03, 0x01, 0x14, 
-0x03, 0x5c, 0x00, 0xb1, 0x0d, 0x20, 0x20, 0x20, 
-0x20, 0x54, 0x65, 0x73, 0x74, 0x20, 0x25, 0x69, 
-0x3a, 0x20, 0x5c, 0x03, 0x70, 0x00, 0x05, 0x5c, 
-0x01, 0x5c, 0x02, 0x1d, 0xe0, 0x1d, 0x5c, 0x01, 
-0x5c, 0x02, 0xb2, 0x15, 0x46, 0x41, 0x49, 0x4c, 
-0x3a, 0x20, 0x65, 0x78, 0x70, 0x20, 0x25, 0x69, 
-0x2c, 0x20, 0x67, 0x6f, 0x74, 0x20, 0x25, 0x69, 
-0x0a, 0xd0, 0x07, 0xb0, 0x05, 0x50, 0x61, 0x73, 
-0x73, 0x0a, 0xa0, 0x0b, 0xc3, 0x01, 0x5c, 0x00, 
-0xa9, 0x21, 0xe0, 0x07, 0x4c, 0x03, 0x01, 0x13, 
-0x03, 0xd0, 0x05, 0x4c, 0x03, 0x01, 0x14, 0x03, 
-0x5c, 0x00, 0xb1, 0x0d, 0x20, 0x20, 0x20, 0x20, 
-0x54, 0x65, 0x73, 0x74, 0x20, 0x25, 0x69, 0x3a, 
-0x20, 0x5c, 0x03, 0x70, 0x00, 0x05, 0x5c, 0x01, 
-0x5c, 0x02, 0x1e, 0xe0, 0x1d, 0x5c, 0x01, 0x5c, 
-0x02, 0xb2, 0x15, 0x46, 0x41, 0x49, 0x4c, 0x3a, 
-0x20, 0x65, 0x78, 0x70, 0x20, 0x25, 0x66, 0x2c, 
-0x20, 0x67, 0x6f, 0x74, 0x20, 0x25, 0x66, 0x0a, 
-0xd0, 0x07, 0xb0, 0x05, 0x50, 0x61, 0x73, 0x73, 
-0x0a, 0xa0, 0x0b, 0xc0, 0x00, 0xa1, 0xa0, 0xa0, 
-0x70, 0x0e, 0x05, 0xa0, 0x0b, 0xc2, 0x01, 0x4c, 
-0x02, 0xa7, 0x03, 0x5c, 0x00, 0x5c, 0x01, 0x23, 
-0x5c, 0x02, 0x23, 0xac, 0x23, 0xaa, 0x23, 0x58, 
-0x00, 0x23, 0x0b, 0xc2, 0x01, 0x4c, 0x02, 0x50, 
-0x01, 0x03, 0x5c, 0x00, 0x5c, 0x01, 0x24, 0x5c, 
-0x02, 0x24, 0x50, 0x02, 0x24, 0x50, 0x00, 0x24, 
-0x58, 0x01, 0x24, 0x0b, 0xc2, 0x00, 0x5c, 0x00, 
-0x5c, 0x01, 0x0a, 0x03, 0x23, 0x0b, 0xc0, 0x00, 
-0xb0, 0x10, 0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 
-0x66, 0x75, 0x6e, 0x63, 0x74, 0x69, 0x6f, 0x6e, 
-0x73, 0x0a, 0x48, 0x00, 0x01, 0x2a, 0x03, 0x48, 
-0x01, 0x50, 0x03, 0x03, 0x70, 0xbc, 0x05, 0xa2, 
-0x01, 0x52, 0xa5, 0xa6, 0x70, 0xc6, 0x70, 0x0e, 
-0x05, 0xa3, 0x50, 0x04, 0x50, 0x05, 0x50, 0x06, 
-0x70, 0xdc, 0x70, 0x65, 0x05, 0xa4, 0x01, 0x6e, 
-0x01, 0x32, 0x50, 0x07, 0x70, 0xf5, 0x70, 0x0e, 
-0x05, 0xb0, 0x07, 0x0a, 0x44, 0x6f, 0x6e, 0x65, 
-0x0a, 0x0a, 0xa0, 0x0b, };
+0x20, 0xdf, 0xf6, 0xa0, 0x0b, 0xc3, 0x02, 0x5c, 
+0x00, 0xa9, 0x3e, 0x05, 0x37, 0x83, 0x13, 0xd0, 
+0x03, 0x37, 0x83, 0x14, 0x5c, 0x00, 0xb1, 0x0d, 
+0x20, 0x20, 0x20, 0x20, 0x54, 0x65, 0x73, 0x74, 
+0x20, 0x25, 0x69, 0x3a, 0x20, 0x5c, 0x03, 0x6c, 
+0x04, 0x4c, 0x04, 0x33, 0xe0, 0x05, 0xb0, 0x01, 
+0x20, 0xdf, 0xf6, 0x36, 0x81, 0x82, 0x3c, 0x1c, 
+0x36, 0x81, 0x82, 0xb2, 0x15, 0x46, 0x41, 0x49, 
+0x4c, 0x3a, 0x20, 0x65, 0x78, 0x70, 0x20, 0x25, 
+0x69, 0x2c, 0x20, 0x67, 0x6f, 0x74, 0x20, 0x25, 
+0x69, 0x0a, 0xd0, 0x07, 0xb0, 0x05, 0x50, 0x61, 
+0x73, 0x73, 0x0a, 0xa0, 0x0b, 0xc3, 0x02, 0x5c, 
+0x00, 0xa9, 0x3e, 0x05, 0x37, 0x83, 0x13, 0xd0, 
+0x03, 0x37, 0x83, 0x14, 0x5c, 0x00, 0xb1, 0x0d, 
+0x20, 0x20, 0x20, 0x20, 0x54, 0x65, 0x73, 0x74, 
+0x20, 0x25, 0x69, 0x3a, 0x20, 0x5c, 0x03, 0x6c, 
+0x04, 0x4c, 0x04, 0x33, 0xe0, 0x05, 0xb0, 0x01, 
+0x20, 0xdf, 0xf6, 0x36, 0x81, 0x82, 0x1e, 0xe0, 
+0x1c, 0x36, 0x81, 0x82, 0xb2, 0x15, 0x46, 0x41, 
+0x49, 0x4c, 0x3a, 0x20, 0x65, 0x78, 0x70, 0x20, 
+0x25, 0x66, 0x2c, 0x20, 0x67, 0x6f, 0x74, 0x20, 
+0x25, 0x66, 0x0a, 0xd0, 0x07, 0xb0, 0x05, 0x50, 
+0x61, 0x73, 0x73, 0x0a, 0xa0, 0x0b, 0xc0, 0x00, 
+0xa1, 0xa0, 0xa0, 0x70, 0x0e, 0x05, 0xa0, 0x0b, 
+0xc2, 0x01, 0x37, 0x82, 0x07, 0x36, 0x80, 0x81, 
+0x23, 0x5c, 0x02, 0x23, 0x35, 0x0c, 0x35, 0x0a, 
+0x58, 0x00, 0x23, 0x0b, 0xc2, 0x01, 0x50, 0x00, 
+0x6c, 0x02, 0x36, 0x80, 0x81, 0x24, 0x5c, 0x02, 
+0x24, 0x50, 0x01, 0x24, 0x50, 0x02, 0x24, 0x58, 
+0x01, 0x24, 0x0b, 0xc2, 0x00, 0x36, 0x80, 0x81, 
+0x0a, 0x03, 0x23, 0x0b, 0xc3, 0x00, 0x36, 0x80, 
+0x81, 0x39, 0x03, 0x5c, 0x01, 0x0b, 0x36, 0x80, 
+0x82, 0x3e, 0x03, 0x5c, 0x02, 0x0b, 0x5c, 0x00, 
+0x0b, 0xc2, 0x01, 0x5c, 0x00, 0x6c, 0x02, 0x36, 
+0x82, 0x81, 0x3d, 0x08, 0x36, 0x82, 0x81, 0x25, 
+0x6c, 0x02, 0xdf, 0xf3, 0x5c, 0x02, 0x0b, 0xc1, 
+0x03, 0x5c, 0x00, 0x37, 0x82, 0x0a, 0x6c, 0x01, 
+0x5c, 0x01, 0x6c, 0x03, 0x36, 0x83, 0x82, 0x3d, 
+0x08, 0x36, 0x83, 0x82, 0x25, 0x6c, 0x03, 0xdf, 
+0xf3, 0x5c, 0x03, 0xa2, 0x37, 0x83, 0x07, 0x6c, 
+0x02, 0x6c, 0x01, 0x36, 0x81, 0x82, 0x39, 0x04, 
+0x5c, 0x02, 0xd0, 0x0b, 0x36, 0x81, 0x83, 0x3e, 
+0x04, 0x5c, 0x03, 0xd0, 0x02, 0x5c, 0x01, 0x0b, 
+0xc0, 0x00, 0xa1, 0x38, 0x02, 0xa5, 0x0b, 0xc0, 
+0x00, 0xa5, 0x0b, 0xc0, 0x08, 0xb0, 0x10, 0x0a, 
+0x54, 0x65, 0x73, 0x74, 0x20, 0x66, 0x75, 0x6e, 
+0x63, 0x74, 0x69, 0x6f, 0x6e, 0x73, 0x0a, 0x37, 
+0x00, 0x2a, 0x50, 0x03, 0x68, 0x01, 0x70, 0xbf, 
+0x05, 0xa2, 0x01, 0x52, 0xa5, 0x37, 0x81, 0x06, 
+0x6c, 0x00, 0x37, 0x82, 0x07, 0x36, 0x80, 0x81, 
+0x23, 0x5c, 0x02, 0x23, 0x35, 0x0c, 0x35, 0x0a, 
+0x58, 0x00, 0x23, 0x70, 0x0e, 0x05, 0xa3, 0x50, 
+0x04, 0x50, 0x05, 0x50, 0x06, 0x6c, 0x01, 0x6c, 
+0x00, 0x50, 0x00, 0x6c, 0x02, 0x36, 0x80, 0x81, 
+0x24, 0x5c, 0x02, 0x24, 0x50, 0x01, 0x24, 0x50, 
+0x02, 0x24, 0x58, 0x01, 0x24, 0x70, 0x66, 0x05, 
+0xa4, 0x01, 0x6e, 0x01, 0x32, 0x50, 0x07, 0x70, 
+0xf4, 0x70, 0x0e, 0x05, 0xa5, 0xa0, 0x50, 0x08, 
+0xa0, 0xaa, 0x70, 0xfd, 0x70, 0x0e, 0x05, 0xa6, 
+0xaa, 0xaf, 0xa0, 0xaa, 0x70, 0xfd, 0x70, 0x0e, 
+0x05, 0x37, 0x80, 0x00, 0x37, 0x81, 0x00, 0x5c, 
+0x01, 0x01, 0x14, 0x39, 0x0d, 0x4c, 0x00, 0x36, 
+0x80, 0x81, 0x71, 0x28, 0x23, 0x03, 0x09, 0x81, 
+0x14, 0x0d, 0xa7, 0x01, 0x5a, 0x5c, 0x00, 0x70, 
+0x0e, 0x05, 0xb0, 0x14, 0x0a, 0x54, 0x65, 0x73, 
+0x74, 0x20, 0x6d, 0x75, 0x6c, 0x74, 0x69, 0x70, 
+0x6c, 0x79, 0x20, 0x62, 0x79, 0x20, 0x30, 0x0a, 
+0x37, 0x82, 0x02, 0x37, 0x83, 0x03, 0x37, 0x84, 
+0x09, 0x48, 0x03, 0xa2, 0x91, 0xa7, 0x03, 0x37, 
+0x84, 0x00, 0xa8, 0xa0, 0x5c, 0x04, 0x70, 0x0e, 
+0x05, 0x4c, 0x03, 0x31, 0xa0, 0x27, 0x6c, 0x05, 
+0xa9, 0xa0, 0x5c, 0x05, 0x70, 0x0e, 0x05, 0xaa, 
+0xa4, 0x5c, 0x03, 0x70, 0x0e, 0x05, 0xa1, 0x38, 
+0x02, 0xa5, 0xa0, 0x27, 0x6c, 0x06, 0xab, 0xa0, 
+0x5c, 0x06, 0x70, 0x0e, 0x05, 0xac, 0xa1, 0x58, 
+0x02, 0x70, 0x0e, 0x05, 0xb0, 0x29, 0x0a, 0x54, 
+0x65, 0x73, 0x74, 0x20, 0x2b, 0x3d, 0x20, 0x6f, 
+0x66, 0x20, 0x61, 0x6e, 0x20, 0x65, 0x78, 0x70, 
+0x72, 0x20, 0x74, 0x68, 0x61, 0x74, 0x20, 0x63, 
+0x68, 0x61, 0x6e, 0x67, 0x65, 0x73, 0x20, 0x74, 
+0x68, 0x65, 0x20, 0x76, 0x61, 0x72, 0x0a, 0x37, 
+0x87, 0x03, 0x4c, 0x07, 0x04, 0x02, 0x4c, 0x07, 
+0x2d, 0x23, 0x03, 0xad, 0xa7, 0x5c, 0x07, 0x70, 
+0x0e, 0x05, 0x37, 0x87, 0x03, 0x4c, 0x07, 0x04, 
+0x02, 0x4c, 0x07, 0x31, 0x23, 0x03, 0xae, 0xa6, 
+0x5c, 0x07, 0x70, 0x0e, 0x05, 0x37, 0x00, 0x03, 
+0x48, 0x00, 0x04, 0x02, 0x48, 0x00, 0x2d, 0x23, 
+0x03, 0xaf, 0xa7, 0x58, 0x00, 0x70, 0x0e, 0x05, 
+0xb0, 0x17, 0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 
+0x63, 0x6f, 0x6e, 0x73, 0x74, 0x61, 0x6e, 0x74, 
+0x20, 0x66, 0x6f, 0x6c, 0x64, 0x69, 0x6e, 0x67, 
+0x0a, 0x01, 0x10, 0x01, 0x78, 0x01, 0x78, 0x70, 
+0x0e, 0x05, 0x01, 0x11, 0x50, 0x09, 0x50, 0x09, 
+0x70, 0x66, 0x05, 0x01, 0x12, 0xa5, 0xa5, 0x70, 
+0x0e, 0x05, 0xb0, 0x07, 0x0a, 0x44, 0x6f, 0x6e, 
+0x65, 0x0a, 0x0a, 0xa0, 0x0b, };
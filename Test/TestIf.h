@@ -1,75 +1,55 @@
 static const uint8_t PROGMEM EEPROM_Upload_TestIf[ ] = {
 0x61, 0x72, 0x6c, 0x79, 0x00, 0x00, 0x00, 0x00, 
-0x42, 0x00, 0x74, 0x65, 0x73, 0x74, 0x00, 0x00, 
-0x00, 0x03, 0x65, 0x00, 0x65, 0x00, 0x00, 0xc1, 
+0x0d, 0x00, 0x74, 0x65, 0x73, 0x74, 0x00, 0x00, 
+0x00, 0x03, 0x66, 0x00, 0x66, 0x00, 0x00, 0xc1, 
 0x00, 0x4c, 0x00, 0x33, 0xe0, 0x05, 0xb0, 0x01, 
-0x20, 0xdf, 0xf6, 0xa0, 0x0b, 0xc3, 0x01, 0x5c, 
-0x00, 0xa9, 0x21, 0xe0, 0x07, 0x4c, 0x03, 0x01, 
-0x13, 0x03, 0xd0, 0x05, 0x4c, 0x03, 0x01, 0x14, 
-0x03, 0x5c, 0x00, 0xb1, 0x0d, 0x20, 0x20, 0x20, 
-0x20, 0x54, 0x65, 0x73, 0x74, 0x20, 0x25, 0x69, 
-0x3a, 0x20, 0x5c, 0x03, 0x70, 0x00, 0x05, 0x5c, 
-0x01, 0x5c, 0x02, 0x1d, 0xe0, 0x1d, 0x5c, 0x01, 
-0x5c, 0x02, 0xb2, 0x15, 0x46, 0x41, 0x49, 0x4c, 
-0x3a, 0x20, 0x65, 0x78, 0x70, 0x20, 0x25, 0x69, 
-0x2c, 0x20, 0x67, 0x6f, 0x74, 0x20, 0x25, 0x69, 
-0x0a, 0xd0, 0x07, 0xb0, 0x05, 0x50, 0x61, 0x73, 
-0x73, 0x0a, 0xa0, 0x0b, 0xc0, 0x02, 0xb0, 0x09, 
-0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 0x69, 0x66, 
-0x0a, 0x4c, 0x00, 0xa0, 0x03, 0x4c, 0x01, 0xa0, 
-0x03, 0xa0, 0xe0, 0x08, 0xa1, 0xa0, 0xa1, 0x70, 
-0x0e, 0x05, 0xd0, 0x06, 0xa1, 0xa1, 0xa1, 0x70, 
-0x0e, 0x05, 0xa1, 0xe0, 0x08, 0xa2, 0xa1, 0xa1, 
-0x70, 0x0e, 0x05, 0xd0, 0x06, 0xa2, 0xa0, 0xa1, 
-0x70, 0x0e, 0x05, 0xb0, 0x18, 0x0a, 0x54, 0x65, 
-0x73, 0x74, 0x20, 0x6c, 0x6f, 0x67, 0x69, 0x63, 
-0x61, 0x6c, 0x20, 0x6f, 0x70, 0x65, 0x72, 0x61, 
-0x74, 0x6f, 0x72, 0x73, 0x0a, 0xae, 0xa5, 0x17, 
-0xe0, 0x08, 0xa3, 0xa0, 0xa1, 0x70, 0x0e, 0x05, 
-0xd0, 0x06, 0xa3, 0xa1, 0xa1, 0x70, 0x0e, 0x05, 
-0xae, 0xa5, 0x19, 0xe0, 0x08, 0xa4, 0xa0, 0xa1, 
-0x70, 0x0e, 0x05, 0xd0, 0x06, 0xa4, 0xa1, 0xa1, 
-0x70, 0x0e, 0x05, 0xae, 0xa5, 0x1b, 0xe0, 0x08, 
-0xa5, 0xa0, 0xa1, 0x70, 0x0e, 0x05, 0xd0, 0x06, 
-0xa5, 0xa1, 0xa1, 0x70, 0x0e, 0x05, 0xae, 0xa5, 
-0x1d, 0xe0, 0x08, 0xa6, 0xa1, 0xa1, 0x70, 0x0e, 
-0x05, 0xd0, 0x06, 0xa6, 0xa0, 0xa1, 0x70, 0x0e, 
-0x05, 0xae, 0xa5, 0x1f, 0xe0, 0x08, 0xa7, 0xa1, 
-0xa1, 0x70, 0x0e, 0x05, 0xd0, 0x06, 0xa7, 0xa0, 
-0xa1, 0x70, 0x0e, 0x05, 0xae, 0xa5, 0x21, 0xe0, 
-0x08, 0xa8, 0xa1, 0xa1, 0x70, 0x0e, 0x05, 0xd0, 
-0x06, 0xa8, 0xa0, 0xa1, 0x70, 0x0e, 0x05, 0xb0, 
-0x19, 0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 0x6c, 
-0x6f, 0x67, 0x69, 0x63, 0x61, 0x6c, 0x20, 0x6f, 
-0x72, 0x2f, 0x61, 0x6e, 0x64, 0x2f, 0x6e, 0x6f, 
-0x74, 0x0a, 0xa1, 0xa2, 0x21, 0xa2, 0xa3, 0x21, 
-0x14, 0xe0, 0x08, 0xa9, 0xa0, 0xa1, 0x70, 0x0e, 
-0x05, 0xd0, 0x06, 0xa9, 0xa1, 0xa1, 0x70, 0x0e, 
-0x05, 0xa1, 0xa2, 0x21, 0xa2, 0xa3, 0x17, 0x14, 
-0xe0, 0x08, 0xaa, 0xa1, 0xa1, 0x70, 0x0e, 0x05, 
-0xd0, 0x06, 0xaa, 0xa0, 0xa1, 0x70, 0x0e, 0x05, 
-0xa1, 0xa2, 0x17, 0xa2, 0xa3, 0x21, 0x14, 0xe0, 
-0x08, 0xab, 0xa1, 0xa1, 0x70, 0x0e, 0x05, 0xd0, 
-0x06, 0xab, 0xa0, 0xa1, 0x70, 0x0e, 0x05, 0xa1, 
-0xa2, 0x17, 0xa2, 0xa3, 0x17, 0x14, 0xe0, 0x08, 
-0xac, 0xa1, 0xa1, 0x70, 0x0e, 0x05, 0xd0, 0x06, 
-0xac, 0xa0, 0xa1, 0x70, 0x0e, 0x05, 0xa1, 0xa2, 
-0x21, 0xa2, 0xa3, 0x21, 0x15, 0xe0, 0x08, 0xad, 
-0xa0, 0xa1, 0x70, 0x0e, 0x05, 0xd0, 0x06, 0xad, 
-0xa1, 0xa1, 0x70, 0x0e, 0x05, 0xa1, 0xa2, 0x21, 
-0xa2, 0xa3, 0x17, 0x15, 0xe0, 0x08, 0xae, 0xa0, 
-0xa1, 0x70, 0x0e, 0x05, 0xd0, 0x06, 0xae, 0xa1, 
-0xa1, 0x70, 0x0e, 0x05, 0xa1, 0xa2, 0x17, 0xa2, 
-0xa3, 0x21, 0x15, 0xe0, 0x08, 0xaf, 0xa0, 0xa1, 
-0x70, 0x0e, 0x05, 0xd0, 0x06, 0xaf, 0xa1, 0xa1, 
-0x70, 0x0e, 0x05, 0xa1, 0xa2, 0x17, 0xa2, 0xa3, 
-0x17, 0x15, 0xe0, 0x09, 0x01, 0x10, 0xa1, 0xa1, 
-0x70, 0x0e, 0x05, 0xd0, 0x07, 0x01, 0x10, 0xa0, 
-0xa1, 0x70, 0x0e, 0x05, 0xa1, 0xa2, 0x17, 0x16, 
-0xe0, 0x09, 0x01, 0x11, 0xa0, 0xa1, 0x70, 0x0e, 
-0x05, 0xd0, 0x07, 0x01, 0x11, 0xa1, 0xa1, 0x70, 
-0x0e, 0x05, 0xa1, 0xa2, 0x21, 0x16, 0xe0, 0x09, 
-0x01, 0x12, 0xa1, 0xa1, 0x70, 0x0e, 0x05, 0xd0, 
-0x07, 0x01, 0x12, 0xa0, 0xa1, 0x70, 0x0e, 0x05, 
-0xb0, 0x07, 0x0a, 0x44, 0x6f, 0x6e, 0x65, 0x0a, 
-0x0a, 0xa0, 0x0b, };
+0x20, 0xdf, 0xf6, 0xa0, 0x0b, 0xc3, 0x02, 0x5c, 
+0x00, 0xa9, 0x3e, 0x05, 0x37, 0x83, 0x13, 0xd0, 
+0x03, 0x37, 0x83, 0x14, 0x5c, 0x00, 0xb1, 0x0d, 
+0x20, 0x20, 0x20, 0x20, 0x54, 0x65, 0x73, 0x74, 
+0x20, 0x25, 0x69, 0x3a, 0x20, 0x5c, 0x03, 0x6c, 
+0x04, 0x4c, 0x04, 0x33, 0xe0, 0x05, 0xb0, 0x01, 
+0x20, 0xdf, 0xf6, 0x36, 0x81, 0x82, 0x3c, 0x1c, 
+0x36, 0x81, 0x82, 0xb2, 0x15, 0x46, 0x41, 0x49, 
+0x4c, 0x3a, 0x20, 0x65, 0x78, 0x70, 0x20, 0x25, 
+0x69, 0x2c, 0x20, 0x67, 0x6f, 0x74, 0x20, 0x25, 
+0x69, 0x0a, 0xd0, 0x07, 0xb0, 0x05, 0x50, 0x61, 
+0x73, 0x73, 0x0a, 0xa0, 0x0b, 0xc0, 0x02, 0xb0, 
+0x09, 0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 0x69, 
+0x66, 0x0a, 0x37, 0x80, 0x00, 0x37, 0x81, 0x00, 
+0xa1, 0xa1, 0xa1, 0x70, 0x0e, 0x05, 0xa2, 0xa1, 
+0xa1, 0x70, 0x0e, 0x05, 0xb0, 0x18, 0x0a, 0x54, 
+0x65, 0x73, 0x74, 0x20, 0x6c, 0x6f, 0x67, 0x69, 
+0x63, 0x61, 0x6c, 0x20, 0x6f, 0x70, 0x65, 0x72, 
+0x61, 0x74, 0x6f, 0x72, 0x73, 0x0a, 0xa3, 0xa1, 
+0xa1, 0x70, 0x0e, 0x05, 0xa4, 0xa1, 0xa1, 0x70, 
+0x0e, 0x05, 0xa5, 0xa1, 0xa1, 0x70, 0x0e, 0x05, 
+0xa6, 0xa1, 0xa1, 0x70, 0x0e, 0x05, 0xa7, 0xa1, 
+0xa1, 0x70, 0x0e, 0x05, 0xa8, 0xa1, 0xa1, 0x70, 
+0x0e, 0x05, 0xb0, 0x19, 0x0a, 0x54, 0x65, 0x73, 
+0x74, 0x20, 0x6c, 0x6f, 0x67, 0x69, 0x63, 0x61, 
+0x6c, 0x20, 0x6f, 0x72, 0x2f, 0x61, 0x6e, 0x64, 
+0x2f, 0x6e, 0x6f, 0x74, 0x0a, 0xa9, 0xa1, 0xa1, 
+0x70, 0x0e, 0x05, 0xaa, 0xa1, 0xa1, 0x70, 0x0e, 
+0x05, 0xab, 0xa1, 0xa1, 0x70, 0x0e, 0x05, 0xac, 
+0xa1, 0xa1, 0x70, 0x0e, 0x05, 0xad, 0xa1, 0xa1, 
+0x70, 0x0e, 0x05, 0xae, 0xa1, 0xa1, 0x70, 0x0e, 
+0x05, 0xaf, 0xa1, 0xa1, 0x70, 0x0e, 0x05, 0x01, 
+0x10, 0xa1, 0xa1, 0x70, 0x0e, 0x05, 0x01, 0x11, 
+0xa1, 0xa1, 0x70, 0x0e, 0x05, 0x01, 0x12, 0xa1, 
+0xa1, 0x70, 0x0e, 0x05, 0xb0, 0x19, 0x0a, 0x54, 
+0x65, 0x73, 0x74, 0x20, 0x6e, 0x6f, 0x6e, 0x2d, 
+0x63, 0x6f, 0x6e, 0x73, 0x74, 0x61, 0x6e, 0x74, 
+0x20, 0x74, 0x65, 0x73, 0x74, 0x73, 0x0a, 0x37, 
+0x80, 0x01, 0x37, 0x81, 0x02, 0x36, 0x80, 0x81, 
+0x21, 0x5c, 0x01, 0xa3, 0x17, 0x14, 0xe0, 0x09, 
+0x01, 0x13, 0xa1, 0xa1, 0x70, 0x0e, 0x05, 0xd0, 
+0x07, 0x01, 0x13, 0xa0, 0xa1, 0x70, 0x0e, 0x05, 
+0x36, 0x80, 0x81, 0x17, 0x5c, 0x01, 0xa3, 0x21, 
+0x15, 0xe0, 0x09, 0x01, 0x14, 0xa0, 0xa1, 0x70, 
+0x0e, 0x05, 0xd0, 0x07, 0x01, 0x14, 0xa1, 0xa1, 
+0x70, 0x0e, 0x05, 0x36, 0x80, 0x81, 0x17, 0x16, 
+0xe0, 0x09, 0x01, 0x15, 0xa0, 0xa1, 0x70, 0x0e, 
+0x05, 0xd0, 0x07, 0x01, 0x15, 0xa1, 0xa1, 0x70, 
+0x0e, 0x05, 0xb0, 0x07, 0x0a, 0x44, 0x6f, 0x6e, 
+0x65, 0x0a, 0x0a, 0xa0, 0x0b, };
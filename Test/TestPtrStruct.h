@@ -1,66 +1,67 @@
 static const uint8_t PROGMEM EEPROM_Upload_TestPtrStruct[ ] = {
 0x61, 0x72, 0x6c, 0x79, 0x02, 0x00, 0x00, 0x00, 
-0x4a, 0x00, 0x00, 0x00, 0x60, 0x40, 0x00, 0x00, 
+0x16, 0x00, 0x00, 0x00, 0x60, 0x40, 0x00, 0x00, 
 0x8c, 0x41, 0x74, 0x65, 0x73, 0x74, 0x00, 0x00, 
-0x00, 0x03, 0xc7, 0x00, 0xc7, 0x00, 0x00, 0xc1, 
+0x00, 0x03, 0xca, 0x00, 0xca, 0x00, 0x00, 0xc1, 
 0x00, 0x4c, 0x00, 0x33, 0xe0, 0x05, 0xb0, 0x01, 
-0x20, 0xdf, 0xf6, 0xa0, 0x0b, 0xc3, 0x01, 0x5c, 
-0x00, 0xa9, 0x21, 0xe0, 0x07, 0x4c, 0x03, 0x01, 
-0x13, 0x03, 0xd0, 0x05, 0x4c, 0x03, 0x01, 0x14, 
-0x03, 0x5c, 0x00, 0xb1, 0x0d, 0x20, 0x20, 0x20, 
-0x20, 0x54, 0x65, 0x73, 0x74, 0x20, 0x25, 0x69, 
-0x3a, 0x20, 0x5c, 0x03, 0x70, 0x00, 0x05, 0x5c, 
-0x01, 0x5c, 0x02, 0x1d, 0xe0, 0x1d, 0x5c, 0x01, 
-0x5c, 0x02, 0xb2, 0x15, 0x46, 0x41, 0x49, 0x4c, 
-0x3a, 0x20, 0x65, 0x78, 0x70, 0x20, 0x25, 0x69, 
-0x2c, 0x20, 0x67, 0x6f, 0x74, 0x20, 0x25, 0x69, 
-0x0a, 0xd0, 0x07, 0xb0, 0x05, 0x50, 0x61, 0x73, 
-0x73, 0x0a, 0xa0, 0x0b, 0xc3, 0x01, 0x5c, 0x00, 
-0xa9, 0x21, 0xe0, 0x07, 0x4c, 0x03, 0x01, 0x13, 
-0x03, 0xd0, 0x05, 0x4c, 0x03, 0x01, 0x14, 0x03, 
-0x5c, 0x00, 0xb1, 0x0d, 0x20, 0x20, 0x20, 0x20, 
-0x54, 0x65, 0x73, 0x74, 0x20, 0x25, 0x69, 0x3a, 
-0x20, 0x5c, 0x03, 0x70, 0x00, 0x05, 0x5c, 0x01, 
-0x5c, 0x02, 0x1e, 0xe0, 0x1d, 0x5c, 0x01, 0x5c, 
-0x02, 0xb2, 0x15, 0x46, 0x41, 0x49, 0x4c, 0x3a, 
-0x20, 0x65, 0x78, 0x70, 0x20, 0x25, 0x66, 0x2c, 
-0x20, 0x67, 0x6f, 0x74, 0x20, 0x25, 0x66, 0x0a, 
-0xd0, 0x07, 0xb0, 0x05, 0x50, 0x61, 0x73, 0x73, 
-0x0a, 0xa0, 0x0b, 0xc2, 0x00, 0x5c, 0x00, 0x02, 
-0x5c, 0x01, 0x0a, 0x03, 0x23, 0x0b, 0xc0, 0x0a, 
-0xb0, 0x20, 0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 
-0x53, 0x74, 0x72, 0x75, 0x63, 0x74, 0x2c, 0x20, 
-0x50, 0x6f, 0x69, 0x6e, 0x74, 0x65, 0x72, 0x73, 
-0x20, 0x61, 0x6e, 0x64, 0x20, 0x52, 0x65, 0x66, 
-0x73, 0x0a, 0xb0, 0x0e, 0x0a, 0x54, 0x65, 0x73, 
-0x74, 0x20, 0x50, 0x6f, 0x69, 0x6e, 0x74, 0x65, 
-0x72, 0x0a, 0x4c, 0x01, 0x4c, 0x00, 0x03, 0x4c, 
-0x01, 0x01, 0x16, 0x06, 0x02, 0x06, 0x03, 0xa1, 
-0x01, 0x16, 0x5c, 0x01, 0x02, 0x70, 0x0e, 0x05, 
-0xb0, 0x22, 0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 
-0x50, 0x61, 0x73, 0x73, 0x69, 0x6e, 0x67, 0x20, 
+0x20, 0xdf, 0xf6, 0xa0, 0x0b, 0xc3, 0x02, 0x5c, 
+0x00, 0xa9, 0x3e, 0x05, 0x37, 0x83, 0x13, 0xd0, 
+0x03, 0x37, 0x83, 0x14, 0x5c, 0x00, 0xb1, 0x0d, 
+0x20, 0x20, 0x20, 0x20, 0x54, 0x65, 0x73, 0x74, 
+0x20, 0x25, 0x69, 0x3a, 0x20, 0x5c, 0x03, 0x6c, 
+0x04, 0x4c, 0x04, 0x33, 0xe0, 0x05, 0xb0, 0x01, 
+0x20, 0xdf, 0xf6, 0x36, 0x81, 0x82, 0x3c, 0x1c, 
+0x36, 0x81, 0x82, 0xb2, 0x15, 0x46, 0x41, 0x49, 
+0x4c, 0x3a, 0x20, 0x65, 0x78, 0x70, 0x20, 0x25, 
+0x69, 0x2c, 0x20, 0x67, 0x6f, 0x74, 0x20, 0x25, 
+0x69, 0x0a, 0xd0, 0x07, 0xb0, 0x05, 0x50, 0x61, 
+0x73, 0x73, 0x0a, 0xa0, 0x0b, 0xc3, 0x02, 0x5c, 
+0x00, 0xa9, 0x3e, 0x05, 0x37, 0x83, 0x13, 0xd0, 
+0x03, 0x37, 0x83, 0x14, 0x5c, 0x00, 0xb1, 0x0d, 
+0x20, 0x20, 0x20, 0x20, 0x54, 0x65, 0x73, 0x74, 
+0x20, 0x25, 0x69, 0x3a, 0x20, 0x5c, 0x03, 0x6c, 
+0x04, 0x4c, 0x04, 0x33, 0xe0, 0x05, 0xb0, 0x01, 
+0x20, 0xdf, 0xf6, 0x36, 0x81, 0x82, 0x1e, 0xe0, 
+0x1c, 0x36, 0x81, 0x82, 0xb2, 0x15, 0x46, 0x41, 
+0x49, 0x4c, 0x3a, 0x20, 0x65, 0x78, 0x70, 0x20, 
+0x25, 0x66, 0x2c, 0x20, 0x67, 0x6f, 0x74, 0x20, 
+0x25, 0x66, 0x0a, 0xd0, 0x07, 0xb0, 0x05, 0x50, 
+0x61, 0x73, 0x73, 0x0a, 0xa0, 0x0b, 0xc2, 0x00, 
+0x5c, 0x00, 0x02, 0x5c, 0x01, 0x0a, 0x03, 0x23, 
+0x0b, 0xc0, 0x0a, 0xb0, 0x20, 0x0a, 0x54, 0x65, 
+0x73, 0x74, 0x20, 0x53, 0x74, 0x72, 0x75, 0x63, 
+0x74, 0x2c, 0x20, 0x50, 0x6f, 0x69, 0x6e, 0x74, 
+0x65, 0x72, 0x73, 0x20, 0x61, 0x6e, 0x64, 0x20, 
+0x52, 0x65, 0x66, 0x73, 0x0a, 0xb0, 0x0e, 0x0a, 
+0x54, 0x65, 0x73, 0x74, 0x20, 0x50, 0x6f, 0x69, 
+0x6e, 0x74, 0x65, 0x72, 0x0a, 0x4c, 0x00, 0x6c, 
+0x01, 0x4c, 0x01, 0x01, 0x16, 0x06, 0x02, 0x06, 
+0x03, 0xa1, 0x01, 0x16, 0x5c, 0x01, 0x02, 0x70, 
+0x0e, 0x05, 0xb0, 0x22, 0x0a, 0x54, 0x65, 0x73, 
+0x74, 0x20, 0x50, 0x61, 0x73, 0x73, 0x69, 0x6e, 
+0x67, 0x20, 0x50, 0x6f, 0x69, 0x6e, 0x74, 0x65, 
+0x72, 0x20, 0x74, 0x6f, 0x20, 0x46, 0x75, 0x6e, 
+0x63, 0x74, 0x69, 0x6f, 0x6e, 0x0a, 0xa2, 0x01, 
+0x19, 0x5c, 0x01, 0x50, 0x00, 0x6c, 0x03, 0x6c, 
+0x02, 0x5c, 0x02, 0x02, 0x5c, 0x03, 0x0a, 0x03, 
+0x23, 0x70, 0x0e, 0x05, 0xb0, 0x0d, 0x0a, 0x54, 
+0x65, 0x73, 0x74, 0x20, 0x53, 0x74, 0x72, 0x75, 
+0x63, 0x74, 0x0a, 0x37, 0x85, 0x16, 0x50, 0x00, 
+0x6c, 0x06, 0x4c, 0x02, 0x80, 0x5c, 0x05, 0x03, 
+0x4c, 0x02, 0x81, 0x5c, 0x06, 0x03, 0x4c, 0x02, 
+0x82, 0xa5, 0x03, 0xa3, 0x01, 0x16, 0x4c, 0x02, 
+0x80, 0x02, 0x70, 0x0e, 0x05, 0xa4, 0x50, 0x00, 
+0x4c, 0x02, 0x81, 0x02, 0x70, 0x66, 0x05, 0xa5, 
+0xa5, 0x4c, 0x02, 0x82, 0x02, 0x70, 0x0e, 0x05, 
+0xb0, 0x18, 0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 
 0x50, 0x6f, 0x69, 0x6e, 0x74, 0x65, 0x72, 0x20, 
-0x74, 0x6f, 0x20, 0x46, 0x75, 0x6e, 0x63, 0x74, 
-0x69, 0x6f, 0x6e, 0x0a, 0xa2, 0x01, 0x19, 0x5c, 
-0x01, 0x50, 0x00, 0x70, 0xbc, 0x70, 0x0e, 0x05, 
-0xb0, 0x0d, 0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 
-0x53, 0x74, 0x72, 0x75, 0x63, 0x74, 0x0a, 0x4c, 
-0x05, 0x01, 0x16, 0x03, 0x4c, 0x06, 0x50, 0x00, 
-0x03, 0x4c, 0x02, 0x80, 0x5c, 0x05, 0x03, 0x4c, 
-0x02, 0x81, 0x5c, 0x06, 0x03, 0x4c, 0x02, 0x82, 
-0xa5, 0x03, 0xa3, 0x01, 0x16, 0x4c, 0x02, 0x80, 
-0x02, 0x70, 0x0e, 0x05, 0xa4, 0x50, 0x00, 0x4c, 
-0x02, 0x81, 0x02, 0x70, 0x65, 0x05, 0xa5, 0xa5, 
-0x4c, 0x02, 0x82, 0x02, 0x70, 0x0e, 0x05, 0xb0, 
-0x18, 0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 0x50, 
-0x6f, 0x69, 0x6e, 0x74, 0x65, 0x72, 0x20, 0x74, 
-0x6f, 0x20, 0x53, 0x74, 0x72, 0x75, 0x63, 0x74, 
-0x0a, 0x4c, 0x07, 0x4c, 0x02, 0x03, 0x4c, 0x07, 
+0x74, 0x6f, 0x20, 0x53, 0x74, 0x72, 0x75, 0x63, 
+0x74, 0x0a, 0x4c, 0x02, 0x6c, 0x07, 0x4c, 0x07, 
 0x02, 0x80, 0x01, 0x11, 0x03, 0x4c, 0x07, 0x02, 
 0x81, 0x50, 0x01, 0x03, 0x4c, 0x07, 0x02, 0x82, 
 0x01, 0x12, 0x03, 0xa6, 0x01, 0x11, 0x4c, 0x07, 
 0x02, 0x80, 0x02, 0x70, 0x0e, 0x05, 0xa7, 0x50, 
-0x01, 0x4c, 0x07, 0x02, 0x81, 0x02, 0x70, 0x65, 
+0x01, 0x4c, 0x07, 0x02, 0x81, 0x02, 0x70, 0x66, 
 0x05, 0xa8, 0x01, 0x12, 0x4c, 0x07, 0x02, 0x82, 
 0x02, 0x70, 0x0e, 0x05, 0xb0, 0x07, 0x0a, 0x44, 
 0x6f, 0x6e, 0x65, 0x0a, 0x0a, 0xa0, 0x0b, };
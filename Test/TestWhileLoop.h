@@ -1,108 +1,100 @@
 static const uint8_t PROGMEM EEPROM_Upload_TestWhileLoop[ ] = {
 0x61, 0x72, 0x6c, 0x79, 0x04, 0x00, 0x00, 0x00, 
-0x43, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
 0x34, 0x42, 0x00, 0x00, 0x70, 0x41, 0x00, 0x00, 
 0x48, 0x42, 0x74, 0x65, 0x73, 0x74, 0x00, 0x00, 
-0x00, 0x03, 0xbc, 0x00, 0xbc, 0x00, 0x00, 0xc1, 
+0x00, 0x03, 0xbf, 0x00, 0xbf, 0x00, 0x00, 0xc1, 
 0x00, 0x4c, 0x00, 0x33, 0xe0, 0x05, 0xb0, 0x01, 
-0x20, 0xdf, 0xf6, 0xa0, 0x0b, 0xc3, 0x01, 0x5c, 
-0x00, 0xa9, 0x21, 0xe0, 0x07, 0x4c, 0x03, 0x01, 
-0x13, 0x03, 0xd0, 0x05, 0x4c, 0x03, 0x01, 0x14, 
-0x03, 0x5c, 0x00, 0xb1, 0x0d, 0x20, 0x20, 0x20, 
-0x20, 0x54, 0x65, 0x73, 0x74, 0x20, 0x25, 0x69, 
-0x3a, 0x20, 0x5c, 0x03, 0x70, 0x00, 0x05, 0x5c, 
-0x01, 0x5c, 0x02, 0x1d, 0xe0, 0x1d, 0x5c, 0x01, 
-0x5c, 0x02, 0xb2, 0x15, 0x46, 0x41, 0x49, 0x4c, 
-0x3a, 0x20, 0x65, 0x78, 0x70, 0x20, 0x25, 0x69, 
-0x2c, 0x20, 0x67, 0x6f, 0x74, 0x20, 0x25, 0x69, 
-0x0a, 0xd0, 0x07, 0xb0, 0x05, 0x50, 0x61, 0x73, 
-0x73, 0x0a, 0xa0, 0x0b, 0xc3, 0x01, 0x5c, 0x00, 
-0xa9, 0x21, 0xe0, 0x07, 0x4c, 0x03, 0x01, 0x13, 
-0x03, 0xd0, 0x05, 0x4c, 0x03, 0x01, 0x14, 0x03, 
-0x5c, 0x00, 0xb1, 0x0d, 0x20, 0x20, 0x20, 0x20, 
-0x54, 0x65, 0x73, 0x74, 0x20, 0x25, 0x69, 0x3a, 
-0x20, 0x5c, 0x03, 0x70, 0x00, 0x05, 0x5c, 0x01, 
-0x5c, 0x02, 0x1e, 0xe0, 0x1d, 0x5c, 0x01, 0x5c, 
-0x02, 0xb2, 0x15, 0x46, 0x41, 0x49, 0x4c, 0x3a, 
-0x20, 0x65, 0x78, 0x70, 0x20, 0x25, 0x66, 0x2c, 
-0x20, 0x67, 0x6f, 0x74, 0x20, 0x25, 0x66, 0x0a, 
-0xd0, 0x07, 0xb0, 0x05, 0x50, 0x61, 0x73, 0x73, 
-0x0a, 0xa0, 0x0b, 0xc0, 0x03, 0xb0, 0x23, 0x0a, 
-0x54, 0x65, 0x73, 0x74, 0x20, 0x77, 0x68, 0x69, 
-0x6c, 0x65, 0x2c, 0x20, 0x6c, 0x6f, 0x6f, 0x70, 
-0x2c, 0x20, 0x62, 0x72, 0x65, 0x61, 0x6b, 0x2c, 
-0x20, 0x63, 0x6f, 0x6e, 0x74, 0x69, 0x6e, 0x75, 
-0x65, 0x0a, 0xb0, 0x10, 0x0a, 0x54, 0x65, 0x73, 
-0x74, 0x20, 0x49, 0x6e, 0x74, 0x20, 0x77, 0x68, 
-0x69, 0x6c, 0x65, 0x0a, 0x4c, 0x00, 0xa0, 0x03, 
-0x4c, 0x01, 0xa0, 0x03, 0x5c, 0x00, 0xaa, 0x17, 
-0xe0, 0x0b, 0x4c, 0x01, 0x04, 0x02, 0x4c, 0x00, 
-0x31, 0x23, 0x03, 0xdf, 0xef, 0xa1, 0x01, 0x2d, 
-0x5c, 0x01, 0x70, 0x0e, 0x05, 0x4c, 0x00, 0xa0, 
-0x03, 0x4c, 0x01, 0xa0, 0x03, 0x5c, 0x00, 0xaa, 
-0x17, 0xe0, 0x13, 0x4c, 0x01, 0x04, 0x02, 0x4c, 
-0x00, 0x31, 0x23, 0x03, 0x5c, 0x00, 0xa6, 0x1b, 
-0xe0, 0x02, 0xd0, 0x02, 0xdf, 0xe7, 0xa2, 0xaf, 
-0x5c, 0x01, 0x70, 0x0e, 0x05, 0x4c, 0x00, 0xa0, 
-0x03, 0x4c, 0x01, 0xa0, 0x03, 0x5c, 0x00, 0xaa, 
-0x17, 0xe0, 0x17, 0x4c, 0x01, 0x04, 0x02, 0x4c, 
-0x00, 0x31, 0x23, 0x03, 0x5c, 0x00, 0xa5, 0x21, 
-0xe0, 0x02, 0xdf, 0xe9, 0x4c, 0x01, 0x2d, 0x05, 
-0xdf, 0xe3, 0xa3, 0x01, 0x32, 0x5c, 0x01, 0x70, 
-0x0e, 0x05, 0xb0, 0x12, 0x0a, 0x54, 0x65, 0x73, 
-0x74, 0x20, 0x46, 0x6c, 0x6f, 0x61, 0x74, 0x20, 
-0x77, 0x68, 0x69, 0x6c, 0x65, 0x0a, 0x4c, 0x02, 
-0x50, 0x00, 0x03, 0x4c, 0x00, 0xa0, 0x03, 0x5c, 
-0x00, 0xaa, 0x17, 0xe0, 0x0d, 0x4c, 0x02, 0x04, 
+0x20, 0xdf, 0xf6, 0xa0, 0x0b, 0xc3, 0x02, 0x5c, 
+0x00, 0xa9, 0x3e, 0x05, 0x37, 0x83, 0x13, 0xd0, 
+0x03, 0x37, 0x83, 0x14, 0x5c, 0x00, 0xb1, 0x0d, 
+0x20, 0x20, 0x20, 0x20, 0x54, 0x65, 0x73, 0x74, 
+0x20, 0x25, 0x69, 0x3a, 0x20, 0x5c, 0x03, 0x6c, 
+0x04, 0x4c, 0x04, 0x33, 0xe0, 0x05, 0xb0, 0x01, 
+0x20, 0xdf, 0xf6, 0x36, 0x81, 0x82, 0x3c, 0x1c, 
+0x36, 0x81, 0x82, 0xb2, 0x15, 0x46, 0x41, 0x49, 
+0x4c, 0x3a, 0x20, 0x65, 0x78, 0x70, 0x20, 0x25, 
+0x69, 0x2c, 0x20, 0x67, 0x6f, 0x74, 0x20, 0x25, 
+0x69, 0x0a, 0xd0, 0x07, 0xb0, 0x05, 0x50, 0x61, 
+0x73, 0x73, 0x0a, 0xa0, 0x0b, 0xc3, 0x02, 0x5c, 
+0x00, 0xa9, 0x3e, 0x05, 0x37, 0x83, 0x13, 0xd0, 
+0x03, 0x37, 0x83, 0x14, 0x5c, 0x00, 0xb1, 0x0d, 
+0x20, 0x20, 0x20, 0x20, 0x54, 0x65, 0x73, 0x74, 
+0x20, 0x25, 0x69, 0x3a, 0x20, 0x5c, 0x03, 0x6c, 
+0x04, 0x4c, 0x04, 0x33, 0xe0, 0x05, 0xb0, 0x01, 
+0x20, 0xdf, 0xf6, 0x36, 0x81, 0x82, 0x1e, 0xe0, 
+0x1c, 0x36, 0x81, 0x82, 0xb2, 0x15, 0x46, 0x41, 
+0x49, 0x4c, 0x3a, 0x20, 0x65, 0x78, 0x70, 0x20, 
+0x25, 0x66, 0x2c, 0x20, 0x67, 0x6f, 0x74, 0x20, 
+0x25, 0x66, 0x0a, 0xd0, 0x07, 0xb0, 0x05, 0x50, 
+0x61, 0x73, 0x73, 0x0a, 0xa0, 0x0b, 0xc0, 0x03, 
+0xb0, 0x23, 0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 
+0x77, 0x68, 0x69, 0x6c, 0x65, 0x2c, 0x20, 0x6c, 
+0x6f, 0x6f, 0x70, 0x2c, 0x20, 0x62, 0x72, 0x65, 
+0x61, 0x6b, 0x2c, 0x20, 0x63, 0x6f, 0x6e, 0x74, 
+0x69, 0x6e, 0x75, 0x65, 0x0a, 0xb0, 0x10, 0x0a, 
+0x54, 0x65, 0x73, 0x74, 0x20, 0x49, 0x6e, 0x74, 
+0x20, 0x77, 0x68, 0x69, 0x6c, 0x65, 0x0a, 0x37, 
+0x80, 0x00, 0x37, 0x81, 0x00, 0x5c, 0x00, 0xaa, 
+0x39, 0x07, 0x4c, 0x00, 0x31, 0x38, 0x81, 0xdf, 
+0xf4, 0xa1, 0x01, 0x2d, 0x5c, 0x01, 0x70, 0x0e, 
+0x05, 0x37, 0x80, 0x00, 0x37, 0x81, 0x00, 0x5c, 
+0x00, 0xaa, 0x39, 0x0e, 0x4c, 0x00, 0x31, 0x38, 
+0x81, 0x5c, 0x00, 0xa6, 0x3b, 0x02, 0xd0, 0x02, 
+0xdf, 0xed, 0xa2, 0xaf, 0x5c, 0x01, 0x70, 0x0e, 
+0x05, 0x37, 0x80, 0x00, 0x37, 0x81, 0x00, 0x5c, 
+0x00, 0xaa, 0x39, 0x11, 0x4c, 0x00, 0x31, 0x38, 
+0x81, 0x5c, 0x00, 0xa5, 0x3e, 0x02, 0xdf, 0xef, 
+0xa1, 0x38, 0x81, 0xdf, 0xea, 0xa3, 0x01, 0x32, 
+0x5c, 0x01, 0x70, 0x0e, 0x05, 0xb0, 0x12, 0x0a, 
+0x54, 0x65, 0x73, 0x74, 0x20, 0x46, 0x6c, 0x6f, 
+0x61, 0x74, 0x20, 0x77, 0x68, 0x69, 0x6c, 0x65, 
+0x0a, 0x50, 0x00, 0x6c, 0x02, 0x37, 0x80, 0x00, 
+0x5c, 0x00, 0xaa, 0x39, 0x0d, 0x4c, 0x02, 0x04, 
 0x02, 0x4c, 0x00, 0x31, 0x0a, 0x02, 0x24, 0x03, 
-0xdf, 0xed, 0xa4, 0x50, 0x01, 0x5c, 0x02, 0x70, 
-0x65, 0x05, 0x4c, 0x00, 0xa0, 0x03, 0x4c, 0x02, 
-0x50, 0x00, 0x03, 0x5c, 0x00, 0xaa, 0x17, 0xe0, 
-0x15, 0x4c, 0x02, 0x04, 0x02, 0x4c, 0x00, 0x31, 
-0x0a, 0x02, 0x24, 0x03, 0x5c, 0x00, 0xa6, 0x1b, 
-0xe0, 0x02, 0xd0, 0x02, 0xdf, 0xe5, 0xa5, 0x50, 
-0x02, 0x5c, 0x02, 0x70, 0x65, 0x05, 0x4c, 0x00, 
-0xa0, 0x03, 0x4c, 0x02, 0x50, 0x00, 0x03, 0x5c, 
-0x00, 0xaa, 0x17, 0xe0, 0x19, 0x4c, 0x02, 0x04, 
-0x02, 0x4c, 0x00, 0x31, 0x0a, 0x02, 0x24, 0x03, 
-0x5c, 0x00, 0xa5, 0x21, 0xe0, 0x02, 0xdf, 0xe7, 
-0x4c, 0x02, 0x2e, 0x05, 0xdf, 0xe1, 0xa6, 0x50, 
-0x03, 0x5c, 0x02, 0x70, 0x65, 0x05, 0xb0, 0x0f, 
+0xdf, 0xee, 0xa4, 0x50, 0x01, 0x5c, 0x02, 0x70, 
+0x66, 0x05, 0x37, 0x80, 0x00, 0x50, 0x00, 0x6c, 
+0x02, 0x5c, 0x00, 0xaa, 0x39, 0x14, 0x4c, 0x02, 
+0x04, 0x02, 0x4c, 0x00, 0x31, 0x0a, 0x02, 0x24, 
+0x03, 0x5c, 0x00, 0xa6, 0x3b, 0x02, 0xd0, 0x02, 
+0xdf, 0xe7, 0xa5, 0x50, 0x02, 0x5c, 0x02, 0x70, 
+0x66, 0x05, 0x37, 0x80, 0x00, 0x50, 0x00, 0x6c, 
+0x02, 0x5c, 0x00, 0xaa, 0x39, 0x18, 0x4c, 0x02, 
+0x04, 0x02, 0x4c, 0x00, 0x31, 0x0a, 0x02, 0x24, 
+0x03, 0x5c, 0x00, 0xa5, 0x3e, 0x02, 0xdf, 0xe9, 
+0x4c, 0x02, 0x2e, 0x05, 0xdf, 0xe3, 0xa6, 0x50, 
+0x03, 0x5c, 0x02, 0x70, 0x66, 0x05, 0xb0, 0x0f, 
 0x0a, 0x54, 0x65, 0x73, 0x74, 0x20, 0x49, 0x6e, 
-0x74, 0x20, 0x6c, 0x6f, 0x6f, 0x70, 0x0a, 0x4c, 
-0x00, 0xa0, 0x03, 0x4c, 0x01, 0xa0, 0x03, 0x5c, 
-0x00, 0xaa, 0x1f, 0xe0, 0x02, 0xd0, 0x0b, 0x4c, 
-0x01, 0x04, 0x02, 0x4c, 0x00, 0x31, 0x23, 0x03, 
-0xdf, 0xed, 0xa7, 0x01, 0x2d, 0x5c, 0x01, 0x70, 
-0x0e, 0x05, 0x4c, 0x00, 0xa0, 0x03, 0x4c, 0x01, 
-0xa0, 0x03, 0x5c, 0x00, 0xaa, 0x1f, 0xe0, 0x02, 
-0xd0, 0x13, 0x4c, 0x01, 0x04, 0x02, 0x4c, 0x00, 
-0x31, 0x23, 0x03, 0x5c, 0x00, 0xa6, 0x1b, 0xe0, 
-0x02, 0xd0, 0x02, 0xdf, 0xe5, 0xa8, 0xaf, 0x5c, 
-0x01, 0x70, 0x0e, 0x05, 0x4c, 0x00, 0xa0, 0x03, 
-0x4c, 0x01, 0xa0, 0x03, 0x5c, 0x00, 0xaa, 0x1f, 
-0xe0, 0x02, 0xd0, 0x17, 0x4c, 0x01, 0x04, 0x02, 
-0x4c, 0x00, 0x31, 0x23, 0x03, 0x5c, 0x00, 0xa5, 
-0x21, 0xe0, 0x02, 0xdf, 0xe7, 0x4c, 0x01, 0x2d, 
-0x05, 0xdf, 0xe1, 0xa9, 0x01, 0x32, 0x5c, 0x01, 
+0x74, 0x20, 0x6c, 0x6f, 0x6f, 0x70, 0x0a, 0x37, 
+0x80, 0x00, 0x37, 0x81, 0x00, 0x5c, 0x00, 0xaa, 
+0x3d, 0x02, 0xd0, 0x07, 0x4c, 0x00, 0x31, 0x38, 
+0x81, 0xdf, 0xf2, 0xa7, 0x01, 0x2d, 0x5c, 0x01, 
+0x70, 0x0e, 0x05, 0x37, 0x80, 0x00, 0x37, 0x81, 
+0x00, 0x5c, 0x00, 0xaa, 0x3d, 0x02, 0xd0, 0x0e, 
+0x4c, 0x00, 0x31, 0x38, 0x81, 0x5c, 0x00, 0xa6, 
+0x3b, 0x02, 0xd0, 0x02, 0xdf, 0xeb, 0xa8, 0xaf, 
+0x5c, 0x01, 0x70, 0x0e, 0x05, 0x37, 0x80, 0x00, 
+0x37, 0x81, 0x00, 0x5c, 0x00, 0xaa, 0x3d, 0x02, 
+0xd0, 0x11, 0x4c, 0x00, 0x31, 0x38, 0x81, 0x5c, 
+0x00, 0xa5, 0x3e, 0x02, 0xdf, 0xed, 0xa1, 0x38, 
+0x81, 0xdf, 0xe8, 0xa9, 0x01, 0x32, 0x5c, 0x01, 
 0x70, 0x0e, 0x05, 0xb0, 0x11, 0x0a, 0x54, 0x65, 
 0x73, 0x74, 0x20, 0x46, 0x6c, 0x6f, 0x61, 0x74, 
-0x20, 0x6c, 0x6f, 0x6f, 0x70, 0x0a, 0x4c, 0x00, 
-0xa0, 0x03, 0x4c, 0x02, 0x50, 0x00, 0x03, 0x5c, 
-0x00, 0xaa, 0x1f, 0xe0, 0x02, 0xd0, 0x0d, 0x4c, 
+0x20, 0x6c, 0x6f, 0x6f, 0x70, 0x0a, 0x37, 0x80, 
+0x00, 0x50, 0x00, 0x6c, 0x02, 0x5c, 0x00, 0xaa, 
+0x3d, 0x02, 0xd0, 0x0d, 0x4c, 0x02, 0x04, 0x02, 
+0x4c, 0x00, 0x31, 0x0a, 0x02, 0x24, 0x03, 0xdf, 
+0xec, 0xaa, 0x50, 0x01, 0x5c, 0x02, 0x70, 0x66, 
+0x05, 0x37, 0x80, 0x00, 0x50, 0x00, 0x6c, 0x02, 
+0x5c, 0x00, 0xaa, 0x3d, 0x02, 0xd0, 0x14, 0x4c, 
 0x02, 0x04, 0x02, 0x4c, 0x00, 0x31, 0x0a, 0x02, 
-0x24, 0x03, 0xdf, 0xeb, 0xaa, 0x50, 0x01, 0x5c, 
-0x02, 0x70, 0x65, 0x05, 0x4c, 0x00, 0xa0, 0x03, 
-0x4c, 0x02, 0x50, 0x00, 0x03, 0x5c, 0x00, 0xaa, 
-0x1f, 0xe0, 0x02, 0xd0, 0x15, 0x4c, 0x02, 0x04, 
-0x02, 0x4c, 0x00, 0x31, 0x0a, 0x02, 0x24, 0x03, 
-0x5c, 0x00, 0xa6, 0x1b, 0xe0, 0x02, 0xd0, 0x02, 
-0xdf, 0xe3, 0xab, 0x50, 0x02, 0x5c, 0x02, 0x70, 
-0x65, 0x05, 0x4c, 0x00, 0xa0, 0x03, 0x4c, 0x02, 
-0x50, 0x00, 0x03, 0x5c, 0x00, 0xaa, 0x1f, 0xe0, 
-0x02, 0xd0, 0x19, 0x4c, 0x02, 0x04, 0x02, 0x4c, 
-0x00, 0x31, 0x0a, 0x02, 0x24, 0x03, 0x5c, 0x00, 
-0xa5, 0x21, 0xe0, 0x02, 0xdf, 0xe5, 0x4c, 0x02, 
-0x2e, 0x05, 0xdf, 0xdf, 0xac, 0x50, 0x03, 0x5c, 
-0x02, 0x70, 0x65, 0x05, 0xb0, 0x07, 0x0a, 0x44, 
-0x6f, 0x6e, 0x65, 0x0a, 0x0a, 0xa0, 0x0b, };
+0x24, 0x03, 0x5c, 0x00, 0xa6, 0x3b, 0x02, 0xd0, 
+0x02, 0xdf, 0xe5, 0xab, 0x50, 0x02, 0x5c, 0x02, 
+0x70, 0x66, 0x05, 0x37, 0x80, 0x00, 0x50, 0x00, 
+0x6c, 0x02, 0x5c, 0x00, 0xaa, 0x3d, 0x02, 0xd0, 
+0x18, 0x4c, 0x02, 0x04, 0x02, 0x4c, 0x00, 0x31, 
+0x0a, 0x02, 0x24, 0x03, 0x5c, 0x00, 0xa5, 0x3e, 
+0x02, 0xdf, 0xe7, 0x4c, 0x02, 0x2e, 0x05, 0xdf, 
+0xe1, 0xac, 0x50, 0x03, 0x5c, 0x02, 0x70, 0x66, 
+0x05, 0xb0, 0x07, 0x0a, 0x44, 0x6f, 0x6e, 0x65, 
+0x0a, 0x0a, 0xa0, 0x0b, };
@@ -0,0 +1,110 @@
+/*-------------------------------------------------------------------------
+    This source file is a part of Clover
+    For the latest info, see https://github.com/cmarrin/Clover
+    Copyright (c) 2021-2022, Chris Marrin
+    All rights reserved.
+    Use of this source code is governed by the MIT license that can be
+    found in the LICENSE file.
+-------------------------------------------------------------------------*/
+
+#include "Bench.h"
+
+#include <chrono>
+
+std::vector<Bench::Result>
+Bench::run(uint32_t loops)
+{
+    std::vector<Result> results;
+    
+    Instance sim;
+    sim.setROM(_rom);
+    sim.load();
+    
+    static const clvr::Interpreter::ExecMode modes[ ] = {
+        clvr::Interpreter::ExecMode::Interpreted,
+        clvr::Interpreter::ExecMode::Predecoded,
+    };
+    
+    for (uint8_t i = 0; i < sim.program().numCommands; ++i) {
+        // Each command entry is a 7 byte name, the param count and the
+        // init and loop addrs. Params are all 0
+        uint16_t entry = sim.program().commandStart + i * 12;
+        std::string cmd;
+        for (uint16_t j = 0; j < 7 && _rom[entry + j]; ++j) {
+            cmd += char(_rom[entry + j]);
+        }
+        std::vector<uint8_t> params(_rom[entry + 7], 0);
+
+        Result counted;
+        counted.cmd = cmd;
+        counted.loops = loops;
+        counted.stackSize = sim.program().stackSize;
+        bool success = count(i, params, counted);
+        
+        for (auto mode : modes) {
+            Result result = counted;
+            result.mode = mode;
+            result.failed = !success || !time(i, params, result);
+            results.push_back(result);
+        }
+    }
+    return results;
+}
+
+bool
+Bench::count(uint8_t index, const std::vector<uint8_t>& params, Result& result)
+{
+    Instance sim;
+    sim.setROM(_rom);
+    sim.setBudget(1);
+    
+    bool success = sim.init(index, params.data(), uint8_t(params.size()));
+    while (success && sim.suspended()) {
+        sim.resume();
+        success = sim.error() == clvr::Interpreter::Error::None;
+    }
+    if (!success) {
+        return false;
+    }
+    
+    uint64_t instrs = 0;
+    for (uint32_t i = 0; i < result.loops; ++i) {
+        int32_t delay = sim.loop();
+        while (true) {
+            instrs++;
+            result.peakStack = std::max(result.peakStack, sim.stackDepth());
+            if (delay != clvr::Interpreter::Suspended) {
+                break;
+            }
+            delay = sim.resume();
+        }
+        if (delay < 0) {
+            return false;
+        }
+    }
+    
+    result.instrsPerLoop = result.loops ? (double(instrs) / result.loops) : 0;
+    return true;
+}
+
+bool
+Bench::time(uint8_t index, const std::vector<uint8_t>& params, Result& result)
+{
+    Instance sim;
+    sim.setROM(_rom);
+    sim.setExecMode(result.mode);
+    if (!sim.init(index, params.data(), uint8_t(params.size()))) {
+        return false;
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < result.loops; ++i) {
+        if (sim.loop() < 0) {
+            return false;
+        }
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    
+    result.nsPerLoop = result.loops ? (double(elapsed.count()) / result.loops) : 0;
+    return true;
+}
@@ -0,0 +1,65 @@
+/*-------------------------------------------------------------------------
+    This source file is a part of Clover
+    For the latest info, see https://github.com/cmarrin/Clover
+    Copyright (c) 2021-2022, Chris Marrin
+    All rights reserved.
+    Use of this source code is governed by the MIT license that can be
+    found in the LICENSE file.
+-------------------------------------------------------------------------*/
+
+// Bench
+//
+// Time every command in an executable over a number of loop() calls, in
+// each exec mode. init() runs first and isn't timed. Log output is
+// counted but not printed so it doesn't end up in the times.
+//
+// The instructions per loop() and the deepest the stack gets are found in
+// a separate, untimed run in the interpreted mode with a budget of 1, so
+// each init(), loop() or resume() call runs exactly one instruction. The
+// timed runs don't pay for any counting. The stack depth is sampled
+// between instructions, so it doesn't include what a native call pushes.
+
+#pragma once
+
+#include "Simulator.h"
+
+#include <string>
+#include <vector>
+
+class Bench
+{
+public:
+    struct Result
+    {
+        std::string cmd;
+        clvr::Interpreter::ExecMode mode = clvr::Interpreter::ExecMode::Interpreted;
+        bool failed = false;
+        uint32_t loops = 0;
+        double nsPerLoop = 0;
+        double instrsPerLoop = 0;
+        uint16_t peakStack = 0;
+        uint16_t stackSize = 0;
+    };
+    
+    Bench(const std::vector<uint8_t>& rom) : _rom(rom) { }
+    
+    // Returns a Result for each command in each mode
+    std::vector<Result> run(uint32_t loops);
+    
+private:
+    class Instance : public Simulator
+    {
+    public:
+        virtual void log(const char* s) const override { _logged += strlen(s); }
+        
+        mutable uint64_t _logged = 0;
+    };
+    
+    // Fill in the instruction count and stack depth for the command
+    bool count(uint8_t index, const std::vector<uint8_t>& params, Result&);
+    
+    // Fill in the time for the command in result.mode
+    bool time(uint8_t index, const std::vector<uint8_t>& params, Result&);
+    
+    const std::vector<uint8_t>& _rom;
+};
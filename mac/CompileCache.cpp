@@ -0,0 +1,156 @@
+/*-------------------------------------------------------------------------
+    This source file is a part of Clover
+    For the latest info, see https://github.com/cmarrin/Clover
+    Copyright (c) 2021-2022, Chris Marrin
+    All rights reserved.
+    Use of this source code is governed by the MIT license that can be
+    found in the LICENSE file.
+-------------------------------------------------------------------------*/
+
+#include "CompileCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+// Entry format, all numbers are 4 bytes little endian:
+//
+//      'CLVC'
+//      <fingerprint size> <fingerprint>
+//      <executable size> <executable>
+//      <number of annotations>
+//      for each annotation: <addr> <line size> <line>
+
+static constexpr char Magic[4] = { 'C', 'L', 'V', 'C' };
+
+// FNV-1a
+static uint64_t hash(uint64_t h, const std::string& s)
+{
+    for (char c : s) {
+        h = (h ^ uint8_t(c)) * 0x100000001b3;
+    }
+    return h;
+}
+
+static void write32(std::ostream& stream, uint32_t v)
+{
+    for (int i = 0; i < 4; ++i) {
+        stream.put(char(v >> (i * 8)));
+    }
+}
+
+static bool read32(std::istream& stream, uint32_t& v)
+{
+    v = 0;
+    for (int i = 0; i < 4; ++i) {
+        int c = stream.get();
+        if (c == EOF) {
+            return false;
+        }
+        v |= uint32_t(uint8_t(c)) << (i * 8);
+    }
+    return true;
+}
+
+static bool readString(std::istream& stream, std::string& s)
+{
+    uint32_t size;
+    if (!read32(stream, size)) {
+        return false;
+    }
+    s.resize(size);
+    return size == 0 || stream.read(&s[0], size);
+}
+
+std::string
+CompileCache::key(const std::string& source, const std::string& fingerprint)
+{
+    uint64_t h = hash(hash(0xcbf29ce484222325, fingerprint), source);
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%016llx-%zx", (unsigned long long) h, source.size());
+    return buf;
+}
+
+bool
+CompileCache::find(const std::string& key, const std::string& fingerprint,
+                   std::vector<uint8_t>& executable, Annotations& annotations) const
+{
+    std::ifstream stream(path(key), std::ios::binary);
+    if (stream.fail()) {
+        return false;
+    }
+    
+    char magic[4];
+    std::string s;
+    if (!stream.read(magic, 4) || memcmp(magic, Magic, 4) != 0 || !readString(stream, s) || s != fingerprint) {
+        return false;
+    }
+    
+    if (!readString(stream, s)) {
+        return false;
+    }
+    std::vector<uint8_t> exec(s.begin(), s.end());
+    
+    uint32_t count;
+    if (!read32(stream, count)) {
+        return false;
+    }
+    
+    Annotations ann;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t addr;
+        if (!read32(stream, addr) || !readString(stream, s)) {
+            return false;
+        }
+        ann.emplace_back(int32_t(addr), s);
+    }
+    
+    executable = std::move(exec);
+    annotations = std::move(ann);
+    return true;
+}
+
+bool
+CompileCache::store(const std::string& key, const std::string& fingerprint,
+                    const std::vector<uint8_t>& executable, const Annotations& annotations) const
+{
+    std::error_code ec;
+    std::filesystem::create_directories(_dir, ec);
+    
+    // Write to a file only this thread uses, then move it into place
+    std::string name = path(key);
+    std::string temp = name + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+    
+    std::ofstream stream(temp, std::ios::binary);
+    if (stream.fail()) {
+        return false;
+    }
+    
+    stream.write(Magic, 4);
+    write32(stream, uint32_t(fingerprint.size()));
+    stream << fingerprint;
+    write32(stream, uint32_t(executable.size()));
+    stream.write(reinterpret_cast<const char*>(executable.data()), executable.size());
+    write32(stream, uint32_t(annotations.size()));
+    for (const auto& it : annotations) {
+        write32(stream, uint32_t(it.first));
+        write32(stream, uint32_t(it.second.size()));
+        stream << it.second;
+    }
+    stream.close();
+    
+    if (stream.fail()) {
+        remove(temp.c_str());
+        return false;
+    }
+    
+    std::filesystem::rename(temp, name, ec);
+    if (ec) {
+        remove(temp.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,48 @@
+/*-------------------------------------------------------------------------
+    This source file is a part of Clover
+    For the latest info, see https://github.com/cmarrin/Clover
+    Copyright (c) 2021-2022, Chris Marrin
+    All rights reserved.
+    Use of this source code is governed by the MIT license that can be
+    found in the LICENSE file.
+-------------------------------------------------------------------------*/
+
+// CompileCache
+//
+// A directory of compiled executables, each in a file named by a hash of
+// the source and the compiler's fingerprint (see Compiler::fingerprint()).
+// An entry holds the executable and its annotations, so a hit gives
+// everything a compile would have without scanning any source. Only
+// successful compiles are stored. The fingerprint is saved in the entry
+// and checked on a hit, so a hash collision is just a miss.
+//
+// Entries are written to a temp file and renamed into place, so files
+// being built on separate threads can share a cache.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class CompileCache
+{
+public:
+    using Annotations = std::vector<std::pair<int32_t, std::string>>;
+    
+    CompileCache(const std::string& dir) : _dir(dir) { }
+    
+    // Returns the key for the source compiled with a compiler having
+    // the passed fingerprint
+    static std::string key(const std::string& source, const std::string& fingerprint);
+    
+    bool find(const std::string& key, const std::string& fingerprint,
+              std::vector<uint8_t>& executable, Annotations&) const;
+    bool store(const std::string& key, const std::string& fingerprint,
+               const std::vector<uint8_t>& executable, const Annotations&) const;
+    
+private:
+    std::string path(const std::string& key) const { return _dir + "/" + key + ".clvc"; }
+    
+    std::string _dir;
+};
@@ -0,0 +1,134 @@
+/*-------------------------------------------------------------------------
+    This source file is a part of Clover
+    For the latest info, see https://github.com/cmarrin/Clover
+    Copyright (c) 2021-2022, Chris Marrin
+    All rights reserved.
+    Use of this source code is governed by the MIT license that can be
+    found in the LICENSE file.
+-------------------------------------------------------------------------*/
+
+#include "Fleet.h"
+
+Fleet::Fleet(const std::vector<uint8_t>& rom, uint32_t threads)
+    : _rom(rom)
+{
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (uint32_t i = 0; i < threads; ++i) {
+        _threads.emplace_back(&Fleet::worker, this);
+    }
+}
+
+Fleet::~Fleet()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _quit = true;
+    }
+    _start.notify_all();
+    for (auto& it : _threads) {
+        it.join();
+    }
+}
+
+void
+Fleet::addInstance(const std::vector<uint8_t>& params, uint32_t seed)
+{
+    _instances.emplace_back(new Instance());
+    _instances.back()->setROM(_rom);
+    _instances.back()->seedRandom(seed);
+    _instances.back()->_params = params;
+}
+
+bool
+Fleet::init(const char* cmd)
+{
+    if (_instances.empty()) {
+        return false;
+    }
+    
+    // The first instance is the image the rest share
+    const Instance& image = *_instances[0];
+    _instances[0]->load();
+    
+    std::atomic<bool> success { true };
+    parallel(size(), [&](uint32_t i)
+    {
+        Instance& inst = *_instances[i];
+        if (i != 0) {
+            inst.load(image);
+        }
+        inst._time = 0;
+        inst._loops = 0;
+        inst._failed = !inst.init(cmd, inst._params.data(), inst._params.size());
+        if (inst._failed) {
+            success = false;
+        }
+    });
+    return success;
+}
+
+void
+Fleet::run(uint64_t ms)
+{
+    parallel(size(), [this, ms](uint32_t i)
+    {
+        Instance& inst = *_instances[i];
+        while (!inst._failed && inst._time < ms) {
+            int32_t delay = inst.loop();
+            if (delay < 0) {
+                inst._failed = true;
+                break;
+            }
+            inst._time += std::max(delay, int32_t(1));
+            inst._loops++;
+        }
+    });
+}
+
+void
+Fleet::parallel(uint32_t count, const std::function<void(uint32_t)>& f)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _job = &f;
+    _jobCount = count;
+    _next = 0;
+    _busy = uint32_t(_threads.size());
+    _generation++;
+    _start.notify_all();
+    _done.wait(lock, [this] { return _busy == 0; });
+    _job = nullptr;
+}
+
+void
+Fleet::worker()
+{
+    uint32_t generation = 0;
+    
+    while (true) {
+        const std::function<void(uint32_t)>* job;
+        uint32_t count;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _start.wait(lock, [this, generation] { return _quit || _generation != generation; });
+            if (_quit) {
+                return;
+            }
+            generation = _generation;
+            job = _job;
+            count = _jobCount;
+        }
+        
+        // Take instances one at a time so a slow one doesn't hold up the
+        // rest of a fixed share
+        for (uint32_t i = _next++; i < count; i = _next++) {
+            (*job)(i);
+        }
+        
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (--_busy == 0) {
+            _done.notify_one();
+        }
+    }
+}
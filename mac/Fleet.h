@@ -0,0 +1,93 @@
+/*-------------------------------------------------------------------------
+    This source file is a part of Clover
+    For the latest info, see https://github.com/cmarrin/Clover
+    Copyright (c) 2021-2022, Chris Marrin
+    All rights reserved.
+    Use of this source code is governed by the MIT license that can be
+    found in the LICENSE file.
+-------------------------------------------------------------------------*/
+
+// Fleet
+//
+// Simulate many devices running the same executable, each with its own
+// params. The first instance loads the executable and the rest share it
+// with Interpreter::load(const Interpreter&), so each one only has its
+// own globals and stack.
+//
+// Time is simulated. Each instance runs loop() when its last delay has
+// passed. Instances don't interact, so run() hands them out to a pool of
+// threads and each is run up to the end time on its own. A delay of 0 is
+// taken as 1ms so an instance can't stop time from advancing. An instance
+// stops running at its first error. Log output is counted but not printed,
+// since all the instances would be writing at once.
+
+#pragma once
+
+#include "Simulator.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Fleet
+{
+public:
+    // threads of 0 uses one for each core
+    Fleet(const std::vector<uint8_t>& rom, uint32_t threads = 0);
+    ~Fleet();
+    
+    // seed is for the instance's random numbers (see Interpreter::seedRandom())
+    void addInstance(const std::vector<uint8_t>& params, uint32_t seed = clvr::Interpreter::DefaultRandomSeed);
+    
+    // Load the executable and run init() for cmd on every instance. Returns
+    // false if it fails on any of them
+    bool init(const char* cmd);
+    
+    // Run every instance until its next loop() is due at or after ms
+    void run(uint64_t ms);
+    
+    uint32_t size() const { return uint32_t(_instances.size()); }
+    uint32_t threads() const { return uint32_t(_threads.size()); }
+    
+    const clvr::Interpreter& interpreter(uint32_t i) const { return *_instances[i]; }
+    uint64_t loops(uint32_t i) const { return _instances[i]->_loops; }
+    uint64_t time(uint32_t i) const { return _instances[i]->_time; }
+    uint64_t logged(uint32_t i) const { return _instances[i]->_logged; }
+    bool failed(uint32_t i) const { return _instances[i]->_failed; }
+    
+private:
+    class Instance : public Simulator
+    {
+    public:
+        virtual void log(const char* s) const override { _logged += strlen(s); }
+        
+        std::vector<uint8_t> _params;
+        uint64_t _time = 0;         // When the next loop() is due
+        uint64_t _loops = 0;
+        mutable uint64_t _logged = 0;
+        bool _failed = false;
+    };
+    
+    // Call f(i) for i from 0 to count - 1 across the pool and wait for
+    // them all to finish
+    void parallel(uint32_t count, const std::function<void(uint32_t)>& f);
+    void worker();
+    
+    const std::vector<uint8_t>& _rom;
+    std::vector<std::unique_ptr<Instance>> _instances;
+    
+    std::vector<std::thread> _threads;
+    std::mutex _mutex;
+    std::condition_variable _start;
+    std::condition_variable _done;
+    const std::function<void(uint32_t)>* _job = nullptr;
+    uint32_t _jobCount = 0;
+    std::atomic<uint32_t> _next { 0 };
+    uint32_t _busy = 0;
+    uint32_t _generation = 0;
+    bool _quit = false;
+};
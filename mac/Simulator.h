@@ -0,0 +1,59 @@
+/*-------------------------------------------------------------------------
+    This source file is a part of Clover
+    For the latest info, see https://github.com/cmarrin/Clover
+    Copyright (c) 2021-2022, Chris Marrin
+    All rights reserved.
+    Use of this source code is governed by the MIT license that can be
+    found in the LICENSE file.
+-------------------------------------------------------------------------*/
+
+// Simulator
+//
+// Subclass of Interpreter that outputs device info to console. The ROM
+// is not copied. The buffer passed to setROM() must outlive the Simulator,
+// which lets any number of them run the same executable.
+
+#pragma once
+
+#include "Interpreter.h"
+#include <iostream>
+#include <vector>
+
+class Simulator : public clvr::Interpreter
+{
+public:
+    static constexpr uint32_t MaxExecutableSize = 1024;    // Size of a Nano's EEPROM
+    static constexpr uint32_t MaxROMSize = 65535;           // ROM addrs are 16 bits
+
+    Simulator(clvr::NativeModule** mod = nullptr, uint32_t modSize = 0, uint8_t* arena = nullptr, uint16_t arenaSize = 0)
+        : Interpreter(mod, modSize, arena, arenaSize)
+    { }
+    virtual ~Simulator() { }
+    
+    virtual uint8_t rom(uint16_t i) const override
+    {
+        return (i < _romSize) ? _rom[i] : 0;
+    }
+    
+    virtual void romRead(uint16_t addr, uint8_t* buf, uint16_t len) const override
+    {
+        uint16_t n = (addr < _romSize) ? min(len, uint16_t(_romSize - addr)) : 0;
+        memcpy(buf, _rom + addr, n);
+        memset(buf + n, 0, len - n);
+    }
+    
+    virtual void log(const char* s) const override
+    {
+        std::cout << s << std::flush;
+    }
+
+    void setROM(const std::vector<uint8_t>& buf)
+    {
+        _rom = &buf[0];
+        _romSize = min(buf.size(), size_t(MaxROMSize));
+    }
+    
+private:
+    const uint8_t* _rom = nullptr;
+    uint16_t _romSize = 0;
+};
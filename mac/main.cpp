@@ -7,60 +7,101 @@
     found in the LICENSE file.
 -------------------------------------------------------------------------*/
 
+#include "Bench.h"
+#include "CompileCache.h"
 #include "Compiler.h"
+#include "CompileEngine.h"
+#include "Compressor.h"
+#include "CppGenerator.h"
 #include "Decompiler.h"
+#include "Fleet.h"
 #include "Interpreter.h"
+#include "Simulator.h"
 #include <iostream>
 #include <filesystem>
 #include <fstream>
 #include <getopt.h>
+#include <atomic>
+#include <chrono>
 #include <cstdio>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <thread>
 
-static constexpr uint32_t MaxExecutableSize = 1024;
+static constexpr uint32_t MaxExecutableSize = Simulator::MaxExecutableSize;
+static constexpr uint32_t MaxWideExecutableSize = 255 * 64;   // Segment counts in a manifest are 1 byte
 static constexpr int NumLoops = 0;
+static constexpr uint64_t FleetTime = 1000; // ms of loop() time simulated with -f
 
-// Simulator
+// compile [-xidshcpnzw] [-a <n>] [-l <n>] [-f <n>] [-e <cmd>] [-b <n>] [-r <n>] [-j <n>] [-k <dir>] [-u <dir>] <input file>...
 //
-// Subclass of Interpreter that outputs device info to consolee
-class Simulator : public clvr::Interpreter
-{
-public:
-    Simulator(clvr::NativeModule** mod = nullptr, uint32_t modSize = 0) : Interpreter(mod, modSize) { }
-    virtual ~Simulator() { }
-    
-    virtual uint8_t rom(uint16_t i) const override
-    {
-        return (i < MaxExecutableSize) ? _rom[i] : 0;
-    }
-    
-    virtual void log(const char* s) const override
-    {
-        std::cout << s << std::flush;
-    }
-
-    void setROM(const std::vector<uint8_t>& buf)
-    {
-        size_t size = buf.size();
-        if (size > 1024){
-            size = 1024;
-        }
-        memcpy(_rom, &buf[0], size);
-    }
-    
-private:
-    uint8_t _rom[1024];
-};
-
-// compile [-xdsh] <input file>...
-//
-//      -s      output binary in 64 byte segments (named <root name>00.{clvr,arly}, etc.
+//      -s      output binary in 64 byte segments (named <root name>00.arlx, etc.
+//              With -w the index has 3 digits, <root name>000.arlx)
 //      -h      output in include file format. Output file is <root name>.h
+//      -c      also output the code translated to C++. Output file is <root name>Compiled.h
 //      -d      decompile and print result
 //      -x      simulate resulting binary
+//      -i      simulate by interpreting each opcode rather than predecoding
+//      -a <n>  simulate with an arena of n bytes rather than the heap (see
+//              the Interpreter constructor). Implies -i
+//      -p      simulate and show a profile of each test. Needs a build with
+//              CLOVER_PROFILE=1 (the Debug config has it)
+//      -f <n>  simulate n instances sharing the binary, each with Param(0)
+//              set to its index, and show how long they took and why any
+//              failed
+//      -e <cmd> the command -f runs. The default is the first one in the
+//              executable. Params past Param(0) are those of the test
+//              command if it has the same name and count, otherwise 0
+//      -r <n>  seed the simulator's random numbers with n, so a run can be
+//              repeated. Otherwise the seed comes from the time. Each -f
+//              instance gets its own seed made from n
+//      -b <n>  benchmark each command, running loop() n times in each
+//              exec mode. Results are printed as CSV lines starting with
+//              'bench,' (see Bench Output below)
+//      -n      don't run the peephole optimizer or inline calls
+//      -z      output a compressed executable (see Runtime/Compressed.h).
+//              The executable size limit is for the compressed size. It
+//              is run compressed too, but decompiled and translated to C++
+//              from the uncompressed code
+//      -l <n>  leave out log statements with a level above n (a log without
+//              a level is at 0, so -1 leaves them all out)
+//      -w      allow executables up to MaxWideExecutableSize bytes rather
+//              than the MaxExecutableSize that fits in a Nano's EEPROM, for
+//              boards with more ROM. Code past what the short ops reach
+//              uses the long ones (see Runtime/Opcodes.h)
+//      -j <n>  compile up to n files at once (default is one per core)
+//      -k <dir> keep compiled executables in dir. A file whose source and
+//              compiler (see Compiler::fingerprint()) haven't changed
+//              since it was kept isn't compiled again. Its output files
+//              are written from the kept executable
+//      -u <dir> output only the 64 byte segments that differ from the
+//              executable deployed now, which is <root name>.arlx in dir,
+//              and a manifest (see Delta Upload below). Implies -s
 //
 // Multiple input files accepted. Output file(s) are placed in the same dir as input
 // files with extension .arlx or .h. If segmented (-s), filename has 2 digit suffix
-// added before the .arlx.
+// (3 with -w) added before the .arlx. The files are compiled and written in parallel, but
+// each file's messages are shown together, in input order. A file that fails to
+// compile doesn't stop the rest. After that each one is decompiled, simulated,
+// etc. in order.
+
+// Delta Upload
+//
+// With -u only the segments whose bytes differ from the deployed executable
+// are written, in the same format as -s. If there is no deployed executable
+// all segments are written. The manifest, <root name>.manifest, is:
+//
+//      <executable size, 2 bytes>
+//      <CRC-32 of the whole executable, 4 bytes>
+//      <number of segments written, 1 byte>
+//      <index of each segment written, 1 byte each>
+//
+// All numbers are little endian. The CRC-32 is the common one (polynomial
+// 0xedb88320, starting at and xored with 0xffffffff) so a device can check
+// its EEPROM after the segments are written. The deployed executable is read
+// before anything is written, so dir can be where the outputs go. Replace it
+// with the new one once the devices have it.
 
 // Include file format
 //
@@ -69,6 +110,26 @@ private:
 // byte of the binary data as a hex value. It also has a
 // 'static constexpr uint16_t EEPROM_Upload_Size = ' with the number of bytes.
 
+// Bench Output
+//
+// The first line is a header naming the fields, then there is a line for
+// each command in each mode:
+//
+//      bench,<file>,<command>,<mode>,<optimized>,<loops>,<ns per loop>,
+//          <instructions per loop>,<instructions per second>,
+//          <peak stack>,<stack size>,<ok>
+//
+// mode is 'interpreted' or 'predecoded', optimized and ok are 0 or 1. Stack
+// sizes are in 4 byte words.
+
+// Compiled file format
+//
+// This file can be included in an Arduino sketch to run the code as C++
+// rather than uploading it. It contains 'static const uint8_t PROGMEM
+// Clover_<root name>_ROM[ ]' with the header, constants and commands of the
+// executable and the function 'Clover_<root name>' to pass to
+// Interpreter::setCompiledCode(). See CppGenerator.h.
+
 struct Test
 {
     const char* _cmd;
@@ -79,7 +140,16 @@ static std::vector<Test> Tests = {
     { "test", { 4, 7, 11 } },
 };
 
-static void showError(clvr::Compiler::Error error, clvr::Token token, const std::string& str, uint32_t lineno, uint32_t charno)
+// Results of building one input file
+struct Build
+{
+    std::vector<uint8_t> executable;
+    std::vector<std::pair<int32_t, std::string>> annotations;
+    std::string log;
+    bool success = false;
+};
+
+static void showError(std::ostream& out, clvr::Compiler::Error error, clvr::Token token, const std::string& str, uint32_t lineno, uint32_t charno)
 {
     const char* err = "unknown";
     switch(error) {
@@ -124,42 +194,494 @@ static void showError(clvr::Compiler::Error error, clvr::Token token, const std:
         case clvr::Compiler::Error::DuplicateIdentifier: err = "duplicate identifier"; break;
         case clvr::Compiler::Error::ExecutableTooBig: err = "executable too big"; break;
         case clvr::Compiler::Error::InitializerNotAllowed: err = "initializer not allowed for this type"; break;
+        case clvr::Compiler::Error::CompileTimeCallFailed: err = "function failed when run at compile time"; break;
     }
     
     if (token == clvr::Token::EndOfFile) {
         err = "unexpected tokens after EOF";
     }
     
-    std::cout << "Compile failed: " << err;
+    out << "Compile failed: " << err;
     if (!str.empty()) {
-        std::cout << " ('" << str << "')";
+        out << " ('" << str << "')";
+    }
+    out << " on line " << lineno << ":" << charno << "\n";
+}
+
+static const char* interpreterError(clvr::Interpreter::Error error)
+{
+    switch(error) {
+        case clvr::Interpreter::Error::None: return "internal error";
+        case clvr::Interpreter::Error::CmdNotFound: return "command not found";
+        case clvr::Interpreter::Error::UnexpectedOpInIf: return "unexpected op in if (internal error)";
+        case clvr::Interpreter::Error::InvalidOp: return "invalid opcode";
+        case clvr::Interpreter::Error::InvalidNativeFunction: return "invalid native function";
+        case clvr::Interpreter::Error::OnlyMemAddressesAllowed: return "only Mem addresses allowed";
+        case clvr::Interpreter::Error::StackOverrun: return "can't call, stack full";
+        case clvr::Interpreter::Error::StackUnderrun: return "stack underrun";
+        case clvr::Interpreter::Error::StackOutOfRange: return "stack access out of range";
+        case clvr::Interpreter::Error::AddressOutOfRange: return "address out of range";
+        case clvr::Interpreter::Error::InvalidModuleOp: return "invalid operation in module";
+        case clvr::Interpreter::Error::ExpectedSetFrame: return "expected SetFrame as first function op";
+        case clvr::Interpreter::Error::NotEnoughArgs: return "not enough args on stack";
+        case clvr::Interpreter::Error::WrongNumberOfArgs: return "wrong number of args";
+        case clvr::Interpreter::Error::NativeIdConflict: return "native function id in more than one module";
+        case clvr::Interpreter::Error::OutOfMemory: return "arena too small";
+        case clvr::Interpreter::Error::DivideByZero: return "divide by zero";
+    }
+    return "unknown";
+}
+
+#if CLOVER_PROFILE
+// Return the source line of the function with code at addr. The annotation
+// for each line is the code addr of its last instruction, or -1 if it has
+// none. A function's SetFrame is emitted after its '{' is scanned, so it
+// is on the line of the first statement. Go back from there to the line
+// that starts the function.
+static std::string functionLine(const std::vector<std::pair<int32_t, std::string>>& annotations, int32_t addr)
+{
+    size_t i = 0;
+    while (i < annotations.size() && annotations[i].first < addr) {
+        ++i;
+    }
+    if (i == annotations.size()) {
+        return "";
+    }
+    
+    for (size_t j = i + 1; j > 0; --j) {
+        std::string line = annotations[j - 1].second;
+        line.erase(0, line.find_first_not_of(" \t"));
+        line.erase(line.find_last_not_of(" \t\r\n") + 1);
+        if (line.compare(0, 8, "function") == 0) {
+            return std::to_string(j) + ": " + line;
+        }
+    }
+    return "";
+}
+
+static void showProfile(const Simulator& sim, const std::vector<std::pair<int32_t, std::string>>& annotations)
+{
+    const clvr::Interpreter::Profile& profile = sim.profile();
+    std::cout << "Profile: " << profile.instrs << " instructions, stack depth "
+              << profile.maxStack << " of " << sim.program().stackSize << "\n";
+    
+    std::vector<clvr::Interpreter::FunctionProfile> functions(profile.functions, profile.functions + profile.numFunctions);
+    std::sort(functions.begin(), functions.end(), [ ](const auto& a, const auto& b) { return a.instrs > b.instrs; });
+    
+    std::cout << "    Functions:\n";
+    std::cout << "          addr     calls    instrs\n";
+    for (const auto& it : functions) {
+        std::cout << "        " << std::setw(6) << it.addr << std::setw(10) << it.calls << std::setw(10) << it.instrs
+                  << "    " << functionLine(annotations, it.addr - sim.program().codeOffset) << "\n";
+    }
+
+    std::vector<std::pair<uint32_t, uint8_t>> ops;
+    for (uint16_t i = 0; i < 256; ++i) {
+        if (profile.ops[i]) {
+            ops.emplace_back(profile.ops[i], uint8_t(i));
+        }
+    }
+    std::sort(ops.begin(), ops.end(), [ ](const auto& a, const auto& b) { return a.first > b.first; });
+    
+    std::cout << "    Opcodes:\n";
+    for (const auto& it : ops) {
+        clvr::OpData opData;
+        std::string name = clvr::CompileEngine::opDataFromOp(clvr::Op(it.second), opData) ? opData._str : std::to_string(it.second);
+        std::cout << "        " << std::left << std::setw(16) << name << std::right << std::setw(10) << it.first
+                  << std::setw(7) << std::fixed << std::setprecision(1) << (100.0 * it.first / profile.instrs) << "%\n";
+    }
+    
+    bool header = false;
+    for (uint16_t i = 0; i < 256; ++i) {
+        if (profile.natives[i]) {
+            if (!header) {
+                std::cout << "    Native calls:\n";
+                header = true;
+            }
+            char buf[5];
+            snprintf(buf, sizeof(buf), "0x%02x", i);
+            std::cout << "        module " << (i >> 4) << " id " << buf << std::setw(10) << profile.natives[i] << "\n";
+        }
+    }
+    std::cout << "\n";
+}
+#endif
+
+// Compile one input file and write its output files. Everything is
+// printed to out rather than std::cout, so files can be built on
+// separate threads and their output shown in order afterward.
+static uint32_t crc32(const std::vector<uint8_t>& buf)
+{
+    uint32_t crc = 0xffffffff;
+    for (uint8_t b : buf) {
+        crc ^= b;
+        for (int i = 0; i < 8; ++i) {
+            crc = (crc >> 1) ^ ((crc & 1) ? 0xedb88320 : 0);
+        }
+    }
+    return ~crc;
+}
+
+// Segment files are <path><index>.arlx. The index is as wide as the most
+// segments maxExecutableSize allows, 2 digits normally and 3 with -w. All
+// the names in a run are the same width, so segment 100 of 'big' can't be
+// named the same as segment 00 of 'big1'
+static std::string segmentName(const std::string& path, uint32_t index, uint32_t maxExecutableSize)
+{
+    int width = ((maxExecutableSize + 63) / 64 > 100) ? 3 : 2;
+    char buf[12];
+    snprintf(buf, sizeof(buf), "%0*u", width, unsigned(index));
+    return path + buf + ".arlx";
+}
+
+// Find the command named cmd in an executable, or the first command if
+// cmd is empty, which sets cmd to its name. Returns false if there isn't
+// one with that name
+static bool findCommand(const std::vector<uint8_t>& executable, std::string& cmd, uint8_t& numParams)
+{
+    std::vector<uint8_t> rom;
+    if (!clvr::Compressor::decompress(executable, rom) || rom.size() < clvr::ConstOffset) {
+        return false;
+    }
+    
+    // Each command entry is a 7 byte name, the param count and the init
+    // and loop addrs. The entries end with a 0
+    size_t entry = clvr::ConstOffset + (size_t(rom[4]) | (size_t(rom[5]) << 8)) * 4;
+    for ( ; entry + 12 <= rom.size() && rom[entry]; entry += 12) {
+        std::string name;
+        for (size_t j = 0; j < 7 && rom[entry + j]; ++j) {
+            name += char(rom[entry + j]);
+        }
+        if (cmd.empty() || cmd == name) {
+            cmd = name;
+            numParams = rom[entry + 7];
+            return true;
+        }
+    }
+    return false;
+}
+
+// True if the 64 byte segment at index differs from the one deployed
+static bool segmentChanged(const std::vector<uint8_t>& executable, const std::vector<uint8_t>& deployed, uint8_t index)
+{
+    size_t start = size_t(index) * 64;
+    size_t end = std::min(start + 64, executable.size());
+    if (deployed.size() < end) {
+        return true;
     }
-    std::cout << " on line " << lineno << ":" << charno << "\n";
+    return !std::equal(executable.begin() + start, executable.begin() + end, deployed.begin() + start);
+}
+
+static bool build(const std::string& file, std::ostream& out, std::vector<uint8_t>& executable,
+                  std::vector<std::pair<int32_t, std::string>>& annotations, const CompileCache* cache,
+                  const std::string& deployedDir, uint32_t maxExecutableSize, bool optimize, bool compress,
+                  int32_t logLevel, bool segmented, bool headerFile, bool compiledFile)
+{
+    clvr::Compiler compiler;
+    std::ifstream stream(file, std::ios::binary);
+    if (stream.fail()) {
+        out << "Can't open '" << file << "'\n";
+        return false;
+    }
+    
+    // Read the whole file and let the compiler scan it in place
+    std::string source((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    
+    out << "Compiling '" << file << "'\n";
+    
+    clvr::Compiler::Language lang;
+    std::string suffix = file.substr(file.find_last_of('.'));
+    if (suffix == ".clvr") {
+        lang = clvr::Compiler::Language::Clover;
+    } else if (suffix == ".arly") {
+        lang = clvr::Compiler::Language::Arly;
+    } else {
+        out << "*** suffix '" << suffix << "' not recognized\n";
+        return false;
+    }
+    
+    const std::vector<clvr::NativeModule*> modules;
+    compiler.setOptimize(optimize);
+    compiler.setCompress(compress);
+    compiler.setLogLevel(logLevel);
+    
+    std::string fingerprint;
+    std::string key;
+    if (cache) {
+        fingerprint = compiler.fingerprint(lang, maxExecutableSize, modules);
+        key = CompileCache::key(source, fingerprint);
+    }
+    
+    // A kept executable may have been compiled with -w, so one that's too
+    // big is compiled again to get the error
+    if (cache && cache->find(key, fingerprint, executable, annotations) && executable.size() <= maxExecutableSize) {
+        out << "Compile cached. Executable size=" << std::to_string(executable.size()) << "\n";
+    } else {
+        executable.clear();
+        annotations.clear();
+        compiler.compile(source.data(), source.size(), lang, executable, maxExecutableSize, modules, &annotations);
+        if (compiler.error() != clvr::Compiler::Error::None) {
+            showError(out, compiler.error(), compiler.expectedToken(), compiler.expectedString(), compiler.lineno(), compiler.charno());
+            out << "          Executable size=" << std::to_string(executable.size()) << "\n";
+            return false;
+        }
+
+        out << "Compile succeeded. Executable size=" << std::to_string(executable.size());
+        if (clvr::Compressor::isCompressed(executable)) {
+            out << ", compressed from " << (uint16_t(executable[4]) | (uint16_t(executable[5]) << 8));
+        }
+        out << "\n";
+        if (!compiler.stackBounded()) {
+            out << "    Stack size is unbounded (a command can recurse), using a fixed size\n";
+        }
+        
+        if (cache && !cache->store(key, fingerprint, executable, annotations)) {
+            out << "*** couldn't save to the compile cache\n";
+        }
+    }
+    
+    // Write executable
+    // Use the same name as the input file for the output
+    std::string path = file.substr(0, file.find_last_of('.'));
+    std::string root = path.substr(path.find_last_of('/') + 1);
+    
+    // Read the deployed executable before any old outputs are deleted,
+    // in case it's one of them
+    bool delta = !deployedDir.empty();
+    std::vector<uint8_t> deployed;
+    if (delta) {
+        std::string name = deployedDir + "/" + root + ".arlx";
+        std::ifstream deployedStream(name, std::ios::binary);
+        if (deployedStream.fail()) {
+            out << "No deployed executable '" << name << "', writing all segments\n";
+        } else {
+            deployed.assign(std::istreambuf_iterator<char>(deployedStream), std::istreambuf_iterator<char>());
+        }
+    }
+    
+    // Delete any old copies
+    std::string name = path + ".h";
+    remove(name.c_str());
+
+    name = path + ".manifest";
+    remove(name.c_str());
+
+    name = path + "Compiled.h";
+    remove(name.c_str());
+
+    name = path + ".arlx";
+    remove(name.c_str());
+
+    for (uint32_t i = 0; ; ++i) {
+        name = segmentName(path, i, maxExecutableSize);
+        if (remove(name.c_str()) != 0) {
+            break;
+        }
+    }
+    
+    out << "\nEmitting executable to '" << path << "'\n";
+    std::fstream outStream;
+    
+    // If segmented break it up into 64 byte chunks, prefix each file with start addr byte
+    size_t sizeRemaining = executable.size();
+    std::vector<uint8_t> written;
+    
+    for (uint8_t i = 0; ; i++) {
+        if (delta && !segmentChanged(executable, deployed, i)) {
+            sizeRemaining -= std::min(sizeRemaining, size_t(64));
+            if (sizeRemaining == 0) {
+                break;
+            }
+            continue;
+        }
+        
+        if (segmented) {
+            name = segmentName(path, i, maxExecutableSize);
+        } else if (headerFile) {
+            name = path + ".h";
+        } else {
+            name = path + ".arlx";
+        }
+    
+        std::ios_base::openmode mode = std::fstream::out;
+        if (!headerFile) {
+            mode|= std::fstream::binary;
+        }
+        
+        outStream.open(name.c_str(), mode);
+        if (outStream.fail()) {
+            out << "Can't open '" << name << "'\n";
+            return false;
+        } else {
+            char* buf = reinterpret_cast<char*>(&(executable[i * 64]));
+            size_t sizeToWrite = sizeRemaining;
+            
+            if (segmented && sizeRemaining > 64) {
+                sizeToWrite = 64;
+            }
+            
+            if (segmented) {
+                // Write the 2 byte offset
+                uint16_t addr = uint16_t(i) * 64;
+                outStream.put(uint8_t(addr & 0xff));
+                outStream.put(uint8_t(addr >> 8));
+            }
+            
+            if (!headerFile) {
+                // Write the buffer
+                outStream.write(buf, sizeToWrite);
+                if (outStream.fail()) {
+                    out << "Save failed\n";
+                    return false;
+                } else {
+                    sizeRemaining -= sizeToWrite;
+                    outStream.close();
+                    out << "    Saved " << name << "\n";
+                    written.push_back(i);
+                    if (sizeRemaining == 0) {
+                        break;
+                    }
+                }
+            } else {
+                outStream << "static const uint8_t PROGMEM EEPROM_Upload_" << root << "[ ] = {\n";
+                
+                for (size_t i = 0; i < sizeRemaining; ++i) {
+                    char hexbuf[5];
+                    sprintf(hexbuf, "0x%02x", executable[i]);
+                    outStream << hexbuf << ", ";
+                    if (i % 8 == 7) {
+                        outStream << std::endl;
+                    }
+                }
+
+                outStream << "};\n";
+                outStream.close();
+                out << "    Saved " << name << "\n";
+                
+                break;
+            }
+        }
+    }
+    out << "Executables saved\n";
+
+    if (delta) {
+        uint16_t size = uint16_t(executable.size());
+        uint32_t crc = crc32(executable);
+        
+        name = path + ".manifest";
+        outStream.open(name.c_str(), std::fstream::out | std::fstream::binary);
+        if (outStream.fail()) {
+            out << "Can't open '" << name << "'\n";
+            return false;
+        }
+        outStream.put(uint8_t(size));
+        outStream.put(uint8_t(size >> 8));
+        for (int i = 0; i < 4; ++i) {
+            outStream.put(uint8_t(crc >> (i * 8)));
+        }
+        outStream.put(uint8_t(written.size()));
+        for (uint8_t it : written) {
+            outStream.put(it);
+        }
+        outStream.close();
+        
+        char buf[9];
+        snprintf(buf, sizeof(buf), "%08x", crc);
+        out << "    Saved " << name << ", " << written.size() << " of " << (executable.size() + 63) / 64
+            << " segments changed, crc " << buf << "\n";
+    }
+
+    if (compiledFile) {
+        std::string cpp;
+        std::vector<uint8_t> uncompressed;
+        clvr::Compressor::decompress(executable, uncompressed);
+        clvr::CppGenerator generator(&uncompressed, &cpp, root);
+        if (!generator.generate()) {
+            const char* err = "unknown";
+            switch(generator.error()) {
+                case clvr::CppGenerator::Error::None: err = "internal error"; break;
+                case clvr::CppGenerator::Error::InvalidSignature: err = "invalid signature"; break;
+                case clvr::CppGenerator::Error::InvalidOp: err = "invalid op"; break;
+                case clvr::CppGenerator::Error::VerifyFailed: err = "executable failed verification"; break;
+            }
+            out << "C++ output failed: " << err << " at addr " << generator.errorAddr() << "\n\n";
+            return false;
+        }
+        
+        name = path + "Compiled.h";
+        outStream.open(name.c_str(), std::fstream::out);
+        if (outStream.fail()) {
+            out << "Can't open '" << name << "'\n";
+            return false;
+        }
+        outStream << cpp;
+        outStream.close();
+        out << "    Saved " << name << "\n";
+    }
+    return true;
 }
 
 int main(int argc, char * const argv[])
 {
-    std::cout << "Clover Compiler v0.2\n\n";
+    std::cout << "Clover Compiler v" << clvr::Compiler::Version << "\n\n";
     
     int c;
     bool execute = false;
     bool decompile = false;
     bool segmented = false;
     bool headerFile = false;
+    bool interpreted = false;
+    bool compiledFile = false;
+    bool profile = false;
+    bool optimize = true;
+    bool compress = false;
+    uint32_t maxExecutableSize = MaxExecutableSize;
+    uint32_t arenaSize = 0;
+    int32_t logLevel = clvr::Compiler::AllLogLevels;
+    uint32_t fleetSize = 0;
+    std::string fleetCommand;
+    uint32_t benchLoops = 0;
+    uint32_t randomSeed = uint32_t(std::chrono::system_clock::now().time_since_epoch().count());
+    uint32_t jobs = std::max(1u, std::thread::hardware_concurrency());
+    std::unique_ptr<CompileCache> cache;
+    std::string deployedDir;
     
-    while ((c = getopt(argc, argv, "dxsh")) != -1) {
+    while ((c = getopt(argc, argv, "dxishcpnzwa:l:f:e:b:r:j:k:u:")) != -1) {
         switch(c) {
             case 'd': decompile = true; break;
             case 'x': execute = true; break;
+            case 'i': interpreted = true; break;
             case 's': segmented = true; break;
             case 'h': headerFile = true; break;
+            case 'c': compiledFile = true; break;
+            case 'p': profile = execute = true; break;
+            case 'a': arenaSize = std::min(65535, std::max(0, atoi(optarg))); interpreted = true; break;
+            case 'l': logLevel = atoi(optarg); break;
+            case 'f': fleetSize = uint32_t(atoi(optarg)); break;
+            case 'e': fleetCommand = optarg; break;
+            case 'b': benchLoops = uint32_t(atoi(optarg)); break;
+            case 'r': randomSeed = uint32_t(strtoul(optarg, nullptr, 0)); break;
+            case 'n': optimize = false; break;
+            case 'z': compress = true; break;
+            case 'w': maxExecutableSize = MaxWideExecutableSize; break;
+            case 'j': jobs = std::max(1, atoi(optarg)); break;
+            case 'k': cache = std::make_unique<CompileCache>(optarg); break;
+            case 'u': deployedDir = optarg; segmented = true; break;
             default: break;
         }
     }
     
-    // If headerFile is true, segmented is ignored.
+#if !CLOVER_PROFILE
+    if (profile) {
+        std::cout << "Profiling needs a build with CLOVER_PROFILE=1, -p ignored\n\n";
+        profile = false;
+    }
+#endif
+
+    // If headerFile is true, segmented and delta are ignored.
     if (headerFile) {
         segmented = false;
+        deployedDir.clear();
     }
     
     if (optind >= argc) {
@@ -176,143 +698,54 @@ int main(int argc, char * const argv[])
         }
     }
     
-    std::vector<std::pair<int32_t, std::string>> annotations;
-
-    for (const auto& it : inputFiles) {
-        clvr::Compiler compiler;
-        std::fstream stream;
-        stream.open(it.c_str(), std::fstream::in);
-        if (stream.fail()) {
-            std::cout << "Can't open '" << it << "'\n";
-            return 0;
-        }
-        
-        std::cout << "Compiling '" << it << "'\n";
-        
-        std::vector<uint8_t> executable;
-        
-        clvr::Compiler::Language lang;
-        std::string suffix = it.substr(it.find_last_of('.'));
-        if (suffix == ".clvr") {
-            lang = clvr::Compiler::Language::Clover;
-        } else if (suffix == ".arly") {
-            lang = clvr::Compiler::Language::Arly;
-        } else {
-            std::cout << "*** suffix '" << suffix << "' not recognized\n";
-            return -1;
-        }
-        
-        randomSeed(uint32_t(clock()));
+    if (benchLoops) {
+        std::cout << "bench,file,command,mode,optimized,loops,ns_per_loop,instrs_per_loop,"
+                     "instrs_per_sec,peak_stack,stack_size,ok\n";
+    }
 
-        compiler.compile(&stream, lang, executable, MaxExecutableSize, { }, &annotations);
-        if (compiler.error() != clvr::Compiler::Error::None) {
-            showError(compiler.error(), compiler.expectedToken(), compiler.expectedString(), compiler.lineno(), compiler.charno());
-            std::cout << "          Executable size=" << std::to_string(executable.size()) << "\n";
-            return -1;
+    // Compile the files and write their outputs on a pool of threads
+    std::vector<Build> builds(inputFiles.size());
+    std::atomic<size_t> next { 0 };
+    auto builder = [&]
+    {
+        for (size_t i = next++; i < builds.size(); i = next++) {
+            std::ostringstream out;
+            builds[i].success = build(inputFiles[i], out, builds[i].executable, builds[i].annotations, cache.get(),
+                                      deployedDir, maxExecutableSize, optimize, compress, logLevel, segmented, headerFile, compiledFile);
+            builds[i].log = out.str();
         }
-
-        std::cout << "Compile succeeded. Executable size=" << std::to_string(executable.size()) << "\n";
-        
-        // Write executable
-        // Use the same name as the input file for the output
-        std::string path = it.substr(0, it.find_last_of('.'));
+    };
+    
+    jobs = std::min(jobs, uint32_t(inputFiles.size()));
+    std::vector<std::thread> threads;
+    for (uint32_t i = 1; i < jobs; ++i) {
+        threads.emplace_back(builder);
+    }
+    builder();
+    for (auto& it : threads) {
+        it.join();
+    }
+    
+    // Then show the results and run the executables in input order
+    bool failed = false;
+    
+    for (size_t i = 0; i < inputFiles.size(); ++i) {
+        const std::string& it = inputFiles[i];
+        std::vector<uint8_t>& executable = builds[i].executable;
+        const std::vector<std::pair<int32_t, std::string>>& annotations = builds[i].annotations;
         
-        // Delete any old copies
-        std::string name = path + ".h";
-        remove(name.c_str());
-
-        name = path + ".arlx";
-        remove(name.c_str());
-
-        for (int i = 0; ; ++i) {
-            char buf[3];
-            sprintf(buf, "%02u", i);
-            name = path + buf + ".arlx";
-            if (remove(name.c_str()) != 0) {
-                break;
-            }
+        std::cout << builds[i].log;
+        if (!builds[i].success) {
+            failed = true;
+            continue;
         }
         
-        std::cout << "\nEmitting executable to '" << path << "'\n";
-        std::fstream outStream;
-        
-        // If segmented break it up into 64 byte chunks, prefix each file with start addr byte
-        size_t sizeRemaining = executable.size();
-        
-        for (uint8_t i = 0; ; i++) {
-            if (segmented) {
-                char buf[3];
-                sprintf(buf, "%02u", i);
-                name = path + buf + ".arlx";
-            } else if (headerFile) {
-                name = path + ".h";
-            } else {
-                name = path + ".arlx";
-            }
-        
-            std::ios_base::openmode mode = std::fstream::out;
-            if (!headerFile) {
-                mode|= std::fstream::binary;
-            }
-            
-            outStream.open(name.c_str(), mode);
-            if (outStream.fail()) {
-                std::cout << "Can't open '" << name << "'\n";
-                return 0;
-            } else {
-                char* buf = reinterpret_cast<char*>(&(executable[i * 64]));
-                size_t sizeToWrite = sizeRemaining;
-                
-                if (segmented && sizeRemaining > 64) {
-                    sizeToWrite = 64;
-                }
-                
-                if (segmented) {
-                    // Write the 2 byte offset
-                    uint16_t addr = uint16_t(i) * 64;
-                    outStream.put(uint8_t(addr & 0xff));
-                    outStream.put(uint8_t(addr >> 8));
-                }
-                
-                if (!headerFile) {
-                    // Write the buffer
-                    outStream.write(buf, sizeToWrite);
-                    if (outStream.fail()) {
-                        std::cout << "Save failed\n";
-                        return 0;
-                    } else {
-                        sizeRemaining -= sizeToWrite;
-                        outStream.close();
-                        std::cout << "    Saved " << name << "\n";
-                        if (sizeRemaining == 0) {
-                            break;
-                        }
-                    }
-                } else {
-                    std::string name = path.substr(path.find_last_of('/') + 1);
-                    outStream << "static const uint8_t PROGMEM EEPROM_Upload_" << name << "[ ] = {\n";
-                    
-                    for (size_t i = 0; i < sizeRemaining; ++i) {
-                        char hexbuf[5];
-                        sprintf(hexbuf, "0x%02x", executable[i]);
-                        outStream << hexbuf << ", ";
-                        if (i % 8 == 7) {
-                            outStream << std::endl;
-                        }
-                    }
-
-                    outStream << "};\n";
-                    
-                    break;
-                }
-            }
-        }
-        std::cout << "Executables saved\n";
-
         // decompile if needed
         if (decompile) {
             std::string out;
-            clvr::Decompiler decompiler(&executable, &out, annotations);
+            std::vector<uint8_t> uncompressed;
+            clvr::Compressor::decompress(executable, uncompressed);
+            clvr::Decompiler decompiler(&uncompressed, &out, annotations);
             bool success = decompiler.decompile();
             std::cout << "\nDecompiled executable:\n" << out << "\nEnd decompilation\n\n";
             if (!success) {
@@ -330,12 +763,37 @@ int main(int argc, char * const argv[])
         
         // Execute if needed
         if (execute) {
-            Simulator sim;
+            std::vector<uint8_t> arena(arenaSize);
+            Simulator sim(nullptr, 0, arenaSize ? &arena[0] : nullptr, uint16_t(arenaSize));
             
             sim.setROM(executable);
+            sim.seedRandom(randomSeed);
+            sim.setExecMode(interpreted ? clvr::Interpreter::ExecMode::Interpreted : clvr::Interpreter::ExecMode::Predecoded);
+            
+            // If it doesn't load, init() gives the error
+            if (sim.load() && !sim.program().verified) {
+                const char* err = "unknown";
+                switch(sim.program().verifyError) {
+                    case clvr::Verifier::Error::None: err = "internal error"; break;
+                    case clvr::Verifier::Error::InvalidSignature: err = "invalid signature"; break;
+                    case clvr::Verifier::Error::InvalidOp: err = "invalid op"; break;
+                    case clvr::Verifier::Error::InvalidTarget: err = "invalid jump or call target"; break;
+                    case clvr::Verifier::Error::ExpectedSetFrame: err = "expected SetFrame as first function op"; break;
+                    case clvr::Verifier::Error::IdOutOfRange: err = "id out of range"; break;
+                    case clvr::Verifier::Error::InvalidNativeFunction: err = "invalid native function"; break;
+                    case clvr::Verifier::Error::StackMismatch: err = "stack depth differs between paths"; break;
+                    case clvr::Verifier::Error::StackUnderrun: err = "stack underrun"; break;
+                    case clvr::Verifier::Error::StackOverrun: err = "stack too small"; break;
+                    case clvr::Verifier::Error::OutOfMemory: err = "out of memory"; break;
+                }
+                std::cout << "Verify failed: " << err << " at addr " << sim.program().verifyErrorAddr << ", running checked\n";
+            }
             
             for (const Test& test : Tests) {
                 std::cout << "Running '" << test._cmd << "' command...\n";
+#if CLOVER_PROFILE
+                sim.resetProfile();
+#endif
             
                 bool success = sim.init(test._cmd, &test._buf[0], test._buf.size());
                 if (success && NumLoops > 0) {
@@ -354,24 +812,7 @@ int main(int argc, char * const argv[])
                 }
                 
                 if (!success) {
-                    const char* err = "unknown";
-                    switch(sim.error()) {
-                        case clvr::Interpreter::Error::None: err = "internal error"; break;
-                        case clvr::Interpreter::Error::CmdNotFound: err = "command not found"; break;
-                        case clvr::Interpreter::Error::UnexpectedOpInIf: err = "unexpected op in if (internal error)"; break;
-                        case clvr::Interpreter::Error::InvalidOp: err = "invalid opcode"; break;
-                        case clvr::Interpreter::Error::InvalidNativeFunction: err = "invalid native function"; break;
-                        case clvr::Interpreter::Error::OnlyMemAddressesAllowed: err = "only Mem addresses allowed"; break;
-                        case clvr::Interpreter::Error::StackOverrun: err = "can't call, stack full"; break;
-                        case clvr::Interpreter::Error::StackUnderrun: err = "stack underrun"; break;
-                        case clvr::Interpreter::Error::StackOutOfRange: err = "stack access out of range"; break;
-                        case clvr::Interpreter::Error::AddressOutOfRange: err = "address out of range"; break;
-                        case clvr::Interpreter::Error::InvalidModuleOp: err = "invalid operation in module"; break;
-                        case clvr::Interpreter::Error::ExpectedSetFrame: err = "expected SetFrame as first function op"; break;
-                        case clvr::Interpreter::Error::NotEnoughArgs: err = "not enough args on stack"; break;
-                        case clvr::Interpreter::Error::WrongNumberOfArgs: err = "wrong number of args"; break;
-                    }
-                    std::cout << "Interpreter failed: " << err;
+                    std::cout << "Interpreter failed: " << interpreterError(sim.error());
                     
                     int16_t errorAddr = sim.errorAddr();
                     if (errorAddr >= 0) {
@@ -380,9 +821,94 @@ int main(int argc, char * const argv[])
                     
                     std::cout << "\n\n";
                 }
+#if CLOVER_PROFILE
+                if (profile) {
+                    showProfile(sim, annotations);
+                }
+#endif
+            }
+        }
+        
+        if (benchLoops) {
+            Bench bench(executable);
+            std::vector<Bench::Result> results = bench.run(benchLoops);
+            std::string file = it.substr(it.find_last_of('/') + 1);
+            
+            for (const auto& result : results) {
+                double instrsPerSec = (result.nsPerLoop > 0) ? (result.instrsPerLoop * 1e9 / result.nsPerLoop) : 0;
+                std::cout << "bench," << file << "," << result.cmd << ","
+                          << ((result.mode == clvr::Interpreter::ExecMode::Interpreted) ? "interpreted" : "predecoded") << ","
+                          << (optimize ? 1 : 0) << "," << result.loops << ","
+                          << std::fixed << std::setprecision(1) << result.nsPerLoop << "," << result.instrsPerLoop << ","
+                          << std::setprecision(0) << instrsPerSec << ","
+                          << result.peakStack << "," << result.stackSize << "," << (result.failed ? 0 : 1) << "\n";
+            }
+            std::cout << "\n";
+        }
+        
+        if (fleetSize) {
+            std::string cmd = fleetCommand;
+            uint8_t numParams;
+            if (!findCommand(executable, cmd, numParams)) {
+                std::cout << "No command '" << cmd << "' to run on the instances\n\n";
+                failed = true;
+                continue;
+            }
+            
+            std::vector<uint8_t> params(numParams, 0);
+            for (const Test& test : Tests) {
+                if (cmd == test._cmd && test._buf.size() == numParams) {
+                    params = test._buf;
+                }
+            }
+            
+            Fleet fleet(executable);
+            for (uint32_t i = 0; i < fleetSize; ++i) {
+                if (!params.empty()) {
+                    params[0] = uint8_t(i);
+                }
+                
+                // Spread the seeds so neighboring instances don't start
+                // out with similar sequences
+                fleet.addInstance(params, randomSeed + i * 0x9e3779b9);
+            }
+            
+            std::cout << "Running '" << cmd << "' on " << fleetSize << " instances with "
+                      << fleet.threads() << " threads...\n";
+            
+            auto start = std::chrono::steady_clock::now();
+            bool success = fleet.init(cmd.c_str());
+            fleet.run(FleetTime);
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            
+            uint64_t loops = 0;
+            uint32_t numFailed = 0;
+            for (uint32_t i = 0; i < fleet.size(); ++i) {
+                loops += fleet.loops(i);
+                if (fleet.failed(i)) {
+                    numFailed++;
+                }
+            }
+            
+            std::cout << "    " << loops << " loops in " << FleetTime << "ms of simulated time took "
+                      << elapsed.count() << "ms\n";
+            if (!success || numFailed) {
+                failed = true;
+                std::cout << "    " << numFailed << " instances failed\n";
+                for (uint32_t i = 0; i < fleet.size(); ++i) {
+                    if (fleet.failed(i)) {
+                        const clvr::Interpreter& interp = fleet.interpreter(i);
+                        std::cout << "        " << i << ": " << interpreterError(interp.error());
+                        if (interp.errorAddr() >= 0) {
+                            std::cout << " at addr " << interp.errorAddr();
+                        }
+                        std::cout << "\n";
+                    }
+                }
             }
+            std::cout << "\n";
         }
     }
 
-    return 1;
+    return failed ? -1 : 1;
 }